@@ -0,0 +1,743 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Benchmarks the vector, ray, and sphere routines in double and single  *
+ *      precision, the random number generators and samplers, camera rays,    *
+ *      PPM output, and whole frames. Inputs come from a fixed seed, so runs  *
+ *      of different builds are comparable. Options:                          *
+ *          --threads N      Threads for the frame benchmarks.                *
+ *          --repetitions N  Timed batches per benchmark, default 7.          *
+ *          --warmup N       Untimed runs per benchmark, default 2.           *
+ *          --filter NAME    Only run benchmarks whose name contains NAME.    *
+ *          --json PATH      Also write the results to PATH as JSON.          *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  And the equivalent of stdio.h.                                            */
+#include <cstdio>
+
+/*  strcmp and strstr, for the command line.                                  */
+#include <cstring>
+
+/*  std::string, used for the JSON context.                                   */
+#include <string>
+
+/*  std::vector holds the inputs and the results.                             */
+#include <vector>
+
+#include "psow_color.hpp"
+#include "psow_vec3.hpp"
+#include "psow_vec3_wide.hpp"
+#include "psow_normalize.hpp"
+#include "psow_ray.hpp"
+#include "psow_ray_packet.hpp"
+#include "psow_sphere.hpp"
+#include "psow_sphere_list.hpp"
+#include "psow_bvh.hpp"
+#include "psow_random.hpp"
+#include "psow_camera.hpp"
+#include "psow_static_scene.hpp"
+#include "psow_environment.hpp"
+#include "psow_aligned_allocator.hpp"
+#include "psow_image.hpp"
+#include "psow_renderer.hpp"
+#include "psow_simd.hpp"
+#include "psow_benchmark.hpp"
+
+/*  Seed for every random input.                                              */
+static const unsigned long long benchmark_seed = 20210510ULL;
+
+/*  Number of vectors and rays in the micro benchmarks. 64k of each fits in   *
+ *  the L2 cache of most machines, so the loops measure arithmetic, not DRAM. */
+static const std::size_t batch_size = 1UL << 16;
+
+/*  Size of the frames rendered.                                              */
+static const unsigned int frame_width = 1920U;
+static const unsigned int frame_height = 1080U;
+
+/*  Things that vary from run to run of the program, set from the arguments.  */
+struct settings {
+    psow::benchmark_options options;
+    unsigned int threads;
+    const char *filter;
+    const char *json_path;
+};
+
+/*  Results so far, and the settings to run the rest with.                    */
+struct suite {
+    settings config;
+    std::vector<psow::benchmark_result> results;
+
+    /*  Runs the benchmark if its name passes the filter.                     */
+    template <class body_type>
+    void run(const char *name, const char *unit, double items,
+             const body_type &body)
+    {
+        if (config.filter && !std::strstr(name, config.filter))
+            return;
+
+        results.push_back(
+            psow::run_benchmark(name, unit, items, body, config.options)
+        );
+
+        std::fprintf(stderr, "%-28s %12.3f ns/%s\n", name,
+                     results.back().ns_per_item(), unit);
+    }
+};
+
+/*  Random vector with components in [-1, 1).                                 */
+static psow::vec3 random_vec3(psow::benchmark_rng &rng)
+{
+    const double x = rng.uniform(-1.0, 1.0);
+    const double y = rng.uniform(-1.0, 1.0);
+    const double z = rng.uniform(-1.0, 1.0);
+    return psow::vec3(x, y, z);
+}
+
+/*  The scene of example_ray_and_sphere, a red ball against the sky, fixed at *
+ *  compile time so the benchmarks build none of it when they start.          */
+static constexpr psow::sphere ball(0.5, psow::vec3(0.0, 0.0, -1.0));
+static constexpr psow::color ball_red(255U, 0U, 0U);
+static constexpr psow::color sky_blue(128U, 180U, 255U);
+static constexpr psow::color sky_white(255U, 255U, 255U);
+
+/*  The sky gradient of example_ray_and_sphere, given the height of the unit  *
+ *  direction, which is what that example bakes into a sky_lut.              */
+static psow::color sky_height(double height)
+{
+    const double t = 0.5 * (height + 1.0);
+    return (sky_white*(1.0 - t) + sky_blue*t)*2.0;
+}
+
+/*  The gradient evaluated directly, normalizing the direction.               */
+static psow::color sky_gradient(const psow::ray &r)
+{
+    return sky_height((r.v).unit().y);
+}
+
+/*  Ray setup of example_ray_and_sphere, rebuilding each direction from the   *
+ *  viewport vectors. The baseline for the psow::camera benchmarks.           */
+struct viewport_camera {
+    psow::vec3 origin, horizontal, vertical, lower_left_corner;
+    double width_factor, height_factor;
+    unsigned int height;
+
+    viewport_camera(unsigned int w, unsigned int h)
+    {
+        const double aspect_ratio = static_cast<double>(w) / h;
+        const double viewport_height = 2.0;
+
+        origin = psow::vec3(0.0, 0.0, 0.0);
+        horizontal = psow::vec3(viewport_height * aspect_ratio, 0.0, 0.0);
+        vertical = psow::vec3(0.0, viewport_height, 0.0);
+        lower_left_corner = origin - 0.5*(horizontal + vertical) -
+                            psow::vec3(0.0, 0.0, 1.0);
+        width_factor = 1.0 / static_cast<double>(w - 1U);
+        height_factor = 1.0 / static_cast<double>(h - 1U);
+        height = h;
+    }
+
+    /*  Ray through pixel (x, y), row zero being the top row.                 */
+    psow::ray get_ray(unsigned int x, unsigned int y) const
+    {
+        const double u = x * width_factor;
+        const double v = (height - y) * height_factor;
+        const psow::vec3 direction = horizontal*u + vertical*v +
+                                     lower_left_corner - origin;
+        return psow::ray(origin, direction);
+    }
+};
+
+/*  vec3 arithmetic over arrays, one result per pair of inputs, for vectors   *
+ *  of real. The names of the benchmarks start with prefix.                   */
+template <class real>
+static void benchmark_vec3(suite &s, const std::string &prefix)
+{
+    psow::benchmark_rng rng(benchmark_seed);
+    std::vector<psow::basic_vec3<real> > a(batch_size), b(batch_size);
+    std::vector<psow::basic_vec3<real> > out(batch_size);
+    const double n = static_cast<double>(batch_size);
+    std::size_t k;
+
+    for (k = 0; k < batch_size; ++k)
+    {
+        a[k] = psow::basic_vec3<real>(random_vec3(rng));
+        b[k] = psow::basic_vec3<real>(random_vec3(rng));
+    }
+
+    s.run((prefix + "_add").c_str(), "ops", n, [&]() {
+        std::size_t i;
+        for (i = 0; i < batch_size; ++i)
+            out[i] = a[i] + b[i];
+        psow::do_not_optimize(out[0]);
+    });
+
+    s.run((prefix + "_scale").c_str(), "ops", n, [&]() {
+        std::size_t i;
+        for (i = 0; i < batch_size; ++i)
+            out[i] = a[i] * 1.5;
+        psow::do_not_optimize(out[0]);
+    });
+
+    s.run((prefix + "_dot").c_str(), "ops", n, [&]() {
+        std::size_t i;
+        real sum = 0;
+        for (i = 0; i < batch_size; ++i)
+            sum += a[i].dot(b[i]);
+        psow::do_not_optimize(sum);
+    });
+
+    s.run((prefix + "_cross").c_str(), "ops", n, [&]() {
+        std::size_t i;
+        for (i = 0; i < batch_size; ++i)
+            out[i] = a[i].cross(b[i]);
+        psow::do_not_optimize(out[0]);
+    });
+
+    s.run((prefix + "_unit").c_str(), "ops", n, [&]() {
+        std::size_t i;
+        for (i = 0; i < batch_size; ++i)
+            out[i] = a[i].unit();
+        psow::do_not_optimize(out[0]);
+    });
+
+    s.run((prefix + "_unit_fast").c_str(), "ops", n, [&]() {
+        std::size_t i;
+        for (i = 0; i < batch_size; ++i)
+            out[i] = psow::unit<psow::fast_normalize>(a[i]);
+        psow::do_not_optimize(out[0]);
+    });
+}
+/*  End of benchmark_vec3.                                                    */
+
+/*  The same operations with N vectors at a time, stored as component arrays. */
+template <class real, unsigned int N>
+static void benchmark_vec3_wide(suite &s, const std::string &prefix)
+{
+    typedef psow::basic_vec3x<real, N> vec_type;
+    psow::benchmark_rng rng(benchmark_seed);
+    std::vector<real> a(3 * batch_size), b(3 * batch_size);
+    std::vector<real> out(3 * batch_size);
+    const double n = static_cast<double>(batch_size);
+    std::size_t k;
+
+    for (k = 0; k < batch_size; ++k)
+    {
+        const psow::basic_vec3<real> p(random_vec3(rng)), q(random_vec3(rng));
+        a[k] = p.x;
+        a[k + batch_size] = p.y;
+        a[k + 2 * batch_size] = p.z;
+        b[k] = q.x;
+        b[k + batch_size] = q.y;
+        b[k + 2 * batch_size] = q.z;
+    }
+
+    const real *ax = &a[0], *ay = ax + batch_size, *az = ay + batch_size;
+    const real *bx = &b[0], *by = bx + batch_size, *bz = by + batch_size;
+    real *ox = &out[0], *oy = ox + batch_size, *oz = oy + batch_size;
+
+    s.run((prefix + "_add").c_str(), "ops", n, [&]() {
+        std::size_t i;
+        for (i = 0; i < batch_size; i += N)
+        {
+            const vec_type r = vec_type::load(ax + i, ay + i, az + i) +
+                               vec_type::load(bx + i, by + i, bz + i);
+            r.x.store(ox + i);
+            r.y.store(oy + i);
+            r.z.store(oz + i);
+        }
+        psow::do_not_optimize(out[0]);
+    });
+
+    s.run((prefix + "_dot").c_str(), "ops", n, [&]() {
+        std::size_t i;
+        psow::wide<real, N> sum(real(0));
+        for (i = 0; i < batch_size; i += N)
+            sum = sum + vec_type::load(ax + i, ay + i, az + i).dot(
+                vec_type::load(bx + i, by + i, bz + i)
+            );
+        const real total = psow::reduce_add(sum);
+        psow::do_not_optimize(total);
+    });
+
+    s.run((prefix + "_unit").c_str(), "ops", n, [&]() {
+        std::size_t i;
+        for (i = 0; i < batch_size; i += N)
+        {
+            const vec_type r = vec_type::load(ax + i, ay + i, az + i).unit();
+            r.x.store(ox + i);
+            r.y.store(oy + i);
+            r.z.store(oz + i);
+        }
+        psow::do_not_optimize(out[0]);
+    });
+
+    s.run((prefix + "_unit_fast").c_str(), "ops", n, [&]() {
+        std::size_t i;
+        for (i = 0; i < batch_size; i += N)
+        {
+            const vec_type r = psow::unit<psow::fast_normalize>(
+                vec_type::load(ax + i, ay + i, az + i)
+            );
+            r.x.store(ox + i);
+            r.y.store(oy + i);
+            r.z.store(oz + i);
+        }
+        psow::do_not_optimize(out[0]);
+    });
+}
+/*  End of benchmark_vec3_wide.                                               */
+
+/*  ray::point, sphere::intersects_ray and hit in double and single precision,*
+ *  and the packet kernel.                                                    */
+static void benchmark_ray_and_sphere(suite &s)
+{
+    psow::benchmark_rng rng(benchmark_seed + 1ULL);
+    std::vector<psow::ray> rays(batch_size);
+    std::vector<psow::rayf> rays_f(batch_size);
+    std::vector<double> t(batch_size);
+    std::vector<psow::vec3> out(batch_size);
+    const double n = static_cast<double>(batch_size);
+    const psow::spheref ball_f(ball);
+    std::vector<psow::ray_packet<8>,
+                psow::aligned_allocator<psow::ray_packet<8> > >
+        packets(batch_size / 8);
+    std::vector<double> hit_t(8);
+    std::size_t k;
+
+    /*  Rays from the origin in random forward directions, about half of them *
+     *  hit the ball.                                                         */
+    for (k = 0; k < batch_size; ++k)
+    {
+        const double x = rng.uniform(-0.6, 0.6);
+        const double y = rng.uniform(-0.6, 0.6);
+        rays[k] = psow::ray(psow::vec3(0.0, 0.0, 0.0), psow::vec3(x, y, -1.0));
+        rays_f[k] = psow::rayf(rays[k]);
+        t[k] = rng.uniform(0.0, 4.0);
+        packets[k / 8].set(static_cast<unsigned int>(k % 8), rays[k]);
+    }
+
+    s.run("ray_point", "ops", n, [&]() {
+        std::size_t i;
+        for (i = 0; i < batch_size; ++i)
+            out[i] = rays[i].point(t[i]);
+        psow::do_not_optimize(out[0]);
+    });
+
+    s.run("sphere_intersects_ray", "rays", n, [&]() {
+        std::size_t i;
+        unsigned long hits = 0UL;
+        for (i = 0; i < batch_size; ++i)
+            hits += ball.intersects_ray(rays[i]);
+        psow::do_not_optimize(hits);
+    });
+
+    s.run("spheref_intersects_ray", "rays", n, [&]() {
+        std::size_t i;
+        unsigned long hits = 0UL;
+        for (i = 0; i < batch_size; ++i)
+            hits += ball_f.intersects_ray(rays_f[i]);
+        psow::do_not_optimize(hits);
+    });
+
+    s.run("sphere_hit", "rays", n, [&]() {
+        std::size_t i;
+        double sum = 0.0;
+        psow::hit_record rec;
+        for (i = 0; i < batch_size; ++i)
+            if (ball.hit(rays[i], 0.0, 1.0E30, rec))
+                sum += rec.normal.z;
+        psow::do_not_optimize(sum);
+    });
+
+    s.run("spheref_hit", "rays", n, [&]() {
+        std::size_t i;
+        double sum = 0.0;
+        psow::hit_record rec;
+        for (i = 0; i < batch_size; ++i)
+            if (ball_f.hit(rays_f[i], 0.0F, 1.0E30F, rec))
+                sum += rec.normal.z;
+        psow::do_not_optimize(sum);
+    });
+
+    s.run("sphere_intersects_packet8", "rays", n, [&]() {
+        std::size_t i;
+        unsigned int mask = 0U;
+        for (i = 0; i < packets.size(); ++i)
+            mask ^= ball.intersects_packet(packets[i], &hit_t[0]);
+        psow::do_not_optimize(mask);
+    });
+
+    s.run("sphere_packet_wide8", "rays", n, [&]() {
+        std::size_t i;
+        unsigned int mask = 0U;
+        for (i = 0; i < packets.size(); ++i)
+        {
+            const psow::ray_packet<8> &p = packets[i];
+            const psow::ray_arrays arrays = {
+                p.px, p.py, p.pz, p.vx, p.vy, p.vz
+            };
+            mask ^= psow::sphere_packet_wide<8U>(ball.center, ball.radius,
+                                                 arrays, 8U, &hit_t[0]);
+        }
+        psow::do_not_optimize(mask);
+    });
+}
+/*  End of benchmark_ray_and_sphere.                                          */
+
+/*  The generators one number at a time and in batches, and the unit sphere   *
+ *  sampled one point at a time with libm and in batches with polynomials.    */
+static void benchmark_random(suite &s)
+{
+    std::vector<double> u(batch_size);
+    std::vector<psow::vec3> out(batch_size);
+    const psow::vec3 up(0.0, 0.0, 1.0);
+    const double n = static_cast<double>(batch_size);
+
+    s.run("pcg32_uniform", "numbers", n, [&]() {
+        psow::pcg32 rng(benchmark_seed);
+        rng.fill_uniform(&u[0], batch_size);
+        psow::do_not_optimize(u[0]);
+    });
+
+    s.run("philox_uniform", "numbers", n, [&]() {
+        psow::philox_rng rng(benchmark_seed, 0ULL, 0U);
+        std::size_t i;
+        for (i = 0; i < batch_size; ++i)
+            u[i] = rng.uniform();
+        psow::do_not_optimize(u[0]);
+    });
+
+    s.run("philox_fill_uniform", "numbers", n, [&]() {
+        psow::philox_rng rng(benchmark_seed, 0ULL, 0U);
+        rng.fill_uniform(&u[0], batch_size);
+        psow::do_not_optimize(u[0]);
+    });
+
+    s.run("random_unit_vector", "vectors", n, [&]() {
+        psow::philox_rng rng(benchmark_seed, 0ULL, 0U);
+        std::size_t i;
+        for (i = 0; i < batch_size; ++i)
+            out[i] = psow::random_unit_vector(rng);
+        psow::do_not_optimize(out[0]);
+    });
+
+    s.run("unit_vector_batch", "vectors", n, [&]() {
+        psow::philox_rng rng(benchmark_seed, 0ULL, 0U);
+        psow::unit_vector_batch(rng, &out[0], batch_size);
+        psow::do_not_optimize(out[0]);
+    });
+
+    s.run("hemisphere_batch", "vectors", n, [&]() {
+        psow::philox_rng rng(benchmark_seed, 0ULL, 0U);
+        psow::hemisphere_batch(rng, up, &out[0], batch_size);
+        psow::do_not_optimize(out[0]);
+    });
+}
+/*  End of benchmark_random.                                                  */
+
+/*  Primary rays for a full frame: the viewport sum per pixel, psow::camera   *
+ *  one ray at a time, and psow::camera a tile at a time in packets of 8, the *
+ *  way a renderer would use it. Every component of every ray is summed, the  *
+ *  packets lane by lane as a packet kernel would read them.                  */
+static void benchmark_camera(suite &s)
+{
+    const viewport_camera old_cam(frame_width, frame_height);
+    const psow::camera cam(frame_width, frame_height);
+    const double pixels = static_cast<double>(frame_width) * frame_height;
+    const unsigned int size = psow::default_tile_size;
+    psow::tile whole;
+    whole.x0 = 0U;
+    whole.y0 = 0U;
+    whole.x1 = size;
+    whole.y1 = size;
+
+    std::vector<psow::ray_packet<8>,
+                psow::aligned_allocator<psow::ray_packet<8> > >
+        packets(psow::camera::tile_packet_count<8>(whole));
+
+    s.run("camera_viewport_ray", "rays", pixels, [&]() {
+        unsigned int x, y;
+        double sum = 0.0;
+        for (y = 0U; y < frame_height; ++y)
+        {
+            for (x = 0U; x < frame_width; ++x)
+            {
+                const psow::ray r = old_cam.get_ray(x, y);
+                sum += r.v.x + r.v.y + r.v.z;
+            }
+        }
+        psow::do_not_optimize(sum);
+    });
+
+    s.run("camera_get_ray", "rays", pixels, [&]() {
+        unsigned int x, y;
+        double sum = 0.0;
+        for (y = 0U; y < frame_height; ++y)
+        {
+            for (x = 0U; x < frame_width; ++x)
+            {
+                const psow::ray r = cam.get_ray(x, y, 0.5, 0.5);
+                sum += r.v.x + r.v.y + r.v.z;
+            }
+        }
+        psow::do_not_optimize(sum);
+    });
+
+    s.run("camera_tile_packets8", "rays", pixels, [&]() {
+        unsigned int x, y, k;
+        std::size_t n, count;
+        double lanes[8] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+        double sum = 0.0;
+        psow::tile t;
+        for (y = 0U; y < frame_height; y += size)
+        {
+            for (x = 0U; x < frame_width; x += size)
+            {
+                t.x0 = x;
+                t.y0 = y;
+                t.x1 = (frame_width - x < size ? frame_width : x + size);
+                t.y1 = (frame_height - y < size ? frame_height : y + size);
+                count = cam.get_tile_packets(t, 0.5, 0.5, &packets[0]);
+
+                for (n = 0; n < count; ++n)
+                    for (k = 0U; k < 8U; ++k)
+                        lanes[k] += packets[n].vx[k] + packets[n].vy[k] +
+                                    packets[n].vz[k];
+            }
+        }
+        for (k = 0U; k < 8U; ++k)
+            sum += lanes[k];
+        psow::do_not_optimize(sum);
+    });
+}
+/*  End of benchmark_camera.                                                  */
+
+/*  The background of random directions: the gradient evaluated directly,     *
+ *  and looked up in the sky_lut and the cube map it is baked into.           */
+static void benchmark_background(suite &s)
+{
+    psow::benchmark_rng rng(benchmark_seed + 3ULL);
+    std::vector<psow::vec3> directions(batch_size);
+    const double n = static_cast<double>(batch_size);
+    const psow::vec3 origin(0.0, 0.0, 0.0);
+    psow::sky_lut<psow::color> lut;
+    psow::cube_map<psow::rgb> environment;
+    std::size_t k;
+
+    for (k = 0; k < batch_size; ++k)
+        directions[k] = random_vec3(rng);
+
+    lut.bake(sky_height);
+    environment.bake([](const psow::vec3 &d) -> psow::rgb {
+        return psow::book_sky().at(0.5 * (d.y + 1.0));
+    });
+
+    s.run("background_gradient", "rays", n, [&]() {
+        std::size_t i;
+        unsigned long sum = 0UL;
+        for (i = 0; i < batch_size; ++i)
+            sum += sky_gradient(psow::ray(origin, directions[i])).green;
+        psow::do_not_optimize(sum);
+    });
+
+    s.run("background_sky_lut", "rays", n, [&]() {
+        std::size_t i;
+        unsigned long sum = 0UL;
+        for (i = 0; i < batch_size; ++i)
+            sum += lut.lookup(directions[i]).green;
+        psow::do_not_optimize(sum);
+    });
+
+    s.run("background_cube_map", "rays", n, [&]() {
+        std::size_t i;
+        double sum = 0.0;
+        for (i = 0; i < batch_size; ++i)
+            sum += environment.lookup(directions[i]).g;
+        psow::do_not_optimize(sum);
+    });
+}
+/*  End of benchmark_background.                                              */
+
+/*  image::write of a full frame to a temporary file.                         */
+static void benchmark_ppm(suite &s)
+{
+    psow::image img(frame_width, frame_height);
+    const double pixels = static_cast<double>(frame_width) * frame_height;
+    unsigned int x, y;
+    FILE *fp = std::tmpfile();
+
+    if (!fp)
+    {
+        std::fputs("tmpfile failed, skipping ppm_write.\n", stderr);
+        return;
+    }
+
+    for (y = 0U; y < frame_height; ++y)
+        for (x = 0U; x < frame_width; ++x)
+            img.set(x, y, psow::color(x & 255U, y & 255U, (x ^ y) & 255U));
+
+    s.run("ppm_write", "pixels", pixels, [&]() {
+        std::rewind(fp);
+        img.write(fp);
+        std::fflush(fp);
+    });
+
+    std::fclose(fp);
+}
+/*  End of benchmark_ppm.                                                     */
+
+/*  Whole frames: the red ball of example_ray_and_sphere, and a BVH over a    *
+ *  random field of spheres. One ray per pixel, so rays and pixels agree.     */
+static void benchmark_frames(suite &s)
+{
+    psow::thread_pool pool(s.config.threads);
+    psow::image img(frame_width, frame_height);
+    const psow::camera cam(frame_width, frame_height);
+    const double pixels = static_cast<double>(frame_width) * frame_height;
+    psow::benchmark_rng rng(benchmark_seed + 2ULL);
+    psow::sphere_list field;
+    psow::bvh tree;
+    unsigned int k;
+
+    const auto ball_shader = [&](unsigned int x, unsigned int y) {
+        const psow::ray r = cam.get_ray(x, y, 0.5, 0.5);
+        return ball.intersects_ray(r) ? ball_red : sky_gradient(r);
+    };
+
+    s.run("frame_ray_and_sphere", "rays", pixels, [&]() {
+        psow::render(img, ball_shader, pool);
+        psow::do_not_optimize(img.pixels[0]);
+    });
+
+    for (k = 0U; k < 10000U; ++k)
+    {
+        const double x = rng.uniform(-8.0, 8.0);
+        const double y = rng.uniform(-4.5, 4.5);
+        const double z = rng.uniform(-20.0, -4.0);
+        const double radius = rng.uniform(0.05, 0.3);
+        field.add(psow::sphere(radius, psow::vec3(x, y, z)));
+    }
+
+    tree.build(field, psow::bvh_options(), pool);
+
+    const auto field_shader = [&](unsigned int x, unsigned int y) {
+        const psow::ray r = cam.get_ray(x, y, 0.5, 0.5);
+        double t;
+        std::size_t index;
+
+        if (tree.nearest_hit(r, 0.0, 1.0E30, t, index))
+        {
+            const unsigned char shade =
+                static_cast<unsigned char>(64U + (index * 37U) % 192U);
+            return psow::color(shade, shade / 2U, 0U);
+        }
+
+        return sky_gradient(r);
+    };
+
+    s.run("frame_bvh_10k", "rays", pixels, [&]() {
+        psow::render(img, field_shader, pool);
+        psow::do_not_optimize(img.pixels[0]);
+    });
+}
+/*  End of benchmark_frames.                                                  */
+
+/*  Parses the arguments, runs the benchmarks, and reports the results.       */
+int main(int argc, char **argv)
+{
+    suite s;
+    int n;
+    char buffer[128];
+    std::vector<std::string> context;
+
+    s.config.threads = psow::thread_count_from_args(argc, argv);
+    s.config.filter = NULL;
+    s.config.json_path = NULL;
+
+    for (n = 1; n + 1 < argc; ++n)
+    {
+        if (std::strcmp(argv[n], "--filter") == 0)
+            s.config.filter = argv[n + 1];
+
+        else if (std::strcmp(argv[n], "--json") == 0)
+            s.config.json_path = argv[n + 1];
+    }
+
+    if (s.config.threads == 0U ||
+        !psow::unsigned_from_args(argc, argv, "--repetitions",
+                                  s.config.options.repetitions) ||
+        !psow::unsigned_from_args(argc, argv, "--warmup",
+                                  s.config.options.warmup_runs))
+    {
+        std::puts("Usage: benchmark [--threads N] [--repetitions N] "
+                  "[--warmup N]\n                 [--filter NAME] "
+                  "[--json PATH]");
+        return -1;
+    }
+
+    benchmark_vec3<double>(s, "vec3");
+    benchmark_vec3<float>(s, "vec3f");
+    benchmark_vec3_wide<double, 8U>(s, "vec3x8");
+    benchmark_vec3_wide<float, 8U>(s, "vec3fx8");
+    benchmark_ray_and_sphere(s);
+    benchmark_random(s);
+    benchmark_camera(s);
+    benchmark_background(s);
+    benchmark_ppm(s);
+    benchmark_frames(s);
+
+    psow::print_benchmarks(stdout, s.results);
+
+    if (!s.config.json_path)
+        return 0;
+
+    /*  Enough about the build and the machine to tell two runs apart.        */
+#if defined(__VERSION__)
+    context.push_back(std::string("\"compiler\": \"") + __VERSION__ + "\"");
+#endif
+    context.push_back(std::string("\"simd\": \"") +
+                      psow::simd_level_name(psow::detect_simd_level()) + "\"");
+    std::snprintf(buffer, sizeof(buffer), "\"threads\": %u",
+                  s.config.threads);
+    context.push_back(buffer);
+    std::snprintf(buffer, sizeof(buffer), "\"seed\": %llu", benchmark_seed);
+    context.push_back(buffer);
+    std::snprintf(buffer, sizeof(buffer), "\"warmup_runs\": %u",
+                  s.config.options.warmup_runs);
+    context.push_back(buffer);
+
+    FILE *fp = std::fopen(s.config.json_path, "w");
+
+    if (!fp)
+    {
+        std::puts("fopen failed and returned NULL. Aborting.");
+        return -1;
+    }
+
+    if (!psow::write_benchmark_json(fp, s.results, context))
+    {
+        std::puts("Failed to write the JSON file. Aborting.");
+        std::fclose(fp);
+        return -1;
+    }
+
+    std::fclose(fp);
+    return 0;
+}
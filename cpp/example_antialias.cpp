@@ -0,0 +1,204 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Renders the red ball from example_ray_and_sphere with a grid of       *
+ *      samples per pixel, accumulated in floating point and tonemapped once, *
+ *      or with adaptive sampling.                                            *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  sqrt, used for the RMS difference between two images.                     */
+#include <cmath>
+
+/*  And the equivalent of stdio.h.                                            */
+#include <cstdio>
+
+#include "psow_vec3.hpp"
+#include "psow_ray.hpp"
+#include "psow_sphere.hpp"
+#include "psow_rgb.hpp"
+#include "psow_image.hpp"
+#include "psow_renderer.hpp"
+#include "psow_accumulator.hpp"
+#include "psow_progressive.hpp"
+#include "psow_adaptive.hpp"
+
+/*  Linear version of the sky gradient, sky blue at the top, white below.     */
+static psow::rgb sky_gradient(const psow::ray &r)
+{
+    const psow::vec3 v = (r.v).unit();
+    const double t = 0.5 * (v.y + 1.0);
+    const psow::rgb sky_blue = psow::rgb(0.5, 0.7, 1.0);
+    const psow::rgb white = psow::rgb(1.0, 1.0, 1.0);
+    return white*(1.0 - t) + sky_blue*t;
+}
+/*  End of sky_gradient.                                                      */
+
+/*  Takes samples_per_side^2 samples per pixel on a regular grid. With        *
+ *  "--adaptive" the samples go where the noise is instead, up to 64 a pixel, *
+ *  and "--compare" also renders 64 samples in every pixel and reports how    *
+ *  many rays the adaptive render saved and how far its image is from it.     */
+int main(int argc, char **argv)
+{
+    const unsigned int samples_per_side = 4U;
+    const double aspect_ratio = 16.0 / 9.0;
+    const unsigned int image_width  = 1920U;
+    const unsigned int image_height = static_cast<unsigned int>(
+        static_cast<double>(image_width) / aspect_ratio
+    );
+
+    const double viewport_height = 2.0;
+    const double viewport_width  = viewport_height * aspect_ratio;
+    const double width_factor  = 1.0 / static_cast<double>(image_width - 1U);
+    const double height_factor = 1.0 / static_cast<double>(image_height - 1U);
+    const psow::rgb red = psow::rgb(1.0, 0.0, 0.0);
+    const psow::sphere s = psow::sphere(0.5, psow::vec3(0, 0, -1));
+    const psow::vec3 origin = psow::vec3(0.0, 0.0, 0.0);
+    const psow::vec3 horizontal = psow::vec3(viewport_width, 0.0, 0.0);
+    const psow::vec3 vertical = psow::vec3(0.0, viewport_height, 0.0);
+    const psow::vec3 focal_point = psow::vec3(0.0, 0.0, 1.0);
+
+    const psow::vec3 lower_left_corner =
+        origin - 0.5*(horizontal + vertical) - focal_point;
+
+    const unsigned int max_samples = 64U;
+    const unsigned int threads = psow::thread_count_from_args(argc, argv);
+    unsigned int sx, sy;
+
+    if (threads == 0U)
+    {
+        std::puts("Usage: example_antialias [--threads N] "
+                  "[--adaptive [--compare]]");
+        return -1;
+    }
+
+    psow::thread_pool pool(threads);
+    psow::accumulator acc(image_width, image_height);
+    psow::image img(image_width, image_height);
+
+    /*  Radiance seen through the point (dx, dy) of pixel (n, y), measured    *
+     *  from the top left corner of the pixel.                                */
+    const auto trace = [&](unsigned int n, unsigned int y,
+                           double dx, double dy) -> psow::rgb
+    {
+        const double u = (n + dx) * width_factor;
+        const double v = (image_height - y - dy) * height_factor;
+        const psow::vec3 direction = horizontal*u + vertical*v +
+                                     lower_left_corner - origin;
+        const psow::ray r = psow::ray(origin, direction);
+
+        if (s.intersects_ray(r))
+            return red;
+
+        return sky_gradient(r);
+    };
+
+    const auto sampler = [&](unsigned int n, unsigned int y,
+                             const psow::pixel_sample &ps)
+    {
+        return trace(n, y, ps.dx, ps.dy);
+    };
+
+    if (psow::flag_from_args(argc, argv, "--adaptive"))
+    {
+        psow::adaptive_options options;
+        options.max_samples = max_samples;
+
+        const psow::adaptive_result result =
+            psow::render_adaptive(acc, sampler, pool, options);
+
+        const double pixels = static_cast<double>(image_width) * image_height;
+
+        std::printf("adaptive: %llu samples (%.2f per pixel) in %u passes, "
+                    "%llu pixels hit the cap\n", result.samples,
+                    static_cast<double>(result.samples) / pixels,
+                    result.passes, result.unconverged);
+
+        psow::tonemap(acc, img, pool);
+
+        if (psow::flag_from_args(argc, argv, "--compare"))
+        {
+            psow::accumulator uniform_acc(image_width, image_height);
+            psow::image uniform(image_width, image_height);
+            psow::progressive_options uniform_options;
+            double sum = 0.0;
+            std::size_t k;
+
+            uniform_options.max_samples = max_samples;
+            psow::render_progressive(uniform_acc, sampler, pool,
+                                     uniform_options);
+            psow::tonemap(uniform_acc, uniform, pool);
+
+            for (k = 0; k < 3UL * image_width * image_height; ++k)
+            {
+                const double d = static_cast<double>(img.pixels[k]) -
+                                 static_cast<double>(uniform.pixels[k]);
+                sum += d * d;
+            }
+
+            std::printf("uniform:  %.0f samples, %.2fx the rays, "
+                        "RMS difference %.3f / 255\n",
+                        pixels * max_samples,
+                        pixels * max_samples /
+                            static_cast<double>(result.samples),
+                        std::sqrt(sum / (3.0 * pixels)));
+        }
+    }
+
+    else
+    {
+        /*  One pass over the image per sample position, each pass offsetting *
+         *  the rays by (dx, dy) pixels from the pixel corner.                */
+        for (sy = 0U; sy < samples_per_side; ++sy)
+        {
+            for (sx = 0U; sx < samples_per_side; ++sx)
+            {
+                const double dx = (sx + 0.5) / samples_per_side;
+                const double dy = (sy + 0.5) / samples_per_side;
+
+                const auto shader = [&](unsigned int n, unsigned int y)
+                {
+                    return trace(n, y, dx, dy);
+                };
+
+                psow::accumulate(acc, shader, pool);
+            }
+        }
+
+        psow::tonemap(acc, img, pool);
+    }
+
+    FILE *fp = std::fopen("test_antialias.ppm", "wb");
+
+    if (!fp)
+    {
+        std::puts("fopen failed and returned NULL. Aborting.");
+        return -1;
+    }
+
+    if (!img.write(fp))
+    {
+        std::puts("Failed to write the image. Aborting.");
+        std::fclose(fp);
+        return -1;
+    }
+
+    std::fclose(fp);
+    return 0;
+}
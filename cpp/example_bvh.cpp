@@ -0,0 +1,261 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      This is part of a set of files I made while studying from Peter       *
+ *      Shirley's "Ray Tracing in One Weekend", Copyright 2018-2020, Peter    *
+ *      Shirley, All rights reserved. The code is my own, but follows the     *
+ *      ideas laid out in the text.                                           *
+ *                                                                            *
+ *      Builds bounding volume hierarchies over a large random field of       *
+ *      spheres with the serial and parallel SAH and Morton-code builders,    *
+ *      checks them against the linear search of psow::sphere_list, and       *
+ *      renders the field with each. Build and render times are reported      *
+ *      separately. Pass the number of spheres as the first argument, and "-- *
+ *      threads N" to set the number of threads.                              *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  std::equal, for comparing the serial and parallel trees.                  */
+#include <algorithm>
+
+/*  std::chrono is used for timing.                                           */
+#include <chrono>
+
+/*  fabs, used to compare hit distances.                                      */
+#include <cmath>
+
+/*  And the equivalent of stdio.h.                                            */
+#include <cstdio>
+
+/*  strtoul, for reading the number of spheres.                               */
+#include <cstdlib>
+
+/*  std::mt19937 is used to scatter the spheres.                              */
+#include <random>
+
+#include "psow_color.hpp"
+#include "psow_vec3.hpp"
+#include "psow_ray.hpp"
+#include "psow_sphere.hpp"
+#include "psow_sphere_list.hpp"
+#include "psow_bvh.hpp"
+#include "psow_image.hpp"
+#include "psow_renderer.hpp"
+
+/*  Function for coloring the background with a gradient.                     */
+static psow::color sky_gradient(const psow::ray &r)
+{
+    psow::vec3 v = (r.v).unit();
+    const double t = 0.5 * (v.y + 1.0);
+    psow::color sky_blue = psow::color(128U, 180U, 255U);
+    psow::color white    = psow::color(255U, 255U, 255U);
+    return (white*(1.0 - t) + sky_blue*t) * 2.0;
+}
+/*  End of sky_gradient.                                                      */
+
+/*  Checks random rays from the camera against the linear search of the list. *
+ *  They must find the same sphere at the same distance.                      */
+static bool check_tree(const psow::bvh &tree, const psow::sphere_list &scene)
+{
+    unsigned int k;
+    const unsigned int checks = 2000U;
+    const psow::vec3 origin = psow::vec3(0.0, 0.0, 0.0);
+    std::mt19937 engine(2U);
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+
+    for (k = 0U; k < checks; ++k)
+    {
+        const psow::vec3 direction = psow::vec3(unit(engine), unit(engine),
+                                                -1.0);
+        const psow::ray r = psow::ray(origin, direction);
+        double t_tree = 0.0, t_list = 0.0;
+        std::size_t i_tree = 0, i_list = 0;
+
+        const bool hit_tree =
+            tree.nearest_hit(r, 0.0, 1.0E300, t_tree, i_tree);
+        const bool hit_list =
+            scene.nearest_hit(r, 0.0, 1.0E300, t_list, i_list);
+
+        if (hit_tree != hit_list)
+            return false;
+
+        if (hit_tree && (i_tree != i_list || t_tree != t_list))
+            return false;
+
+        /*  The hit records must agree with the searches, and with a direct   *
+         *  test of the sphere that was found, up to rounding.                */
+        psow::hit_record rec_tree, rec_list, rec_sphere;
+
+        const bool found_tree = tree.hit(r, 0.0, 1.0E300, rec_tree);
+        const bool found_list = scene.hit(r, 0.0, 1.0E300, rec_list);
+
+        if (found_tree != hit_tree || found_list != hit_list)
+            return false;
+
+        if (!found_tree || !found_list)
+            continue;
+
+        if (rec_tree.index != i_tree || rec_tree.t != t_tree ||
+            rec_list.index != i_list || rec_list.t != t_list)
+            return false;
+
+        if (!scene.get(i_list).hit(r, 0.0, 1.0E300, rec_sphere))
+            return false;
+
+        if (std::fabs(rec_sphere.t - t_list) > 1.0E-9 * t_list ||
+            std::fabs(rec_sphere.normal.normsq() - 1.0) > 1.0E-9 ||
+            !rec_sphere.front_face)
+            return false;
+    }
+
+    return true;
+}
+/*  End of check_tree.                                                        */
+
+/*  Seconds elapsed since start.                                              */
+static double
+seconds_since(const std::chrono::steady_clock::time_point &start)
+{
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    return elapsed.count();
+}
+
+/*  Builds the tree both ways with both builders, verifies it, and renders    *
+ *  with it. Build and render times are reported separately.                  */
+int main(int argc, char **argv)
+{
+    unsigned int k, q;
+    unsigned long number_of_spheres = 100000UL;
+    const unsigned int image_width  = 960U;
+    const unsigned int image_height = 540U;
+    const double viewport_height = 2.0;
+    const double viewport_width = viewport_height * 16.0 / 9.0;
+    const double u_factor = viewport_width / (image_width - 1U);
+    const double v_factor = viewport_height / (image_height - 1U);
+    const psow::vec3 origin = psow::vec3(0.0, 0.0, 0.0);
+    const unsigned int threads = psow::thread_count_from_args(argc, argv);
+    const psow::bvh_quality qualities[2] = {psow::bvh_sah, psow::bvh_fast};
+    const char * const names[2] = {"sah", "fast"};
+
+    if (argc > 1 && argv[1][0] != '-')
+        number_of_spheres = std::strtoul(argv[1], NULL, 10);
+
+    if (threads == 0U || number_of_spheres == 0UL)
+    {
+        std::puts("Usage: example_bvh [number_of_spheres] [--threads N]");
+        return -1;
+    }
+
+    std::mt19937 engine(1U);
+    std::uniform_real_distribution<double> spread(-50.0, 50.0);
+    std::uniform_real_distribution<double> depth(-100.0, -2.0);
+    std::uniform_real_distribution<double> size(0.05, 0.3);
+
+    psow::sphere_list scene;
+    psow::thread_pool pool(threads);
+    psow::image img(image_width, image_height);
+
+    scene.reserve(number_of_spheres);
+
+    for (k = 0U; k < number_of_spheres; ++k)
+    {
+        const psow::vec3 center = psow::vec3(spread(engine), spread(engine),
+                                             depth(engine));
+        scene.add(psow::sphere(size(engine), center));
+    }
+
+    std::printf("%lu spheres, %u threads\n", number_of_spheres, threads);
+
+    for (q = 0U; q < 2U; ++q)
+    {
+        psow::bvh serial, tree;
+        psow::bvh_options options;
+        options.quality = qualities[q];
+
+        const std::chrono::steady_clock::time_point serial_start =
+            std::chrono::steady_clock::now();
+
+        serial.build(scene, options);
+
+        const double serial_time = seconds_since(serial_start);
+        const std::chrono::steady_clock::time_point build_start =
+            std::chrono::steady_clock::now();
+
+        tree.build(scene, options, pool);
+
+        const double build_time = seconds_since(build_start);
+
+        if (tree.nodes.size() != serial.nodes.size() ||
+            !std::equal(tree.indices.data(),
+                        tree.indices.data() + tree.indices.size(),
+                        serial.indices.data()))
+        {
+            std::puts("The parallel build differs from the serial one.");
+            return -1;
+        }
+
+        if (!check_tree(tree, scene))
+        {
+            std::puts("The BVH disagrees with the linear search. Aborting.");
+            return -1;
+        }
+
+        const auto shader = [&](unsigned int n, unsigned int m) -> psow::color
+        {
+            const double u = n * u_factor - 0.5 * viewport_width;
+            const double v = 0.5 * viewport_height - m * v_factor;
+            const psow::ray r = psow::ray(origin, psow::vec3(u, v, -1.0));
+            double t;
+            std::size_t index;
+
+            if (tree.nearest_hit(r, 0.0, 1.0E300, t, index))
+                return psow::color(255U, 0U, 0U) * (1.0 / (1.0 + 0.02 * t));
+
+            return sky_gradient(r);
+        };
+
+        const std::chrono::steady_clock::time_point render_start =
+            std::chrono::steady_clock::now();
+
+        psow::render(img, shader, pool);
+
+        const double render_time = seconds_since(render_start);
+
+        std::printf("%-4s %lu nodes, build %.3f s serial, %.3f s parallel, "
+                    "render %.3f s (%.2f Mrays/s)\n", names[q],
+                    static_cast<unsigned long>(tree.nodes.size()),
+                    serial_time, build_time, render_time,
+                    1.0E-6 * image_width * image_height / render_time);
+    }
+
+    FILE *fp = std::fopen("bvh.ppm", "w");
+
+    if (!fp)
+    {
+        std::puts("fopen failed and returned NULL. Aborting.");
+        return -1;
+    }
+
+    img.write(fp);
+    std::fclose(fp);
+    return 0;
+}
+/*  End of main.                                                              */
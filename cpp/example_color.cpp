@@ -26,12 +26,15 @@
  *  Date:       May 10, 2021                                                  *
  ******************************************************************************/
 
-/*  fputc is found here.                                                      */
+/*  fopen is found here.                                                      */
 #include <cstdio>
 
 /*  Color struct found here.                                                  */
 #include "psow_color.hpp"
 
+/*  Image struct, the framebuffer the colors are stored in.                   */
+#include "psow_image.hpp"
+
 /*  Function for testing the color struct defined above.                      */
 int main(void)
 {
@@ -53,6 +56,9 @@ int main(void)
     /*  Declare a psow::color to use for the computation.                     */
     psow::color c;
 
+    /*  The colors are stored in an image and written to the file all at once.*/
+    psow::image img(size, size);
+
     /*  If fopen failed, it returns NULL. Check if this happened.             */
     if (!fp)
     {
@@ -60,9 +66,6 @@ int main(void)
         return -1;
     }
 
-    /*  Write the preamble to the PPM file.                                   */
-    std::fprintf(fp, "P6\n%u %u\n255\n", size, size);
-
     /*  Loop over the pixels of the PPM and compute the colors.               */
     for (y = 0U; y < size; ++y)
     {
@@ -75,13 +78,16 @@ int main(void)
             /*  Use the constructor to create the color from these values.    */
             c = psow::color(r, g, 64U);
 
-            /*  Use the write method to write this color to the PPM file.     */
-            c.write(fp);
+            /*  Store the color in the image.                                 */
+            img.set(x, y, c);
         }
         /*  End of x for-loop.                                                */
     }
     /*  End of y for-loop.                                                    */
 
+    /*  Write the preamble and all of the pixels to the PPM file.             */
+    img.write(fp);
+
     /*  Close the file and return.                                            */
     std::fclose(fp);
     return 0;
@@ -0,0 +1,217 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      This is part of a set of files I made while studying from Peter       *
+ *      Shirley's "Ray Tracing in One Weekend", Copyright 2018-2020, Peter    *
+ *      Shirley, All rights reserved. The code is my own, but follows the     *
+ *      ideas laid out in the text.                                           *
+ *                                                                            *
+ *      Shades the background from lookup tables: the sky gradient of the     *
+ *      book baked into a sky_lut and a cube map, and a cube map resampled    *
+ *      from an equirectangular Radiance file. Checks them against the        *
+ *      gradient itself, times all of them, and renders the environment.      *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  std::chrono is used for timing the lookups.                               */
+#include <chrono>
+
+/*  fabs, used to compare colors.                                             */
+#include <cmath>
+
+/*  And the equivalent of stdio.h.                                            */
+#include <cstdio>
+
+#include "psow_vec3.hpp"
+#include "psow_ray.hpp"
+#include "psow_rgb.hpp"
+#include "psow_camera.hpp"
+#include "psow_image.hpp"
+#include "psow_accumulator.hpp"
+#include "psow_static_scene.hpp"
+#include "psow_hdr.hpp"
+#include "psow_environment.hpp"
+
+/*  Primary rays of a 960x540 image with a 90 degree field of view, looking   *
+ *  down -z, so both the sky and the ground below the horizon are in view.    */
+static const unsigned int image_width  = 960U;
+static const unsigned int image_height = 540U;
+
+/*  The sky written out when no file is given, small enough to write quickly. */
+static const unsigned int equirect_width  = 1024U;
+static const unsigned int equirect_height = 512U;
+
+/*  The gradient of the book, evaluated directly.                             */
+static constexpr psow::sky_gradient sky = psow::book_sky();
+
+/*  Largest difference of any channel of two colors.                          */
+static double difference(const psow::rgb &a, const psow::rgb &b)
+{
+    const double dr = std::fabs(a.r - b.r);
+    const double dg = std::fabs(a.g - b.g);
+    const double db = std::fabs(a.b - b.b);
+    return (dr > dg ? (dr > db ? dr : db) : (dg > db ? dg : db));
+}
+
+/*  Writes the gradient as an equirectangular Radiance file.                  */
+static bool write_sky(const char *path)
+{
+    unsigned int x, y;
+    psow::hdr_image equirect(equirect_width, equirect_height);
+
+    for (y = 0U; y < equirect_height; ++y)
+    {
+        for (x = 0U; x < equirect_width; ++x)
+        {
+            const double u = (x + 0.5) / equirect_width;
+            const double v = (y + 0.5) / equirect_height;
+            const psow::vec3 d = psow::direction_from_equirect(u, v);
+            equirect.set(x, y, sky.at(0.5 * (d.y + 1.0)));
+        }
+    }
+
+    return equirect.write(path);
+}
+
+/*  Evaluates background over every primary ray of the image, and returns the *
+ *  time per ray in nanoseconds. The sum of the colors is printed so that the *
+ *  work is not optimized away.                                               */
+template <class background_type>
+static double time_background(const char *name, const psow::camera &cam,
+                              const background_type &background)
+{
+    const unsigned int repetitions = 10U;
+    unsigned int x, y, n;
+    double sum = 0.0;
+
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+
+    for (n = 0U; n < repetitions; ++n)
+    {
+        for (y = 0U; y < image_height; ++y)
+        {
+            for (x = 0U; x < image_width; ++x)
+            {
+                const psow::rgb c = background(cam.get_ray(x, y, 0.5, 0.5));
+                sum += c.g;
+            }
+        }
+    }
+
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    const double rays =
+        static_cast<double>(image_width) * image_height * repetitions;
+    const double ns = 1.0E9 * elapsed.count() / rays;
+
+    std::printf("%-9s %6.2f ns/ray (mean green %.4f)\n", name, ns,
+                sum / rays);
+    return ns;
+}
+/*  End of time_background.                                                   */
+
+/*  Bakes the gradient, writes and reads it back unless a Radiance file is    *
+ *  given as the first argument, and compares, times, and renders the tables. */
+int main(int argc, char **argv)
+{
+    unsigned int x, y;
+    const char *path = (argc > 1 ? argv[1] : "sky.hdr");
+    const psow::camera cam(image_width, image_height);
+    psow::sky_lut<psow::rgb> lut;
+    psow::cube_map<psow::rgb> baked, loaded;
+    psow::accumulator acc(image_width, image_height);
+    psow::image img(image_width, image_height);
+    double lut_error = 0.0, baked_error = 0.0, loaded_error = 0.0;
+
+    if (argc <= 1 && !write_sky(path))
+    {
+        std::printf("Could not write %s. Aborting.\n", path);
+        return -1;
+    }
+
+    if (!psow::load_environment(path, loaded))
+    {
+        std::printf("Could not read %s as a Radiance file. Aborting.\n", path);
+        return -1;
+    }
+
+    const auto height_of = [](double height) -> psow::rgb
+    {
+        return sky.at(0.5 * (height + 1.0));
+    };
+
+    const auto direction_of = [](const psow::vec3 &d) -> psow::rgb
+    {
+        return sky.at(0.5 * (d.y + 1.0));
+    };
+
+    lut.bake(height_of);
+    baked.bake(direction_of);
+
+    /*  The tables are nearest neighbor lookups, so they differ from the      *
+     *  gradient by up to the change across one entry.                        */
+    for (y = 0U; y < image_height; ++y)
+    {
+        for (x = 0U; x < image_width; ++x)
+        {
+            const psow::ray r = cam.get_ray(x, y, 0.5, 0.5);
+            const psow::rgb exact = sky(r);
+            const double e0 = difference(lut.lookup(r.v), exact);
+            const double e1 = difference(baked.lookup(r.v), exact);
+            const double e2 = difference(loaded.lookup(r.v), exact);
+
+            lut_error = (e0 > lut_error ? e0 : lut_error);
+            baked_error = (e1 > baked_error ? e1 : baked_error);
+            loaded_error = (e2 > loaded_error ? e2 : loaded_error);
+            acc.add(x, y, loaded.lookup(r.v));
+        }
+    }
+
+    std::printf("Largest difference from the gradient: sky_lut %.4f, "
+                "cube map %.4f, %s %.4f\n",
+                lut_error, baked_error, path, loaded_error);
+
+    /*  The cost of the rays alone, to subtract from the others.              */
+    time_background("rays", cam, [](const psow::ray &r) {
+        return psow::rgb(r.v.x, r.v.y, r.v.z);
+    });
+    time_background("gradient", cam, sky);
+    time_background("sky_lut", cam, [&](const psow::ray &r) {
+        return lut.lookup(r.v);
+    });
+    time_background("cube_map", cam, [&](const psow::ray &r) {
+        return loaded.lookup(r.v);
+    });
+
+    psow::tonemap(acc, img);
+
+    FILE *fp = std::fopen("environment.ppm", "w");
+
+    if (!fp)
+    {
+        std::puts("fopen failed and returned NULL. Aborting.");
+        return -1;
+    }
+
+    img.write(fp);
+    std::fclose(fp);
+    return 0;
+}
+/*  End of main.                                                              */
@@ -0,0 +1,356 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Renders the cover scene of "Ray Tracing in One Weekend", a field of   *
+ *      small diffuse, metal, and glass balls around three large ones, with   *
+ *      the path tracer. Options:                                             *
+ *          --threads N   Render threads, the default is one per core.        *
+ *          --samples N   Samples per pixel, default 16.                      *
+ *          --width N     Width of the image, default 640.                    *
+ *          --sequence S  Sample positions, sobol (default), halton, or r2.   *
+ *          --telemetry PATH                                                  *
+ *                        Report the progress and throughput on stderr while  *
+ *                        rendering, and write the counters to PATH as JSON.  *
+ *          --trace PATH  Write the trace zones to PATH as Chrome trace JSON. *
+ *                        They are only recorded when built with PSOW_TRACE.  *
+ *          --scene PATH  Render the scene file at PATH, text or binary,      *
+ *                        instead of the cover scene.                         *
+ *          --save-scene PATH                                                 *
+ *                        Write the cover scene to PATH as text and exit.     *
+ *          --bvh-cache DIR                                                   *
+ *                        Load the BVH from the cache in the directory DIR,   *
+ *                        or build it and save it there for the next run.     *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  std::chrono is used for timing the build of the BVH.                      */
+#include <chrono>
+
+/*  And the equivalent of stdio.h.                                            */
+#include <cstdio>
+
+/*  strcmp, for the name of the sequence and the telemetry option.            */
+#include <cstring>
+
+#include "psow_vec3.hpp"
+#include "psow_ray.hpp"
+#include "psow_sphere.hpp"
+#include "psow_rgb.hpp"
+#include "psow_random.hpp"
+#include "psow_low_discrepancy.hpp"
+#include "psow_camera.hpp"
+#include "psow_material.hpp"
+#include "psow_scene.hpp"
+#include "psow_scene_file.hpp"
+#include "psow_bvh_cache.hpp"
+#include "psow_path_tracer.hpp"
+#include "psow_static_scene.hpp"
+#include "psow_accumulator.hpp"
+#include "psow_progressive.hpp"
+#include "psow_renderer.hpp"
+#include "psow_telemetry.hpp"
+#include "psow_trace.hpp"
+
+/*  The large spheres of the scene, known at compile time: a grey ground, and *
+ *  balls of glass, brown diffuse, and polished metal. The table is in        *
+ *  read-only data and nothing is constructed for it when the program starts. */
+static constexpr psow::static_sphere large_spheres[] = {
+    psow::static_sphere(
+        psow::sphere(1000.0, psow::vec3(0.0, -1000.0, 0.0)),
+        psow::material::lambertian(psow::rgb(0.5, 0.5, 0.5))
+    ),
+    psow::static_sphere(
+        psow::sphere(1.0, psow::vec3(0.0, 1.0, 0.0)),
+        psow::material::dielectric(1.5)
+    ),
+    psow::static_sphere(
+        psow::sphere(1.0, psow::vec3(-4.0, 1.0, 0.0)),
+        psow::material::lambertian(psow::rgb(0.4, 0.2, 0.1))
+    ),
+    psow::static_sphere(
+        psow::sphere(1.0, psow::vec3(4.0, 1.0, 0.0)),
+        psow::material::metal(psow::rgb(0.7, 0.6, 0.5), 0.0)
+    )
+};
+
+/*  White at the horizon fading to sky blue overhead. This is the only light. */
+static constexpr psow::sky_gradient sky = psow::book_sky();
+
+/*  Camera looking from (13, 2, 3) at the origin, 20 degrees vertical field   *
+ *  of view, focused 10 units away with a lens of radius 0.05.                */
+static constexpr psow::camera_options view(
+    psow::vec3(13.0, 2.0, 3.0), psow::vec3(0.0, 0.0, 0.0),
+    psow::vec3(0.0, 1.0, 0.0), 20.0, 0.0, 0.1, 10.0
+);
+
+/*  The large spheres, and a grid of small random balls.                      */
+static void make_scene(psow::scene &world)
+{
+    psow::pcg32 rng(42ULL);
+    int a, b;
+
+    const unsigned int glass =
+        world.add_material(psow::material::dielectric(1.5));
+
+    psow::add_static_spheres(world, large_spheres);
+
+    for (a = -11; a < 11; ++a)
+    {
+        for (b = -11; b < 11; ++b)
+        {
+            const double choose = rng.uniform();
+            const psow::vec3 center(a + 0.9*rng.uniform(), 0.2,
+                                    b + 0.9*rng.uniform());
+
+            /*  Keep clear of the large metal ball.                           */
+            if ((center - psow::vec3(4.0, 0.2, 0.0)).norm() <= 0.9)
+                continue;
+
+            if (choose < 0.8)
+            {
+                const psow::rgb albedo(rng.uniform() * rng.uniform(),
+                                       rng.uniform() * rng.uniform(),
+                                       rng.uniform() * rng.uniform());
+                world.add(psow::sphere(0.2, center), world.add_material(
+                    psow::material::lambertian(albedo)
+                ));
+            }
+
+            else if (choose < 0.95)
+            {
+                const psow::rgb albedo(rng.uniform(0.5, 1.0),
+                                       rng.uniform(0.5, 1.0),
+                                       rng.uniform(0.5, 1.0));
+                const double fuzz = rng.uniform(0.0, 0.5);
+                world.add(psow::sphere(0.2, center), world.add_material(
+                    psow::material::metal(albedo, fuzz)
+                ));
+            }
+
+            else
+                world.add(psow::sphere(0.2, center), glass);
+        }
+    }
+}
+/*  End of make_scene.                                                        */
+
+/*  Builds the scene, traces samples_per_pixel paths through every pixel with *
+ *  a thin-lens camera, and writes the tonemapped result.                     */
+int main(int argc, char **argv)
+{
+    unsigned int image_width = 640U;
+    unsigned int samples = 16U;
+    psow::sample_sequence sequence = psow::sequence_sobol;
+    bool known_sequence = true;
+    const char *telemetry_path = NULL;
+    const char *trace_path = NULL;
+    const char *scene_path = NULL;
+    const char *save_path = NULL;
+    const char *cache_path = NULL;
+    bool loaded = true;
+    int n;
+    const unsigned int threads = psow::thread_count_from_args(argc, argv);
+
+    for (n = 1; n + 1 < argc; ++n)
+    {
+        if (std::strcmp(argv[n], "--telemetry") == 0)
+            telemetry_path = argv[n + 1];
+
+        if (std::strcmp(argv[n], "--trace") == 0)
+            trace_path = argv[n + 1];
+
+        if (std::strcmp(argv[n], "--scene") == 0)
+            scene_path = argv[n + 1];
+
+        if (std::strcmp(argv[n], "--save-scene") == 0)
+            save_path = argv[n + 1];
+
+        if (std::strcmp(argv[n], "--bvh-cache") == 0)
+            cache_path = argv[n + 1];
+
+        if (std::strcmp(argv[n], "--sequence") != 0)
+            continue;
+
+        if (std::strcmp(argv[n + 1], "sobol") == 0)
+            sequence = psow::sequence_sobol;
+        else if (std::strcmp(argv[n + 1], "halton") == 0)
+            sequence = psow::sequence_halton;
+        else if (std::strcmp(argv[n + 1], "r2") == 0)
+            sequence = psow::sequence_r2;
+        else
+            known_sequence = false;
+    }
+
+    if (threads == 0U || !known_sequence ||
+        !psow::unsigned_from_args(argc, argv, "--samples", samples) ||
+        !psow::unsigned_from_args(argc, argv, "--width", image_width) ||
+        samples == 0U || image_width < 2U)
+    {
+        std::puts("Usage: example_path_tracer [--threads N] [--samples N] "
+                  "[--width N]\n                           "
+                  "[--sequence sobol|halton|r2]\n"
+                  "                           [--telemetry PATH] "
+                  "[--trace PATH]\n"
+                  "                           [--scene PATH | "
+                  "--save-scene PATH]\n"
+                  "                           [--bvh-cache DIR]");
+        return -1;
+    }
+
+    const unsigned int image_height = image_width * 9U / 16U;
+
+    const psow::camera cam(image_width, image_height, view);
+    psow::thread_pool pool(threads);
+    psow::scene world;
+    psow::accumulator acc(image_width, image_height);
+    psow::progressive_options options;
+    psow::telemetry monitor(threads);
+    psow::bvh_cache cache(cache_path ? cache_path : "");
+
+#if PSOW_HAS_MMAP
+    psow::mapped_scene mapping;
+#endif
+
+    if (save_path)
+    {
+        make_scene(world);
+
+        if (!psow::write_scene_text(save_path, world))
+        {
+            std::puts("Failed to write the scene. Aborting.");
+            return -1;
+        }
+
+        return 0;
+    }
+
+    /*  Binary scenes are used straight from the mapped file when possible.   */
+    if (!scene_path)
+        make_scene(world);
+
+    else if (psow::is_binary_scene(scene_path))
+    {
+#if PSOW_HAS_MMAP
+        loaded = mapping.open(scene_path, world);
+#else
+        loaded = psow::read_scene_binary(scene_path, world);
+#endif
+    }
+
+    else
+        loaded = psow::read_scene_text(scene_path, world);
+
+    if (!loaded)
+    {
+        std::printf("Failed to read the scene %s. Aborting.\n", scene_path);
+        return -1;
+    }
+
+    /*  A cached tree skips the build on every run after the first.           */
+    if (cache_path)
+    {
+        const std::chrono::steady_clock::time_point start =
+            std::chrono::steady_clock::now();
+        const psow::bvh_cache_result cached =
+            cache.build(world.tree, world.spheres, psow::bvh_options(), pool);
+        const std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        std::printf("BVH %s in %.1f ms\n",
+                    cached == psow::bvh_cache_loaded ? "loaded" : "built",
+                    elapsed.count() * 1.0E3);
+
+        if (cached == psow::bvh_cache_built)
+            std::printf("Failed to save the BVH in %s.\n", cache_path);
+    }
+
+    else
+        world.build(pool);
+
+    /*  The position in the pixel and on the lens, dimensions 0 to 3 of the   *
+     *  sample, come from the low-discrepancy sequence. The bounces use a     *
+     *  counter-based stream per pixel and sample. Results do not depend on   *
+     *  which thread renders what, so every run gives the same image.         */
+    const auto sampler = [&](unsigned int x, unsigned int y,
+                             const psow::pixel_sample &s) -> psow::rgb
+    {
+        psow::philox_rng rng(
+            2026ULL, static_cast<unsigned long long>(y) * image_width + x,
+            s.index
+        );
+        const psow::ray r =
+            cam.get_ray(x, y, s.dx, s.dy, s.get(2U), s.get(3U));
+
+        psow::telemetry_counters *counters =
+            (telemetry_path ? &monitor.local() : NULL);
+
+        return psow::trace_path(world, r, rng, sky, psow::path_options(),
+                                counters);
+    };
+
+    options.max_samples = samples;
+    options.snapshot_path = "test_path_tracer.ppm";
+    options.sequence = sequence;
+
+    /*  The reporter writes to stderr, so the telemetry is off by default.    */
+    if (telemetry_path)
+    {
+        options.monitor = &monitor;
+        monitor.start_reporting(
+            stderr, 500U,
+            static_cast<unsigned long long>(image_width) * image_height *
+            samples
+        );
+    }
+
+    const psow::progressive_result result =
+        psow::render_progressive(acc, sampler, pool, options);
+
+    monitor.stop_reporting();
+
+    std::printf("%zu spheres, %u samples per pixel, %.1f s\n",
+                world.spheres.size(), result.passes,
+                result.elapsed_ms * 1.0E-3);
+
+    if (!result.ok)
+    {
+        std::puts("Failed to write the image. Aborting.");
+        return -1;
+    }
+
+    if (telemetry_path && !monitor.write_json(telemetry_path))
+    {
+        std::puts("Failed to write the telemetry. Aborting.");
+        return -1;
+    }
+
+    if (trace_path)
+    {
+        if (!psow::trace_enabled)
+            std::puts("Built without PSOW_TRACE, the trace is empty.");
+
+        if (!psow::write_chrome_trace(trace_path))
+        {
+            std::puts("Failed to write the trace. Aborting.");
+            return -1;
+        }
+    }
+
+    return 0;
+}
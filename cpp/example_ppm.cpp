@@ -29,6 +29,9 @@
 /*  fopen and puts are found here. This is the C++ equivalent of stdio.h.     */
 #include <cstdio>
 
+/*  The pixels are collected in a std::vector and written out all at once.    */
+#include <vector>
+
 /*  Function for creating a PPM file with a color gradient.                   */
 int main(void)
 {
@@ -49,6 +52,12 @@ int main(void)
      *  as well), but I find this ugly as sin.                                */
     unsigned int x, y;
 
+    /*  Writing three bytes at a time with fputc means three function calls   *
+     *  per pixel. Instead the pixels are stored in memory, row by row, and   *
+     *  the whole block is written with one fwrite at the end.                */
+    std::vector<unsigned char> pixels(3UL * size * size);
+    unsigned char *p = &pixels[0];
+
     /*  We'll write the output to a .ppm file. Open this with fopen.          */
     FILE *fp = std::fopen("basic_ppm.ppm", "w");
 
@@ -85,15 +94,19 @@ int main(void)
             green = static_cast<unsigned char>(y * factor);
             blue = 64U;
 
-            /*  Write the RGB value to the file.                              */
-            std::fputc(red, fp);
-            std::fputc(green, fp);
-            std::fputc(blue, fp);
+            /*  Store the RGB value in the buffer.                            */
+            p[0] = red;
+            p[1] = green;
+            p[2] = blue;
+            p += 3;
         }
         /*  End of x for-loop.                                                */
     }
     /*  End of y for-loop.                                                    */
 
+    /*  Write all of the pixels to the file at once.                          */
+    std::fwrite(&pixels[0], 1, pixels.size(), fp);
+
     /*  Close the file and return.                                            */
     std::fclose(fp);
     return 0;
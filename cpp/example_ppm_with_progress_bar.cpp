@@ -20,15 +20,25 @@
  *      Shirley, All rights reserved. The code is my own, but follows the     *
  *      ideas laid out in the text.                                           *
  *                                                                            *
- *      This file shows basic usage of the PPM file format.                   *
+ *      This file shows basic usage of the PPM file format. The progress is   *
+ *      reported by psow::telemetry from a thread of its own, and the         *
+ *      counters are written to basic_ppm_telemetry.json at the end.          *
  ******************************************************************************
  *  Author:     Ryan Maguire                                                  *
  *  Date:       May 10, 2021                                                  *
  ******************************************************************************/
 
+/*  std::chrono::steady_clock, used for timing the rows.                      */
+#include <chrono>
+
 /*  fopen and puts are found here. This is the C++ equivalent of stdio.h.     */
 #include <cstdio>
-#include <iostream>
+
+/*  The pixels are collected in a std::vector and written out all at once.    */
+#include <vector>
+
+/*  Per-thread counters and the thread reporting on them.                     */
+#include "psow_telemetry.hpp"
 
 /*  Function for creating a PPM file with a color gradient.                   */
 int main(void)
@@ -53,6 +63,20 @@ int main(void)
      *  as well), but I find this ugly as sin.                                */
     unsigned int x, y;
 
+    /*  Writing three bytes at a time with fputc means three function calls   *
+     *  per pixel. Instead the pixels are stored in memory, row by row, and   *
+     *  the whole block is written with one fwrite at the end.                */
+    std::vector<unsigned char> pixels(3UL * size * size);
+    unsigned char *p = &pixels[0];
+
+    /*  Printing a progress bar from the loop itself would flush stderr once  *
+     *  per row, and with several threads they would all queue up on the lock *
+     *  of the stream. Instead each row adds to the counters of this thread,  *
+     *  a plain add, and the telemetry's own thread prints the progress every *
+     *  100 milliseconds.                                                     */
+    psow::telemetry monitor(1U);
+    psow::telemetry_counters &counters = monitor.local();
+
     /*  fopen returns NULL on failure. Check that this didn't happen.         */
     if (!fp)
     {
@@ -74,10 +98,15 @@ int main(void)
      *  The text based options are more human-readable, but larger in file    *
      *  size. For this example we'll use RGB binary, which is P6.             */
     std::fprintf(fp, "P6\n%u %u\n255\n", size, size);
+    monitor.start_reporting(stderr, 100U,
+                            static_cast<unsigned long long>(size) * size);
 
     /*  Loop over all of the pixels.                                          */
     for (y = 0U; y < size; ++y)
     {
+        const std::chrono::steady_clock::time_point row_start =
+            std::chrono::steady_clock::now();
+
         for (x = 0U; x < size; ++x)
         {
             /*  Compute the RGB value as a gradient based on the where the    *
@@ -86,22 +115,35 @@ int main(void)
             green = static_cast<unsigned char>(y * factor);
             blue = 64U;
 
-            /*  Write the RGB value to the file.                              */
-            std::fputc(red, fp);
-            std::fputc(green, fp);
-            std::fputc(blue, fp);
+            /*  Store the RGB value in the buffer.                            */
+            p[0] = red;
+            p[1] = green;
+            p[2] = blue;
+            p += 3;
         }
         /*  End of x for-loop.                                                */
 
-        /*  Print a progress report.                                          */
-        std::cerr << "\rLines remaining: " << size - y - 1 << ' ' << std::flush;
+        /*  Count the row as a finished tile of size samples.                 */
+        counters.add_samples(size);
+        counters.add_tile(psow::nanoseconds_since(row_start));
     }
     /*  End of y for-loop.                                                    */
 
-    std::cerr << "\nDone\n" << std::flush;
+    monitor.stop_reporting();
 
-    /*  Close the file and return.                                            */
+    /*  Write all of the pixels to the file at once.                          */
+    std::fwrite(&pixels[0], 1, pixels.size(), fp);
+
+    /*  Close the file.                                                       */
     std::fclose(fp);
+
+    /*  And save the counters for later inspection.                           */
+    if (!monitor.write_json("basic_ppm_telemetry.json"))
+    {
+        std::puts("Failed to write the telemetry. Aborting.");
+        return -1;
+    }
+
     return 0;
 }
 /*  End of main.                                                              */
@@ -36,12 +36,15 @@
 #include "psow_color.hpp"
 #include "psow_vec3.hpp"
 #include "psow_ray.hpp"
+#include "psow_image.hpp"
+#include "psow_environment.hpp"
 
-/*  Function for coloring the background with a gradient.                     */
-static inline psow::color sky_gradient(const psow::ray &r)
+/*  Function for coloring the background with a gradient, given the height of *
+ *  the unit direction, its y component. It is baked into a sky_lut, so each  *
+ *  pixel costs a table lookup rather than a normalization and a blend.       */
+static psow::color sky_gradient(double height)
 {
-    psow::vec3 v = (r.v).unit();
-    const double t = 0.5 * (v.y + 1.0);
+    const double t = 0.5 * (height + 1.0);
     psow::color sky_blue = psow::color(128U, 180U, 255U);
     psow::color white    = psow::color(255U, 255U, 255U);
     return (white*(1.0 - t) + sky_blue*t) * 2.0;
@@ -72,15 +75,9 @@ int main(void)
     const psow::vec3 lower_left_corner =
         origin - (horizontal*0.5) - (vertical*0.5) - focal_point;
 
-    FILE *fp = std::fopen("test_ray.ppm", "w");
-
-    if (!fp)
-    {
-        std::puts("fopen failed and returned NULL. Aborting.");
-        return -1;
-    }
-
-    std::fprintf(fp, "P6\n%u %u\n255\n", image_width, image_height);
+    psow::image img(image_width, image_height);
+    psow::sky_lut<psow::color> sky;
+    sky.bake(sky_gradient);
 
     for (m = image_height; m > 0; --m)
     {
@@ -94,12 +91,22 @@ int main(void)
                                          lower_left_corner - origin;
 
             const psow::ray r = psow::ray(origin, direction);
-            const psow::color color = sky_gradient(r);
+            const psow::color color = sky.lookup(r.v);
 
-            color.write(fp);
+            img.set(n, image_height - m, color);
         }
     }
 
+    FILE *fp = std::fopen("test_ray.ppm", "w");
+
+    if (!fp)
+    {
+        std::puts("fopen failed and returned NULL. Aborting.");
+        return -1;
+    }
+
+    img.write(fp);
+    std::fclose(fp);
     return 0;
 }
 
@@ -36,12 +36,17 @@
 #include "psow_vec3.hpp"
 #include "psow_ray.hpp"
 #include "psow_sphere.hpp"
-
-/*  Function for coloring the background with a gradient.                     */
-static psow::color sky_gradient(psow::ray r)
+#include "psow_image.hpp"
+#include "psow_renderer.hpp"
+#include "psow_stream_renderer.hpp"
+#include "psow_progressive.hpp"
+#include "psow_environment.hpp"
+
+/*  Function for coloring the background with a gradient, given the height of *
+ *  the unit direction. It is baked into a sky_lut, see example_ray.          */
+static psow::color sky_gradient(double height)
 {
-    psow::vec3 v = (r.v).unit();
-    double t = 0.5 * (v.y + 1.0);
+    double t = 0.5 * (height + 1.0);
 
     /*  Create a gradient from sky blue to white.                             */
     psow::color sky_blue = psow::color(128U, 180U, 255U);
@@ -50,11 +55,16 @@ static psow::color sky_gradient(psow::ray r)
 }
 /*  End of sky_gradient.                                                      */
 
-/*  Function for drawing a sky with a red ball in it.                         */
-int main(void)
+/*  Function for drawing a sky with a red ball in it. Pass "--threads N" to   *
+ *  set the number of render threads, the default is one per core. With       *
+ *  "--mmap" the threads render straight into a memory-mapped output file.    *
+ *  With "--stream" the image is written band by band as it is rendered, and  *
+ *  only a small ring of bands is ever held in memory. "--progressive MS"     *
+ *  refines the image with more samples per pixel until MS milliseconds or    *
+ *  "--samples N" samples per pixel, whichever comes first, writing a         *
+ *  snapshot every "--snapshot-ms T" milliseconds.                            */
+int main(int argc, char **argv)
 {
-    unsigned int m, n;
-    psow::color color;
     const double aspect_ratio = 16.0 / 9.0;
     const unsigned int image_width  = 1920U;
     const unsigned int image_height = static_cast<unsigned int>(
@@ -76,37 +86,155 @@ int main(void)
     const psow::vec3 lower_left_corner =
         origin - 0.5*(horizontal + vertical) - focal_point;
 
-    FILE *fp = std::fopen("test_ray_with_sphere.ppm", "w");
+    psow::sky_lut<psow::color> sky;
+    sky.bake(sky_gradient);
 
-    if (!fp)
+    const unsigned int threads = psow::thread_count_from_args(argc, argv);
+    unsigned int budget_ms = 0U;
+    unsigned int samples = 0U;
+    unsigned int snapshot_ms = 0U;
+
+    if (threads == 0U ||
+        !psow::unsigned_from_args(argc, argv, "--progressive", budget_ms) ||
+        !psow::unsigned_from_args(argc, argv, "--samples", samples) ||
+        !psow::unsigned_from_args(argc, argv, "--snapshot-ms", snapshot_ms))
     {
-        std::puts("fopen failed and returned NULL. Aborting.");
+        std::puts("Usage: example_ray_and_sphere [--threads N]\n"
+                  "    [--mmap | --stream |\n"
+                  "     --progressive MS [--samples N] [--snapshot-ms T]]");
         return -1;
     }
 
-    std::fprintf(fp, "P6\n%u %u\n255\n", image_width, image_height);
+    /*  Color seen at the point (u, v) of the viewport, both in [0, 1].       */
+    const auto trace = [&](double u, double v) -> psow::color
+    {
+        const psow::vec3 direction = horizontal*u + vertical*v +
+                                     lower_left_corner - origin;
+
+        const psow::ray r = psow::ray(origin, direction);
 
-    for (m = image_height; m > 0; --m)
+        if (s.intersects_ray(r))
+            return red;
+
+        return sky.lookup(r.v);
+    };
+
+    /*  Computes the color of the pixel in column n, row y. Row zero is the   *
+     *  top of the image, which corresponds to m = image_height in the        *
+     *  scanline loop this replaces.                                          */
+    const auto shader = [&](unsigned int n, unsigned int y) -> psow::color
+    {
+        const unsigned int m = image_height - y;
+        return trace(n * width_factor, m * height_factor);
+    };
+
+    psow::thread_pool pool(threads);
+
+    if (budget_ms != 0U || samples != 0U)
     {
-        const double v = m * height_factor;
+        psow::progressive_options options;
+        psow::accumulator acc(image_width, image_height);
+
+        /*  The first sample of each pixel, (1/2, 1/2), lands on the point the*
+         *  other modes use, so a single pass reproduces their image exactly. */
+        const auto sampler = [&](unsigned int n, unsigned int y,
+                                 const psow::pixel_sample &ps) -> psow::rgb
+        {
+            const double m = image_height - y;
+            const psow::color c = trace((n + ps.dx - 0.5) * width_factor,
+                                        (m + 0.5 - ps.dy) * height_factor);
+
+            return psow::rgb(c.red, c.green, c.blue) * (1.0 / 255.0);
+        };
+
+        options.max_samples = samples;
+        options.time_budget_ms = budget_ms;
+        options.snapshot_interval_ms = snapshot_ms;
+        options.snapshot_path = "test_ray_with_sphere.ppm";
+
+        /*  The colors are already gamma encoded.                             */
+        options.tonemap.gamma = 1.0F;
 
-        for (n = 0U; n < image_width; ++n)
+        const psow::progressive_result result =
+            psow::render_progressive(acc, sampler, pool, options);
+
+        std::printf("%u passes, first after %.1f ms, %u snapshots, "
+                    "%.1f ms total\n", result.passes, result.first_pass_ms,
+                    result.snapshots, result.elapsed_ms);
+
+        if (!result.ok)
         {
-            const double u = n * width_factor;
+            std::puts("Failed to write the image. Aborting.");
+            return -1;
+        }
 
-            const psow::vec3 direction = horizontal*u + vertical*v +
-                                         lower_left_corner - origin;
+        return 0;
+    }
+
+#if PSOW_HAS_MMAP
+    if (psow::flag_from_args(argc, argv, "--mmap"))
+    {
+        psow::mapped_ppm out;
 
-            const psow::ray r = psow::ray(origin, direction);
+        if (!out.open("test_ray_with_sphere.ppm", image_width, image_height))
+        {
+            std::puts("Failed to map the output file. Aborting.");
+            return -1;
+        }
 
-            if (s.intersects_ray(r))
-                color = red;
-            else
-                color = sky_gradient(r);
+        psow::render(out.frame(), shader, pool);
 
-            color.write(fp);
+        if (!out.close())
+        {
+            std::puts("Failed to write the image. Aborting.");
+            return -1;
         }
+
+        return 0;
+    }
+#endif
+
+    if (psow::flag_from_args(argc, argv, "--stream"))
+    {
+        FILE *fp = std::fopen("test_ray_with_sphere.ppm", "wb");
+
+        if (!fp)
+        {
+            std::puts("fopen failed and returned NULL. Aborting.");
+            return -1;
+        }
+
+        const bool ok = psow::render_stream(fp, image_width, image_height,
+                                            shader, pool);
+
+        if (std::fclose(fp) != 0 || !ok)
+        {
+            std::puts("Failed to write the image. Aborting.");
+            return -1;
+        }
+
+        return 0;
+    }
+
+    psow::image img(image_width, image_height);
+    psow::render(img, shader, pool);
+
+    FILE *fp = std::fopen("test_ray_with_sphere.ppm", "w");
+
+    if (!fp)
+    {
+        std::puts("fopen failed and returned NULL. Aborting.");
+        return -1;
+    }
+
+    /*  The whole frame is flushed with a single write.                       */
+    if (!img.write(fp))
+    {
+        std::puts("Failed to write the image. Aborting.");
+        std::fclose(fp);
+        return -1;
     }
 
+    std::fclose(fp);
     return 0;
 }
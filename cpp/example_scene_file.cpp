@@ -0,0 +1,217 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      This is part of a set of files I made while studying from Peter       *
+ *      Shirley's "Ray Tracing in One Weekend", Copyright 2018-2020, Peter    *
+ *      Shirley, All rights reserved. The code is my own, but follows the     *
+ *      ideas laid out in the text.                                           *
+ *                                                                            *
+ *      Writes a scene of many random spheres in the text and the binary scene*
+ *      formats, then loads it back three ways: parsing the text, reading the *
+ *      binary file, and mapping it. Prints how long each took, and checks    *
+ *      that every load gives back the same scene. Pass "--spheres N" for the *
+ *      size of the scene, one million by default. Given two file names       *
+ *      instead, converts the text scene IN to the binary scene OUT.          *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  std::chrono is used for timing the loads.                                 */
+#include <chrono>
+
+/*  And the equivalent of stdio.h.                                            */
+#include <cstdio>
+
+/*  memcmp, for comparing the sphere arrays.                                  */
+#include <cstring>
+
+#include "psow_vec3.hpp"
+#include "psow_sphere.hpp"
+#include "psow_material.hpp"
+#include "psow_random.hpp"
+#include "psow_scene.hpp"
+#include "psow_scene_file.hpp"
+#include "psow_renderer.hpp"
+
+/*  Names of the files written by the timing run.                             */
+static const char *text_path = "scene_file.txt";
+static const char *binary_path = "scene_file.psow";
+
+/*  Spheres scattered through a cube, each with one of a handful of materials.*/
+static void make_scene(psow::scene &world, unsigned int count)
+{
+    psow::pcg32 rng(2026ULL);
+    unsigned int n;
+
+    world.add_material(psow::material::lambertian(psow::rgb(0.5, 0.5, 0.5)));
+    world.add_material(psow::material::lambertian(psow::rgb(0.8, 0.3, 0.2)));
+    world.add_material(psow::material::metal(psow::rgb(0.7, 0.6, 0.5), 0.1));
+    world.add_material(psow::material::dielectric(1.5));
+    world.spheres.reserve(count);
+
+    for (n = 0U; n < count; ++n)
+    {
+        const psow::vec3 center(rng.uniform(-100.0, 100.0),
+                                rng.uniform(-100.0, 100.0),
+                                rng.uniform(-100.0, 100.0));
+
+        world.add(psow::sphere(rng.uniform(0.05, 0.5), center),
+                  static_cast<unsigned int>(rng.uniform() * 4.0));
+    }
+}
+
+/*  True if two arrays hold the same elements, bit for bit.                   */
+template <class array_type>
+static bool same_array(const array_type &a, const array_type &b)
+{
+    if (a.size() != b.size())
+        return false;
+
+    return a.size() == 0 ||
+           std::memcmp(a.data(), b.data(), a.size() * sizeof(a[0])) == 0;
+}
+
+/*  True if two scenes have the same spheres and materials.                   */
+static bool same_scene(const psow::scene &a, const psow::scene &b)
+{
+    std::size_t n;
+
+    if (!same_array(a.spheres.cx, b.spheres.cx) ||
+        !same_array(a.spheres.cy, b.spheres.cy) ||
+        !same_array(a.spheres.cz, b.spheres.cz) ||
+        !same_array(a.spheres.radius, b.spheres.radius) ||
+        !same_array(a.material_of, b.material_of) ||
+        a.materials.size() != b.materials.size())
+        return false;
+
+    for (n = 0; n < a.materials.size(); ++n)
+    {
+        const psow::material &p = a.materials[n];
+        const psow::material &q = b.materials[n];
+
+        if (p.kind != q.kind || p.albedo.r != q.albedo.r ||
+            p.albedo.g != q.albedo.g || p.albedo.b != q.albedo.b ||
+            p.fuzz != q.fuzz || p.refraction_index != q.refraction_index)
+            return false;
+    }
+
+    return true;
+}
+
+/*  Milliseconds since the given time.                                        */
+static double ms_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start
+    ).count();
+}
+
+/*  Reads the text scene at in and writes it to out in the binary format.     */
+static int convert(const char *in, const char *out)
+{
+    psow::scene world;
+    unsigned long line;
+
+    if (!psow::read_scene_text(in, world, &line))
+    {
+        if (line == 0UL)
+            std::printf("Could not read %s.\n", in);
+        else
+            std::printf("%s:%lu: malformed line.\n", in, line);
+
+        return -1;
+    }
+
+    if (!psow::write_scene_binary(out, world))
+    {
+        std::printf("Could not write %s.\n", out);
+        return -1;
+    }
+
+    std::printf("%zu spheres, %zu materials\n", world.spheres.size(),
+                world.materials.size());
+    return 0;
+}
+
+/*  Writes the scene in both formats, and times and checks each way back.     */
+int main(int argc, char **argv)
+{
+    unsigned int count = 1000000U;
+    psow::scene original, from_text, from_binary;
+    std::chrono::steady_clock::time_point start;
+    double text_ms, binary_ms;
+    bool ok;
+
+    if (argc == 3 && argv[1][0] != '-')
+        return convert(argv[1], argv[2]);
+
+    if (!psow::unsigned_from_args(argc, argv, "--spheres", count))
+    {
+        std::puts("Usage: example_scene_file [--spheres N]\n"
+                  "       example_scene_file IN.txt OUT.psow");
+        return -1;
+    }
+
+    make_scene(original, count);
+
+    if (!psow::write_scene_text(text_path, original) ||
+        !psow::write_scene_binary(binary_path, original))
+    {
+        std::puts("Failed to write the scene files. Aborting.");
+        return -1;
+    }
+
+    start = std::chrono::steady_clock::now();
+    ok = psow::read_scene_text(text_path, from_text);
+    text_ms = ms_since(start);
+
+    start = std::chrono::steady_clock::now();
+    ok = psow::read_scene_binary(binary_path, from_binary) && ok;
+    binary_ms = ms_since(start);
+
+    if (!ok || !same_scene(original, from_text) ||
+        !same_scene(original, from_binary))
+    {
+        std::puts("A scene read back differs from the one written.");
+        return -1;
+    }
+
+    std::printf("%u spheres\n", count);
+    std::printf("text   %10.2f ms\n", text_ms);
+    std::printf("binary %10.2f ms\n", binary_ms);
+
+#if PSOW_HAS_MMAP
+    psow::mapped_scene mapping;
+    psow::scene mapped;
+
+    start = std::chrono::steady_clock::now();
+    ok = mapping.open(binary_path, mapped);
+    const double mapped_ms = ms_since(start);
+
+    if (!ok || !same_scene(original, mapped))
+    {
+        std::puts("The mapped scene differs from the one written.");
+        return -1;
+    }
+
+    std::printf("mapped %10.2f ms\n", mapped_ms);
+#endif
+
+    return 0;
+}
+/*  End of main.                                                              */
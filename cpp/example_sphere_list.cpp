@@ -0,0 +1,186 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      This is part of a set of files I made while studying from Peter       *
+ *      Shirley's "Ray Tracing in One Weekend", Copyright 2018-2020, Peter    *
+ *      Shirley, All rights reserved. The code is my own, but follows the     *
+ *      ideas laid out in the text.                                           *
+ *                                                                            *
+ *      Renders a field of a few thousand spheres stored in a                 *
+ *      psow::sphere_list, using both the single ray and the batched nearest  *
+ *      hit queries, and checks that they agree.                              *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  std::chrono is used for timing the queries.                               */
+#include <chrono>
+
+/*  And the equivalent of stdio.h.                                            */
+#include <cstdio>
+
+/*  std::mt19937 is used to scatter the spheres.                              */
+#include <random>
+
+#include "psow_color.hpp"
+#include "psow_vec3.hpp"
+#include "psow_ray.hpp"
+#include "psow_ray_packet.hpp"
+#include "psow_sphere.hpp"
+#include "psow_sphere_list.hpp"
+#include "psow_image.hpp"
+
+/*  Function for coloring the background with a gradient.                     */
+static psow::color sky_gradient(const psow::ray &r)
+{
+    psow::vec3 v = (r.v).unit();
+    const double t = 0.5 * (v.y + 1.0);
+    psow::color sky_blue = psow::color(128U, 180U, 255U);
+    psow::color white    = psow::color(255U, 255U, 255U);
+    return (white*(1.0 - t) + sky_blue*t) * 2.0;
+}
+/*  End of sky_gradient.                                                      */
+
+/*  Shades a hit by distance, near spheres are bright red.                    */
+static psow::color shade(double t)
+{
+    const double brightness = 1.0 / (1.0 + 0.1 * t);
+    return psow::color(255U, 0U, 0U) * brightness;
+}
+/*  End of shade.                                                             */
+
+/*  Draws the spheres twice, one ray at a time and then a row of rays at a    *
+ *  time.                                                                     */
+int main(void)
+{
+    unsigned int m, n, k;
+    const unsigned int image_width  = 640U;
+    const unsigned int image_height = 360U;
+    const unsigned int number_of_spheres = 1024U;
+    const unsigned int batch = 32U;
+    const double viewport_height = 2.0;
+    const double viewport_width = viewport_height * 16.0 / 9.0;
+    const double u_factor = viewport_width / (image_width - 1U);
+    const double v_factor = viewport_height / (image_height - 1U);
+    const psow::vec3 origin = psow::vec3(0.0, 0.0, 0.0);
+
+    std::mt19937 engine(1U);
+    std::uniform_real_distribution<double> spread(-20.0, 20.0);
+    std::uniform_real_distribution<double> depth(-60.0, -2.0);
+    std::uniform_real_distribution<double> size(0.1, 0.6);
+
+    psow::sphere_list scene;
+    psow::image single(image_width, image_height);
+    psow::image batched(image_width, image_height);
+    psow::ray_packet<batch> rays;
+    double t[batch];
+    std::size_t index[batch];
+
+    scene.reserve(number_of_spheres);
+
+    for (k = 0U; k < number_of_spheres; ++k)
+    {
+        const psow::vec3 center = psow::vec3(spread(engine), spread(engine),
+                                             depth(engine));
+        scene.add(psow::sphere(size(engine), center));
+    }
+
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+
+    for (m = 0U; m < image_height; ++m)
+    {
+        const double v = 0.5 * viewport_height - m * v_factor;
+
+        for (n = 0U; n < image_width; ++n)
+        {
+            const double u = n * u_factor - 0.5 * viewport_width;
+            const psow::ray r = psow::ray(origin, psow::vec3(u, v, -1.0));
+            double t_hit;
+            std::size_t hit;
+
+            if (scene.nearest_hit(r, 0.0, 1.0E300, t_hit, hit))
+                single.set(n, m, shade(t_hit));
+            else
+                single.set(n, m, sky_gradient(r));
+        }
+    }
+
+    const std::chrono::steady_clock::time_point middle =
+        std::chrono::steady_clock::now();
+
+    for (m = 0U; m < image_height; ++m)
+    {
+        const double v = 0.5 * viewport_height - m * v_factor;
+
+        for (n = 0U; n < image_width; n += batch)
+        {
+            for (k = 0U; k < batch; ++k)
+            {
+                const double u = (n + k) * u_factor - 0.5 * viewport_width;
+                rays.set(k, psow::ray(origin, psow::vec3(u, v, -1.0)));
+            }
+
+            const psow::ray_arrays arrays = {
+                rays.px, rays.py, rays.pz, rays.vx, rays.vy, rays.vz
+            };
+
+            scene.nearest_hits(arrays, batch, 0.0, t, index);
+
+            for (k = 0U; k < batch; ++k)
+            {
+                if (index[k] != psow::sphere_list::no_hit)
+                    batched.set(n + k, m, shade(t[k]));
+                else
+                    batched.set(n + k, m, sky_gradient(rays.get(k)));
+            }
+        }
+    }
+
+    const std::chrono::steady_clock::time_point end =
+        std::chrono::steady_clock::now();
+
+    const std::chrono::duration<double> single_time = middle - start;
+    const std::chrono::duration<double> batch_time = end - middle;
+    const double tests = static_cast<double>(image_width) * image_height *
+                         number_of_spheres;
+
+    std::printf("single: %.3f s, %.1f M tests/s\n", single_time.count(),
+                1.0E-6 * tests / single_time.count());
+    std::printf("batch:  %.3f s, %.1f M tests/s\n", batch_time.count(),
+                1.0E-6 * tests / batch_time.count());
+
+    if (!single.same_pixels(batched))
+    {
+        std::puts("Single ray and batched queries disagree.");
+        return -1;
+    }
+
+    FILE *fp = std::fopen("sphere_list.ppm", "w");
+
+    if (!fp)
+    {
+        std::puts("fopen failed and returned NULL. Aborting.");
+        return -1;
+    }
+
+    single.write(fp);
+    std::fclose(fp);
+    return 0;
+}
+/*  End of main.                                                              */
@@ -0,0 +1,204 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      This is part of a set of files I made while studying from Peter       *
+ *      Shirley's "Ray Tracing in One Weekend", Copyright 2018-2020, Peter    *
+ *      Shirley, All rights reserved. The code is my own, but follows the     *
+ *      ideas laid out in the text.                                           *
+ *                                                                            *
+ *      Compares the SIMD packet kernels for ray-sphere intersection against  *
+ *      the scalar one, and times each of them, along with the portable       *
+ *      kernel written with the wide vector types at 2, 4, and 8 lanes.       *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  std::chrono is used for timing the kernels.                               */
+#include <chrono>
+
+/*  fabs is found here.                                                       */
+#include <cmath>
+
+/*  And the equivalent of stdio.h.                                            */
+#include <cstdio>
+
+/*  The packets are generated up front and stored in a std::vector.           */
+#include <vector>
+
+#include "psow_vec3.hpp"
+#include "psow_ray.hpp"
+#include "psow_ray_packet.hpp"
+#include "psow_sphere.hpp"
+#include "psow_camera.hpp"
+#include "psow_aligned_allocator.hpp"
+
+/*  Primary rays for a 960x540 image, from the default psow::camera, the one  *
+ *  of example_ray_and_sphere, are tested in packets of eight adjacent pixels.*
+ *  The image is traced several times when timing so the clock has something  *
+ *  to measure.                                                               */
+static const unsigned int image_width  = 960U;
+static const unsigned int image_height = 540U;
+static const unsigned int packet_size  = 8U;
+static const unsigned int repetitions  = 20U;
+
+/*  Type for a packet of eight rays.                                          */
+typedef psow::ray_packet<packet_size> packet;
+
+/*  The packets are 64-byte aligned, which std::allocator does not promise.   */
+typedef std::vector<packet, psow::aligned_allocator<packet> > packet_vector;
+
+/*  Creates the packets for every row of the image ahead of time, so that the *
+ *  timings only measure the kernels. The whole image is one tile.            */
+static packet_vector make_packets(void)
+{
+    const psow::camera cam(image_width, image_height);
+    psow::tile t;
+    t.x0 = 0U;
+    t.y0 = 0U;
+    t.x1 = image_width;
+    t.y1 = image_height;
+
+    const std::size_t count = psow::camera::tile_packet_count<packet_size>(t);
+    packet_vector packets(count);
+
+    cam.get_tile_packets(t, 0.5, 0.5, &packets[0]);
+    return packets;
+}
+
+/*  Returns the component arrays of a packet.                                 */
+static psow::ray_arrays arrays_of(const packet &p)
+{
+    const psow::ray_arrays arrays = {p.px, p.py, p.pz, p.vx, p.vy, p.vz};
+    return arrays;
+}
+
+/*  Runs one kernel over all of the packets and returns the number of hits.   */
+static unsigned long run_kernel(psow::sphere_packet_kernel kernel,
+                                const psow::sphere &s,
+                                const packet_vector &packets)
+{
+    std::size_t n;
+    unsigned int k;
+    unsigned long hits = 0UL;
+    double t[packet_size];
+
+    for (n = 0; n < packets.size(); ++n)
+    {
+        const unsigned int mask =
+            kernel(s.center, s.radius, arrays_of(packets[n]), packet_size, t);
+
+        for (k = 0U; k < packet_size; ++k)
+            hits += (mask >> k) & 1U;
+    }
+
+    return hits;
+}
+
+/*  Checks a kernel against the scalar code for every ray. The hit mask must  *
+ *  match intersects_ray, and t must match the scalar packet kernel.          */
+static bool check_kernel(psow::sphere_packet_kernel kernel,
+                         const psow::sphere &s,
+                         const packet_vector &packets)
+{
+    std::size_t n;
+    unsigned int k;
+    double t[packet_size], t_ref[packet_size];
+
+    for (n = 0; n < packets.size(); ++n)
+    {
+        const psow::ray_arrays arrays = arrays_of(packets[n]);
+        const unsigned int mask =
+            kernel(s.center, s.radius, arrays, packet_size, t);
+
+        psow::sphere_packet_scalar(s.center, s.radius, arrays,
+                                   packet_size, t_ref);
+
+        for (k = 0U; k < packet_size; ++k)
+        {
+            const bool hit = ((mask >> k) & 1U) != 0U;
+
+            if (hit != s.intersects_ray(packets[n].get(k)))
+                return false;
+
+            if (hit && std::fabs(t[k] - t_ref[k]) > 1.0E-12)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+/*  Checks one kernel and prints its hit count and speed.                     */
+static bool report_kernel(const char *name, psow::sphere_packet_kernel kernel,
+                          const psow::sphere &s, const packet_vector &packets)
+{
+    unsigned int n;
+    unsigned long hits = 0UL;
+    const double rays =
+        static_cast<double>(image_width) * image_height * repetitions;
+
+    if (!check_kernel(kernel, s, packets))
+    {
+        std::printf("%s kernel disagrees with intersects_ray.\n", name);
+        return false;
+    }
+
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+
+    for (n = 0U; n < repetitions; ++n)
+        hits += run_kernel(kernel, s, packets);
+
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    std::printf("%-7s %lu hits, %.1f Mrays/s\n", name,
+                hits / repetitions, 1.0E-6 * rays / elapsed.count());
+    return true;
+}
+/*  End of report_kernel.                                                     */
+
+/*  Checks and times every kernel this CPU can run, then the portable one     *
+ *  written with the wide vector types.                                       */
+int main(void)
+{
+    unsigned int level;
+    const psow::sphere s = psow::sphere(0.5, psow::vec3(0, 0, -1));
+    const packet_vector packets = make_packets();
+    const unsigned int best = psow::detect_simd_level();
+
+    std::printf("Widest instruction set: %s\n",
+                psow::simd_level_name(psow::detect_simd_level()));
+
+    for (level = psow::simd_scalar; level <= best; ++level)
+    {
+        const psow::simd_level l = static_cast<psow::simd_level>(level);
+
+        if (!report_kernel(psow::simd_level_name(l),
+                           psow::select_sphere_packet_kernel(l), s, packets))
+            return -1;
+    }
+
+    if (!report_kernel("wide2", psow::sphere_packet_wide<2U>, s, packets) ||
+        !report_kernel("wide4", psow::sphere_packet_wide<4U>, s, packets) ||
+        !report_kernel("wide8", psow::sphere_packet_wide<8U>, s, packets))
+        return -1;
+
+    return 0;
+}
+/*  End of main.                                                              */
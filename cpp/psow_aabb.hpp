@@ -0,0 +1,170 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides a struct for axis-aligned bounding boxes.                    *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_AABB_HPP
+#define PSOW_AABB_HPP
+
+/*  std::numeric_limits, used for empty boxes.                                */
+#include <limits>
+
+/*  vec3 struct provided here.                                                */
+#include "psow_vec3.hpp"
+
+/*  ray struct given here.                                                    */
+#include "psow_ray.hpp"
+
+/*  sphere struct, for computing the box around a sphere.                     */
+#include "psow_sphere.hpp"
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  An axis-aligned box [lo.x, hi.x] x [lo.y, hi.y] x [lo.z, hi.z].       */
+    struct aabb {
+        vec3 lo, hi;
+
+        /*  Empty constructor. The box is empty, lo > hi, so growing it by    *
+         *  anything gives that thing's box.                                  */
+        inline aabb(void)
+        {
+            const double big = std::numeric_limits<double>::max();
+            lo = vec3(big, big, big);
+            hi = vec3(-big, -big, -big);
+        }
+
+        /*  Constructor from the two extreme corners.                         */
+        inline aabb(const vec3 &a, const vec3 &b)
+        {
+            lo = a;
+            hi = b;
+        }
+
+        /*  The smallest box containing a sphere.                             */
+        static inline aabb from_sphere(const sphere &s);
+
+        /*  Enlarges the box to contain a point.                              */
+        inline void grow(const vec3 &p);
+
+        /*  Enlarges the box to contain another box.                          */
+        inline void grow(const aabb &b);
+
+        /*  Center of the box.                                                */
+        inline vec3 centroid(void) const;
+
+        /*  Surface area of the box. Empty boxes have zero area.              */
+        inline double surface_area(void) const;
+
+        /*  Slab test. rcpr_v holds 1/v for the direction v of the ray r,     *
+         *  precomputed once per ray. Returns the parameter where the ray     *
+         *  enters the box, clipped to [t_min, t_max], or infinity if it      *
+         *  misses.                                                           */
+        inline double entry(const ray &r, const vec3 &rcpr_v,
+                            double t_min, double t_max) const;
+    };
+    /*  End of aabb definition.                                               */
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  The box extends one radius from the center in each direction.             */
+inline psow::aabb psow::aabb::from_sphere(const psow::sphere &s)
+{
+    const psow::vec3 r = psow::vec3(s.radius, s.radius, s.radius);
+    return psow::aabb(s.center - r, s.center + r);
+}
+
+/*  Take componentwise minima and maxima.                                     */
+inline void psow::aabb::grow(const psow::vec3 &p)
+{
+    lo.x = (p.x < lo.x ? p.x : lo.x);
+    lo.y = (p.y < lo.y ? p.y : lo.y);
+    lo.z = (p.z < lo.z ? p.z : lo.z);
+    hi.x = (p.x > hi.x ? p.x : hi.x);
+    hi.y = (p.y > hi.y ? p.y : hi.y);
+    hi.z = (p.z > hi.z ? p.z : hi.z);
+}
+
+/*  Minima of the lower corners and maxima of the upper ones. Growing by an   *
+ *  empty box leaves the box unchanged.                                       */
+inline void psow::aabb::grow(const psow::aabb &b)
+{
+    lo.x = (b.lo.x < lo.x ? b.lo.x : lo.x);
+    lo.y = (b.lo.y < lo.y ? b.lo.y : lo.y);
+    lo.z = (b.lo.z < lo.z ? b.lo.z : lo.z);
+    hi.x = (b.hi.x > hi.x ? b.hi.x : hi.x);
+    hi.y = (b.hi.y > hi.y ? b.hi.y : hi.y);
+    hi.z = (b.hi.z > hi.z ? b.hi.z : hi.z);
+}
+
+/*  Midpoint of the two corners.                                              */
+inline psow::vec3 psow::aabb::centroid(void) const
+{
+    return (lo + hi) * 0.5;
+}
+
+/*  Twice the sum of the areas of three faces meeting at a corner.            */
+inline double psow::aabb::surface_area(void) const
+{
+    const psow::vec3 d = hi - lo;
+
+    if (d.x < 0.0 || d.y < 0.0 || d.z < 0.0)
+        return 0.0;
+
+    return 2.0 * (d.x*d.y + d.y*d.z + d.z*d.x);
+}
+
+/*  Intersect the intervals where the ray lies between each pair of planes.   */
+inline double psow::aabb::entry(const psow::ray &r, const psow::vec3 &rcpr_v,
+                                double t_min, double t_max) const
+{
+    const double tx0 = (lo.x - r.p.x) * rcpr_v.x;
+    const double tx1 = (hi.x - r.p.x) * rcpr_v.x;
+    const double ty0 = (lo.y - r.p.y) * rcpr_v.y;
+    const double ty1 = (hi.y - r.p.y) * rcpr_v.y;
+    const double tz0 = (lo.z - r.p.z) * rcpr_v.z;
+    const double tz1 = (hi.z - r.p.z) * rcpr_v.z;
+
+    const double x_near = (tx0 < tx1 ? tx0 : tx1);
+    const double x_far  = (tx0 < tx1 ? tx1 : tx0);
+    const double y_near = (ty0 < ty1 ? ty0 : ty1);
+    const double y_far  = (ty0 < ty1 ? ty1 : ty0);
+    const double z_near = (tz0 < tz1 ? tz0 : tz1);
+    const double z_far  = (tz0 < tz1 ? tz1 : tz0);
+
+    double near = (x_near > y_near ? x_near : y_near);
+    double far  = (x_far < y_far ? x_far : y_far);
+
+    near = (z_near > near ? z_near : near);
+    far  = (z_far < far ? z_far : far);
+    near = (t_min > near ? t_min : near);
+    far  = (t_max < far ? t_max : far);
+
+    if (near > far)
+        return std::numeric_limits<double>::infinity();
+
+    return near;
+}
+/*  End of entry.                                                             */
+
+#endif
+/*  End of include guard.                                                     */
@@ -0,0 +1,358 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides a floating-point buffer for accumulating samples of linear   *
+ *      radiance, and the tonemap pass that turns it into an 8-bit image.     *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_ACCUMULATOR_HPP
+#define PSOW_ACCUMULATOR_HPP
+
+/*  std::pow and std::sqrt, used for gamma correction.                        */
+#include <cmath>
+
+/*  std::size_t is found here.                                                */
+#include <cstddef>
+
+/*  std::numeric_limits, the largest finite float.                            */
+#include <limits>
+
+/*  std::vector, used for the channels.                                       */
+#include <vector>
+
+/*  The channels are stored in cache-line aligned arrays.                     */
+#include "psow_aligned_allocator.hpp"
+
+/*  The 8-bit output of the tonemap.                                          */
+#include "psow_image.hpp"
+
+/*  tile and default_tile_size.                                               */
+#include "psow_renderer.hpp"
+
+/*  Samples are given as rgb triples.                                         */
+#include "psow_rgb.hpp"
+
+/*  Both passes can be spread over a thread pool.                             */
+#include "psow_thread_pool.hpp"
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  Running sums of radiance samples, one channel per array so the tonemap*
+     *  loops run over contiguous floats. weight holds the number of samples  *
+     *  taken in each pixel. Floats hold 24 bits, and each add to a sum of N  *
+     *  samples rounds by up to half an ulp of it, so the relative error      *
+     *  grows with the count: typically near sqrt(N) * 2^-24, at worst about  *
+     *  N * 2^-24, or 2.4e-4 after 4096 samples. That is still well below the *
+     *  1/255 step of the tonemapped bytes.                                   */
+    struct accumulator {
+        typedef std::vector<float, aligned_allocator<float> > array;
+
+        unsigned int width, height;
+        array r, g, b, weight;
+
+        /*  Empty constructor, a buffer with no pixels.                       */
+        inline accumulator(void);
+
+        /*  Constructor from the dimensions. Every sum starts at zero.        */
+        inline accumulator(unsigned int w, unsigned int h);
+
+        /*  Resets every sum and weight to zero.                              */
+        inline void clear(void);
+
+        /*  Adds a sample to the pixel in column x, row y. Row zero is the top*
+         *  row of the image.                                                 */
+        inline void add(unsigned int x, unsigned int y, const rgb &sample);
+
+        /*  Returns the mean of the samples in a pixel, black if it has none. */
+        inline rgb mean(unsigned int x, unsigned int y) const;
+    };
+    /*  End of accumulator definition.                                        */
+
+    /*  Curves mapping linear radiance in [0, infinity) to [0, 1].            */
+    enum tonemap_curve {
+
+        /*  Values above one are clipped to white.                            */
+        tonemap_clamp,
+
+        /*  Reinhard's v / (1 + v), compresses highlights instead of clipping.*/
+        tonemap_reinhard
+    };
+
+    /*  Parameters for the tonemap pass. The mean radiance of a pixel is      *
+     *  multiplied by exposure, mapped by the curve, raised to 1 / gamma, and *
+     *  rounded to 8 bits. A gamma of 2, the default, is computed with a      *
+     *  square root instead of pow.                                           */
+    struct tonemap_options {
+        float exposure;
+        float gamma;
+        tonemap_curve curve;
+
+        /*  Unit exposure, gamma 2, clamping.                                 */
+        inline tonemap_options(void)
+            : exposure(1.0F), gamma(2.0F), curve(tonemap_clamp)
+        {
+            return;
+        }
+    };
+
+    /*  Adds one sample to every pixel of the buffer. shader(x, y) returns an *
+     *  rgb and must be safe to call from several threads at once.            */
+    template <class shader_type>
+    inline void
+    accumulate(accumulator &acc, const shader_type &shader, thread_pool &pool,
+               unsigned int tile_size = default_tile_size);
+
+    /*  Tonemaps one row of the buffer into 3 * acc.width bytes of RGB.       *
+     *  Sums of +inf come out white, as the largest float does, and NaN and   *
+     *  -inf come out black, as zero does.                                   */
+    inline void tonemap_row(const accumulator &acc, unsigned int y,
+                            const tonemap_options &options,
+                            unsigned char *out);
+
+    /*  Same as above, using the caller's scratch space of 3 * acc.width      *
+     *  floats rather than allocating it, so that it can be reused from one   *
+     *  row to the next.                                                      */
+    inline void tonemap_row(const accumulator &acc, unsigned int y,
+                            const tonemap_options &options,
+                            unsigned char *out, float *scratch);
+
+    /*  Tonemaps the whole buffer into an image of the same size.             */
+    inline void tonemap(const accumulator &acc, image &img,
+                        const tonemap_options &options = tonemap_options());
+
+    /*  Same as above, with the rows spread over a thread pool.               */
+    inline void tonemap(const accumulator &acc, image &img, thread_pool &pool,
+                        const tonemap_options &options = tonemap_options());
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  An empty buffer has no pixels.                                            */
+inline psow::accumulator::accumulator(void) : width(0U), height(0U)
+{
+    return;
+}
+
+/*  std::vector zero-initializes the floats.                                  */
+inline psow::accumulator::accumulator(unsigned int w, unsigned int h)
+    : width(w), height(h),
+      r(static_cast<std::size_t>(w) * h), g(static_cast<std::size_t>(w) * h),
+      b(static_cast<std::size_t>(w) * h),
+      weight(static_cast<std::size_t>(w) * h)
+{
+    return;
+}
+
+/*  Zero out every array, keeping the memory.                                 */
+inline void psow::accumulator::clear(void)
+{
+    std::size_t n;
+
+    for (n = 0; n < weight.size(); ++n)
+    {
+        r[n] = 0.0F;
+        g[n] = 0.0F;
+        b[n] = 0.0F;
+        weight[n] = 0.0F;
+    }
+}
+
+/*  The sample is rounded to float once, then summed.                         */
+inline void
+psow::accumulator::add(unsigned int x, unsigned int y, const rgb &sample)
+{
+    const std::size_t n = static_cast<std::size_t>(y) * width + x;
+
+    r[n] += static_cast<float>(sample.r);
+    g[n] += static_cast<float>(sample.g);
+    b[n] += static_cast<float>(sample.b);
+    weight[n] += 1.0F;
+}
+
+/*  Divide the sums by the number of samples.                                 */
+inline psow::rgb psow::accumulator::mean(unsigned int x, unsigned int y) const
+{
+    const std::size_t n = static_cast<std::size_t>(y) * width + x;
+
+    if (weight[n] == 0.0F)
+        return rgb(0.0, 0.0, 0.0);
+
+    const double scale = 1.0 / static_cast<double>(weight[n]);
+    return rgb(r[n] * scale, g[n] * scale, b[n] * scale);
+}
+
+/*  Each tile adds to a disjoint set of pixels, so no locking is needed.      */
+template <class shader_type>
+inline void
+psow::accumulate(accumulator &acc, const shader_type &shader,
+                 thread_pool &pool, unsigned int tile_size)
+{
+    unsigned int x, y;
+
+    if (tile_size == 0U)
+        tile_size = default_tile_size;
+
+    for (y = 0U; y < acc.height; y += tile_size)
+    {
+        for (x = 0U; x < acc.width; x += tile_size)
+        {
+            tile t;
+            t.x0 = x;
+            t.y0 = y;
+            t.x1 = (x + tile_size < acc.width ? x + tile_size : acc.width);
+            t.y1 = (y + tile_size < acc.height ? y + tile_size : acc.height);
+
+            pool.submit([&acc, &shader, t]() {
+                unsigned int px, py;
+
+                for (py = t.y0; py < t.y1; ++py)
+                    for (px = t.x0; px < t.x1; ++px)
+                        acc.add(px, py, shader(px, py));
+            });
+        }
+    }
+
+    pool.wait();
+}
+/*  End of accumulate.                                                        */
+
+/*  A one-off row allocates its own scratch space.                            */
+inline void psow::tonemap_row(const accumulator &acc, unsigned int y,
+                              const tonemap_options &options,
+                              unsigned char *out)
+{
+    if (acc.width == 0U)
+        return;
+
+    std::vector<float, aligned_allocator<float> > row(3UL * acc.width);
+    tonemap_row(acc, y, options, out, &row[0]);
+}
+
+/*  The row is processed in stages so that each loop is a straight run over   *
+ *  contiguous floats with no branches, which the compiler vectorizes. The    *
+ *  choice of curve and gamma is made once per row, outside the loops. Only   *
+ *  the last loop, interleaving the channels into bytes, runs on scalars.     */
+inline void psow::tonemap_row(const accumulator &acc, unsigned int y,
+                              const tonemap_options &options,
+                              unsigned char *out, float *scratch)
+{
+    unsigned int x, c;
+    const unsigned int w = acc.width;
+    const std::size_t start = static_cast<std::size_t>(y) * w;
+    const float exposure = options.exposure;
+    const float inverse_gamma = 1.0F / options.gamma;
+    const float largest = std::numeric_limits<float>::max();
+
+    if (w == 0U)
+        return;
+
+    float * const channel[3] = {scratch, scratch + w, scratch + 2UL * w};
+    const float * const sum[3] = {&acc.r[start], &acc.g[start],
+                                  &acc.b[start]};
+    const float * const weight = &acc.weight[start];
+
+    for (c = 0U; c < 3U; ++c)
+    {
+        float * const v = channel[c];
+        const float * const s = sum[c];
+
+        /*  Mean times exposure. Pixels without samples come out black. NaN   *
+         *  fails the first comparison and infinity the second, so both leave *
+         *  this loop finite, and the Reinhard curve cannot turn an infinity  *
+         *  into inf / inf.                                                   */
+        for (x = 0U; x < w; ++x)
+        {
+            const float n = (weight[x] > 0.0F ? weight[x] : 1.0F);
+            const float value = s[x] * (exposure / n);
+            const float positive = (value > 0.0F ? value : 0.0F);
+            v[x] = (positive < largest ? positive : largest);
+        }
+
+        if (options.curve == tonemap_reinhard)
+            for (x = 0U; x < w; ++x)
+                v[x] = v[x] / (1.0F + v[x]);
+        else
+            for (x = 0U; x < w; ++x)
+                v[x] = (v[x] < 1.0F ? v[x] : 1.0F);
+
+        if (options.gamma == 2.0F)
+            for (x = 0U; x < w; ++x)
+                v[x] = std::sqrt(v[x]);
+        else if (options.gamma != 1.0F)
+            for (x = 0U; x < w; ++x)
+                v[x] = std::pow(v[x], inverse_gamma);
+
+        /*  Truncating v * 255 + 0.5 rounds values in [0, 1]. A gamma that is *
+         *  zero, negative, or NaN can still leave values outside that range, *
+         *  so they are clamped to it first, NaN to zero, as converting a     *
+         *  float out of the range of unsigned char is undefined.             */
+        for (x = 0U; x < w; ++x)
+        {
+            const float positive = (v[x] > 0.0F ? v[x] : 0.0F);
+            v[x] = (positive < 1.0F ? positive : 1.0F) * 255.0F + 0.5F;
+        }
+    }
+
+    for (x = 0U; x < w; ++x)
+    {
+        out[3U * x]      = static_cast<unsigned char>(channel[0][x]);
+        out[3U * x + 1U] = static_cast<unsigned char>(channel[1][x]);
+        out[3U * x + 2U] = static_cast<unsigned char>(channel[2][x]);
+    }
+}
+/*  End of tonemap_row.                                                       */
+
+/*  Rows of the image are contiguous, so each row is tonemapped in place.     */
+inline void psow::tonemap(const accumulator &acc, image &img,
+                          const tonemap_options &options)
+{
+    unsigned int y;
+
+    if (acc.width == 0U)
+        return;
+
+    std::vector<float, aligned_allocator<float> > row(3UL * acc.width);
+
+    for (y = 0U; y < acc.height; ++y)
+        tonemap_row(acc, y, options, img.pixels + 3UL * y * img.width,
+                    &row[0]);
+}
+
+/*  Same as above, a chunk of rows per task, each with one scratch row.       */
+inline void psow::tonemap(const accumulator &acc, image &img,
+                          thread_pool &pool, const tonemap_options &options)
+{
+    if (acc.width == 0U)
+        return;
+
+    parallel_for(pool, acc.height,
+                 [&acc, &img, &options](std::size_t begin, std::size_t end) {
+        std::size_t y;
+        std::vector<float, aligned_allocator<float> > row(3UL * acc.width);
+
+        for (y = begin; y < end; ++y)
+            tonemap_row(acc, static_cast<unsigned int>(y), options,
+                        img.pixels + 3UL * y * img.width, &row[0]);
+    });
+}
+
+#endif
+/*  End of include guard.                                                     */
@@ -0,0 +1,314 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides adaptive sampling, which keeps adding samples to the pixels  *
+ *      whose estimated noise is above a threshold and leaves the rest alone. *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_ADAPTIVE_HPP
+#define PSOW_ADAPTIVE_HPP
+
+/*  std::atomic, used to count the samples taken by all threads.              */
+#include <atomic>
+
+/*  std::size_t is found here.                                                */
+#include <cstddef>
+
+/*  std::vector, used for the per-pixel statistics and the tile list.         */
+#include <vector>
+
+/*  The buffer the samples are accumulated in.                                */
+#include "psow_accumulator.hpp"
+
+/*  The statistics are stored in cache-line aligned arrays.                   */
+#include "psow_aligned_allocator.hpp"
+
+/*  pixel_sample and sequence_sample, the sample positions in a pixel.        */
+#include "psow_progressive.hpp"
+
+/*  tile and default_tile_size.                                               */
+#include "psow_renderer.hpp"
+
+/*  Samples are rgb triples.                                                  */
+#include "psow_rgb.hpp"
+
+/*  The passes are spread over a thread pool.                                 */
+#include "psow_thread_pool.hpp"
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  Parameters for an adaptive render.                                    */
+    struct adaptive_options {
+
+        /*  Samples every pixel gets before its noise is estimated. At least  *
+         *  two are needed for a variance, small values risk stopping early   *
+         *  on pixels where every sample happened to agree.                   */
+        unsigned int min_samples;
+
+        /*  No pixel gets more than this many samples.                        */
+        unsigned int max_samples;
+
+        /*  Samples added to each unconverged pixel per pass.                 */
+        unsigned int samples_per_pass;
+
+        /*  A pixel has converged once the standard error of its mean         *
+         *  luminance is below noise_threshold times the mean. Means darker   *
+         *  than dark_level are treated as dark_level, so black pixels do not *
+         *  demand an impossible absolute precision.                          */
+        float noise_threshold;
+        float dark_level;
+
+        /*  Where the samples of each pixel are taken.                        */
+        sample_sequence sequence;
+
+        /*  Eight to 256 samples on the R2 sequence, 1% noise.                */
+        inline adaptive_options(void)
+            : min_samples(8U), max_samples(256U), samples_per_pass(8U),
+              noise_threshold(0.01F), dark_level(0.05F),
+              sequence(sequence_r2)
+        {
+            return;
+        }
+    };
+
+    /*  Statistics returned by render_adaptive.                               */
+    struct adaptive_result {
+
+        /*  Passes over the tiles that still had unconverged pixels.          */
+        unsigned int passes;
+
+        /*  Samples taken, over all pixels.                                   */
+        unsigned long long samples;
+
+        /*  Pixels that reached max_samples without converging.               */
+        unsigned long long unconverged;
+    };
+
+    /*  Running mean and variance of the luminance of each pixel, updated with*
+     *  Welford's method, which does not lose precision to cancellation the   *
+     *  way sums of squares in float do.                                      */
+    struct variance_buffer {
+        typedef std::vector<float, aligned_allocator<float> > array;
+
+        unsigned int width, height;
+
+        /*  Mean luminance, and the sum of squared deviations from it.        */
+        array mean, m2;
+
+        /*  Constructor from the dimensions. Everything starts at zero.       */
+        inline variance_buffer(unsigned int w, unsigned int h);
+
+        /*  Adds the luminance of a sample, n being the new sample count.     */
+        inline void add(std::size_t pixel, float luminance, float n);
+
+        /*  Returns true if the pixel, with n samples, meets the threshold.   */
+        inline bool converged(std::size_t pixel, float n,
+                              const adaptive_options &options) const;
+    };
+
+    /*  Relative luminance of linear sRGB (Rec. 709 weights).                 */
+    inline float luminance(const rgb &c);
+
+    /*  Samples the image into acc, spending the samples where they reduce the*
+     *  noise the most. shader(x, y, s) is called as for render_progressive.  *
+     *  Tiles whose pixels have all converged are dropped from later passes,  *
+     *  and within a tile converged pixels are skipped. acc should be empty.  */
+    template <class shader_type>
+    inline adaptive_result
+    render_adaptive(accumulator &acc, const shader_type &shader,
+                    thread_pool &pool, const adaptive_options &options,
+                    unsigned int tile_size = default_tile_size);
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  std::vector zero-initializes the floats.                                  */
+inline psow::variance_buffer::variance_buffer(unsigned int w, unsigned int h)
+    : width(w), height(h),
+      mean(static_cast<std::size_t>(w) * h),
+      m2(static_cast<std::size_t>(w) * h)
+{
+    return;
+}
+
+/*  Welford's update: move the mean toward the sample by 1/n of the distance, *
+ *  and add the product of the deviations before and after the move.          */
+inline void
+psow::variance_buffer::add(std::size_t pixel, float luminance, float n)
+{
+    const float delta = luminance - mean[pixel];
+    mean[pixel] += delta / n;
+    m2[pixel] += delta * (luminance - mean[pixel]);
+}
+
+/*  The variance of the mean is the sample variance m2 / (n - 1) divided by n.*
+ *  Compare squares to avoid the square root.                                 */
+inline bool
+psow::variance_buffer::converged(std::size_t pixel, float n,
+                                 const adaptive_options &options) const
+{
+    const float level = (mean[pixel] > options.dark_level ?
+                         mean[pixel] : options.dark_level);
+    const float tolerance = options.noise_threshold * level;
+    const float error_sq = m2[pixel] / ((n - 1.0F) * n);
+
+    return error_sq <= tolerance * tolerance;
+}
+
+/*  Rec. 709 weights, green dominates perceived brightness.                   */
+inline float psow::luminance(const rgb &c)
+{
+    return static_cast<float>(0.2126 * c.r + 0.7152 * c.g + 0.0722 * c.b);
+}
+
+/*  Every pass runs the active tiles on the pool. A tile visits each of its   *
+ *  pixels that is still open, adds a batch of samples, and re-tests it. The  *
+ *  tile stays active for the next pass if any of its pixels is still open.   */
+template <class shader_type>
+inline psow::adaptive_result
+psow::render_adaptive(accumulator &acc, const shader_type &shader,
+                      thread_pool &pool, const adaptive_options &options,
+                      unsigned int tile_size)
+{
+    unsigned int x, y;
+    std::size_t n;
+    std::vector<tile> active, next;
+    variance_buffer stats(acc.width, acc.height);
+    std::atomic<unsigned long long> samples(0ULL);
+    std::atomic<unsigned long long> unconverged(0ULL);
+    adaptive_result result;
+
+    /*  At least two samples are needed to estimate a variance.               */
+    const unsigned int min_samples =
+        (options.min_samples < 2U ? 2U : options.min_samples);
+    const unsigned int max_samples =
+        (options.max_samples < min_samples ? min_samples : options.max_samples);
+    const unsigned int batch =
+        (options.samples_per_pass == 0U ? 1U : options.samples_per_pass);
+
+    /*  Pixels still taking samples. Only a pixel's own tile touches its flag.*/
+    std::vector<unsigned char> open(
+        static_cast<std::size_t>(acc.width) * acc.height, 1U
+    );
+
+    if (tile_size == 0U)
+        tile_size = default_tile_size;
+
+    for (y = 0U; y < acc.height; y += tile_size)
+    {
+        for (x = 0U; x < acc.width; x += tile_size)
+        {
+            const unsigned int right = acc.width - x;
+            const unsigned int below = acc.height - y;
+            tile t;
+            t.x0 = x;
+            t.y0 = y;
+            t.x1 = (right < tile_size ? acc.width : x + tile_size);
+            t.y1 = (below < tile_size ? acc.height : y + tile_size);
+            active.push_back(t);
+        }
+    }
+
+    result.passes = 0U;
+
+    while (!active.empty())
+    {
+        const unsigned int count = (result.passes == 0U ? min_samples : batch);
+        std::vector<unsigned char> still_open(active.size(), 0U);
+
+        for (n = 0; n < active.size(); ++n)
+        {
+            pool.submit([&, n, count]() {
+                const tile &t = active[n];
+                unsigned int px, py, k;
+                unsigned long long taken = 0ULL, stuck = 0ULL;
+                bool any_open = false;
+
+                for (py = t.y0; py < t.y1; ++py)
+                {
+                    for (px = t.x0; px < t.x1; ++px)
+                    {
+                        const std::size_t pixel =
+                            static_cast<std::size_t>(py) * acc.width + px;
+                        const unsigned int seed = pixel_seed(px, py);
+
+                        if (!open[pixel])
+                            continue;
+
+                        for (k = 0U; k < count; ++k)
+                        {
+                            const unsigned int index =
+                                static_cast<unsigned int>(acc.weight[pixel]);
+
+                            if (index >= max_samples)
+                                break;
+
+                            const rgb c = shader(px, py, sequence_sample(
+                                options.sequence, seed, index
+                            ));
+
+                            acc.add(px, py, c);
+                            stats.add(pixel, luminance(c), acc.weight[pixel]);
+                            ++taken;
+                        }
+
+                        const float weight = acc.weight[pixel];
+
+                        if (stats.converged(pixel, weight, options))
+                            open[pixel] = 0U;
+
+                        else if (weight >= static_cast<float>(max_samples))
+                        {
+                            open[pixel] = 0U;
+                            ++stuck;
+                        }
+
+                        else
+                            any_open = true;
+                    }
+                }
+
+                still_open[n] = any_open;
+                samples.fetch_add(taken, std::memory_order_relaxed);
+                unconverged.fetch_add(stuck, std::memory_order_relaxed);
+            });
+        }
+
+        pool.wait();
+        ++result.passes;
+
+        next.clear();
+
+        for (n = 0; n < active.size(); ++n)
+            if (still_open[n])
+                next.push_back(active[n]);
+
+        active.swap(next);
+    }
+
+    result.samples = samples.load();
+    result.unconverged = unconverged.load();
+    return result;
+}
+/*  End of render_adaptive.                                                   */
+
+#endif
+/*  End of include guard.                                                     */
@@ -0,0 +1,123 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides an allocator for std::vector with a fixed minimum alignment. *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_ALIGNED_ALLOCATOR_HPP
+#define PSOW_ALIGNED_ALLOCATOR_HPP
+
+/*  std::size_t is found here.                                                */
+#include <cstddef>
+
+/*  std::bad_alloc, thrown when the allocation fails like std::allocator.     */
+#include <new>
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  Alignment of a cache line, and of the widest (AVX-512) registers.     */
+    const std::size_t cache_line_size = 64;
+
+    /*  Allocator handing out memory aligned to "alignment" bytes. Used so    *
+     *  that arrays of doubles can be read with aligned vector loads and never*
+     *  straddle cache lines at the start.                                    */
+    template <class T, std::size_t alignment = cache_line_size>
+    struct aligned_allocator {
+        static_assert((alignment & (alignment - 1)) == 0 &&
+                      alignment >= sizeof(void *),
+                      "alignment must be a power of two, at least a pointer");
+
+        typedef T value_type;
+
+        /*  Allows std::vector to rebind the allocator to other types.        */
+        template <class U>
+        struct rebind {
+            typedef aligned_allocator<U, alignment> other;
+        };
+
+        /*  Empty constructor. The allocator has no state.                    */
+        inline aligned_allocator(void)
+        {
+            return;
+        }
+
+        /*  Conversion from an allocator for another type.                    */
+        template <class U>
+        inline aligned_allocator(const aligned_allocator<U, alignment> &)
+        {
+            return;
+        }
+
+        /*  Allocates room for n objects of type T.                           */
+        inline T *allocate(std::size_t n);
+
+        /*  Frees memory obtained from allocate.                              */
+        inline void deallocate(T *p, std::size_t n);
+    };
+    /*  End of aligned_allocator definition.                                  */
+
+    /*  The allocator has no state, so all instances compare equal.           */
+    template <class T, class U, std::size_t alignment>
+    inline bool operator == (const aligned_allocator<T, alignment> &,
+                             const aligned_allocator<U, alignment> &)
+    {
+        return true;
+    }
+
+    template <class T, class U, std::size_t alignment>
+    inline bool operator != (const aligned_allocator<T, alignment> &,
+                             const aligned_allocator<U, alignment> &)
+    {
+        return false;
+    }
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  Over-allocate by the alignment, round the pointer up, and stash the       *
+ *  pointer returned by operator new just before the aligned block so         *
+ *  deallocate can find it.                                                   */
+template <class T, std::size_t alignment>
+inline T *psow::aligned_allocator<T, alignment>::allocate(std::size_t n)
+{
+    const std::size_t bytes = n * sizeof(T) + alignment + sizeof(void *);
+    char * const raw = static_cast<char *>(::operator new(bytes));
+    const std::size_t address = reinterpret_cast<std::size_t>(raw) +
+                                sizeof(void *);
+    const std::size_t aligned = (address + alignment - 1) &
+                                ~(alignment - 1);
+    void ** const out = reinterpret_cast<void **>(aligned);
+
+    out[-1] = raw;
+    return reinterpret_cast<T *>(out);
+}
+
+/*  Recover the original pointer and release it.                              */
+template <class T, std::size_t alignment>
+inline void psow::aligned_allocator<T, alignment>::deallocate(T *p,
+                                                             std::size_t)
+{
+    if (p)
+        ::operator delete(reinterpret_cast<void **>(p)[-1]);
+}
+
+#endif
+/*  End of include guard.                                                     */
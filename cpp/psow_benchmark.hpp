@@ -0,0 +1,297 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides a small harness for timing code and reporting the results   *
+ *      as a table or as JSON.                                                *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_BENCHMARK_HPP
+#define PSOW_BENCHMARK_HPP
+
+/*  std::sort, used to find the median time.                                  */
+#include <algorithm>
+
+/*  std::chrono::steady_clock does the timing.                                */
+#include <chrono>
+
+/*  fprintf, the results are written to a FILE pointer.                       */
+#include <cstdio>
+
+/*  std::string holds the names of the benchmarks.                            */
+#include <string>
+
+/*  std::vector, used for the list of results and the repetition times.       */
+#include <vector>
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  How a benchmark is run. The body is first run warmup_runs times       *
+     *  untimed, which also calibrates how many times it must run in a row to *
+     *  last min_seconds. That batch is then timed repetitions times, and the *
+     *  median and the fastest batch are reported.                            */
+    struct benchmark_options {
+        unsigned int warmup_runs;
+        unsigned int repetitions;
+        double min_seconds;
+
+        /*  Two warmups, seven repetitions of at least 50 milliseconds.       */
+        inline benchmark_options(void)
+            : warmup_runs(2U), repetitions(7U), min_seconds(0.05)
+        {
+            return;
+        }
+    };
+
+    /*  Timing of one benchmark. Every run of the body processes "items"      *
+     *  things, counted in "unit", such as rays or pixels.                    */
+    struct benchmark_result {
+        std::string name;
+        std::string unit;
+        double items;
+
+        /*  Runs of the body per timed batch, and the number of batches.      */
+        unsigned long runs_per_batch;
+        unsigned int repetitions;
+
+        /*  Seconds per run of the body, median and fastest over the batches. */
+        double median_seconds;
+        double best_seconds;
+
+        /*  Nanoseconds per item, from the median.                            */
+        inline double ns_per_item(void) const;
+
+        /*  Items per second, from the median.                                */
+        inline double items_per_second(void) const;
+    };
+
+    /*  Times body(), which processes items things per call.                  */
+    template <class body_type>
+    inline benchmark_result
+    run_benchmark(const std::string &name, const std::string &unit,
+                  double items, const body_type &body,
+                  const benchmark_options &options = benchmark_options());
+
+    /*  Keeps the compiler from discarding a value that is otherwise unused.  */
+    template <class T>
+    inline void do_not_optimize(const T &value);
+
+    /*  Fixed-seed generator (SplitMix64) for benchmark inputs. Unlike the    *
+     *  <random> distributions its output is the same on every platform, so   *
+     *  every build is measured on the same data.                             */
+    struct benchmark_rng {
+        unsigned long long state;
+
+        /*  Constructor from the seed.                                        */
+        inline explicit benchmark_rng(unsigned long long seed);
+
+        /*  Next 64 random bits.                                              */
+        inline unsigned long long next(void);
+
+        /*  Uniform double in [lo, hi).                                       */
+        inline double uniform(double lo, double hi);
+    };
+
+    /*  Prints the results as an aligned table.                               */
+    inline void print_benchmarks(FILE *fp,
+                                 const std::vector<benchmark_result> &results);
+
+    /*  Writes the results as JSON. context holds extra "key": value pairs    *
+     *  for the top-level "context" object, already formatted, values quoted  *
+     *  as needed. Returns false if writing failed.                           */
+    inline bool
+    write_benchmark_json(FILE *fp,
+                         const std::vector<benchmark_result> &results,
+                         const std::vector<std::string> &context);
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  Median seconds per run, divided by the items in a run.                    */
+inline double psow::benchmark_result::ns_per_item(void) const
+{
+    return median_seconds * 1.0E9 / items;
+}
+
+/*  The inverse of the above, scaled to seconds.                              */
+inline double psow::benchmark_result::items_per_second(void) const
+{
+    return items / median_seconds;
+}
+
+/*  Warm up, calibrate, then time whole batches so the clock is read only     *
+ *  twice per batch, however cheap the body is.                               */
+template <class body_type>
+inline psow::benchmark_result
+psow::run_benchmark(const std::string &name, const std::string &unit,
+                    double items, const body_type &body,
+                    const benchmark_options &options)
+{
+    typedef std::chrono::steady_clock clock;
+
+    unsigned int n;
+    unsigned long k;
+    std::vector<double> seconds;
+    double warmup_seconds = 0.0;
+    benchmark_result result;
+
+    /*  At least one batch is needed for a median.                            */
+    const unsigned int repetitions =
+        (options.repetitions == 0U ? 1U : options.repetitions);
+
+    for (n = 0U; n < options.warmup_runs; ++n)
+    {
+        const clock::time_point start = clock::now();
+        body();
+        warmup_seconds = std::chrono::duration<double>(
+            clock::now() - start
+        ).count();
+    }
+
+    /*  Enough runs per batch to last min_seconds, judged by the last warmup. */
+    result.runs_per_batch = 1UL;
+
+    if (warmup_seconds > 0.0 && warmup_seconds < options.min_seconds)
+    {
+        const double runs = options.min_seconds / warmup_seconds;
+        result.runs_per_batch = static_cast<unsigned long>(runs) + 1UL;
+    }
+
+    for (n = 0U; n < repetitions; ++n)
+    {
+        const clock::time_point start = clock::now();
+
+        for (k = 0UL; k < result.runs_per_batch; ++k)
+            body();
+
+        const double elapsed = std::chrono::duration<double>(
+            clock::now() - start
+        ).count();
+
+        seconds.push_back(elapsed / static_cast<double>(result.runs_per_batch));
+    }
+
+    std::sort(seconds.begin(), seconds.end());
+
+    result.name = name;
+    result.unit = unit;
+    result.items = items;
+    result.repetitions = repetitions;
+    result.median_seconds = seconds[seconds.size() / 2];
+    result.best_seconds = seconds[0];
+    return result;
+}
+/*  End of run_benchmark.                                                     */
+
+/*  An empty asm statement that claims to read the value from memory. This is *
+ *  free at runtime, but the compiler must compute the value. Other compilers *
+ *  get a volatile read instead.                                              */
+template <class T>
+inline void psow::do_not_optimize(const T &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __asm__ __volatile__("" : : "m"(value) : "memory");
+#else
+    const volatile char *p = reinterpret_cast<const volatile char *>(&value);
+    (void)*p;
+#endif
+}
+
+/*  The seed is the starting state.                                           */
+inline psow::benchmark_rng::benchmark_rng(unsigned long long seed)
+    : state(seed)
+{
+    return;
+}
+
+/*  SplitMix64, by Steele, Lea, and Flood.                                    */
+inline unsigned long long psow::benchmark_rng::next(void)
+{
+    unsigned long long z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/*  The top 53 bits make a double in [0, 1) with every value equally likely,  *
+ *  the divisor being 2^53.                                                   */
+inline double psow::benchmark_rng::uniform(double lo, double hi)
+{
+    const double u = static_cast<double>(next() >> 11) / 9007199254740992.0;
+    return lo + (hi - lo) * u;
+}
+
+/*  One line per benchmark.                                                   */
+inline void
+psow::print_benchmarks(FILE *fp, const std::vector<benchmark_result> &results)
+{
+    std::size_t n;
+
+    std::fprintf(fp, "%-28s %14s %14s %16s\n",
+                 "benchmark", "median ms", "ns/item", "items/s");
+
+    for (n = 0; n < results.size(); ++n)
+    {
+        const benchmark_result &r = results[n];
+        std::fprintf(fp, "%-28s %14.4f %14.3f %12.4e %s/s\n", r.name.c_str(),
+                     r.median_seconds * 1.0E3, r.ns_per_item(),
+                     r.items_per_second(), r.unit.c_str());
+    }
+}
+
+/*  Names are plain identifiers, so they need no escaping.                    */
+inline bool
+psow::write_benchmark_json(FILE *fp,
+                           const std::vector<benchmark_result> &results,
+                           const std::vector<std::string> &context)
+{
+    std::size_t n;
+    int status = 0;
+
+    status |= std::fprintf(fp, "{\n  \"context\": {") < 0;
+
+    for (n = 0; n < context.size(); ++n)
+        status |= std::fprintf(fp, "%s\n    %s", n == 0 ? "" : ",",
+                               context[n].c_str()) < 0;
+
+    status |= std::fprintf(fp, "\n  },\n  \"benchmarks\": [") < 0;
+
+    for (n = 0; n < results.size(); ++n)
+    {
+        const benchmark_result &r = results[n];
+
+        status |= std::fprintf(
+            fp,
+            "%s\n    {\"name\": \"%s\", \"unit\": \"%s\", \"items\": %.17g, "
+            "\"runs_per_batch\": %lu, \"repetitions\": %u, "
+            "\"median_seconds\": %.9g, \"best_seconds\": %.9g, "
+            "\"ns_per_item\": %.6g, \"items_per_second\": %.6g}",
+            n == 0 ? "" : ",", r.name.c_str(), r.unit.c_str(), r.items,
+            r.runs_per_batch, r.repetitions, r.median_seconds,
+            r.best_seconds, r.ns_per_item(), r.items_per_second()
+        ) < 0;
+    }
+
+    status |= std::fprintf(fp, "\n  ]\n}\n") < 0;
+    return status == 0;
+}
+
+#endif
+/*  End of include guard.                                                     */
@@ -0,0 +1,1036 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides a bounding volume hierarchy over a list of spheres.          *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_BVH_HPP
+#define PSOW_BVH_HPP
+
+/*  std::partition and std::nth_element are used to split the spheres.        */
+#include <algorithm>
+
+/*  std::size_t is found here.                                                */
+#include <cstddef>
+
+/*  std::numeric_limits, used for "no hit" values.                            */
+#include <limits>
+
+/*  std::vector, used for the scratch space of the builder.                   */
+#include <vector>
+
+/*  The nodes and the sphere indices, which may be mapped from a cache file.  */
+#include "psow_mappable_array.hpp"
+
+/*  vec3 struct provided here.                                                */
+#include "psow_vec3.hpp"
+
+/*  ray struct given here.                                                    */
+#include "psow_ray.hpp"
+
+/*  sphere struct given here.                                                 */
+#include "psow_sphere.hpp"
+
+/*  The spheres are stored in leaf order in a sphere_list.                    */
+#include "psow_sphere_list.hpp"
+
+/*  Axis-aligned bounding boxes.                                              */
+#include "psow_aabb.hpp"
+
+/*  The parallel builder runs on the thread pool.                             */
+#include "psow_thread_pool.hpp"
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  A node of the hierarchy. For a leaf, count is the number of spheres   *
+     *  and first is the index of the first of them in bvh::spheres. For an   *
+     *  interior node count is zero and the children are nodes first and first*
+     *  + 1.                                                                  */
+    struct bvh_node {
+        aabb box;
+        unsigned int first;
+        unsigned int count;
+    };
+
+    /*  How much effort the builder puts into the quality of the tree.        */
+    enum bvh_quality {
+
+        /*  Linear BVH. The spheres are sorted along a Morton (Z-order) curve *
+         *  and split where the codes first differ. Builds several times      *
+         *  faster than the SAH, but traces somewhat slower.                  */
+        bvh_fast,
+
+        /*  Binned surface area heuristic. The tree costs more to build, and  *
+         *  rays traverse it faster. More bins find better splits at a higher *
+         *  build cost.                                                       */
+        bvh_sah
+    };
+
+    /*  Parameters for building the hierarchy.                                */
+    struct bvh_options {
+
+        /*  Nodes with at most this many spheres may become leaves.           */
+        unsigned int max_leaf_size;
+
+        /*  Number of buckets the centroids are sorted into when looking for  *
+         *  the split with the lowest SAH cost. Ignored by bvh_fast.          */
+        unsigned int bins;
+
+        /*  Speed of the build versus quality of the tree.                    */
+        bvh_quality quality;
+
+        /*  Cost of visiting a node, two box tests and a stack push, in units *
+         *  of one ray-sphere test. The SAH only splits a node of at most     *
+         *  max_leaf_size spheres if the split saves more than this. Leaves   *
+         *  are tested with the SIMD kernels of sphere_list, several spheres  *
+         *  per instruction, so a sphere test is cheap next to a node visit.  *
+         *  Ignored by bvh_fast.                                              */
+        double traversal_cost;
+
+        /*  Default options.                                                  */
+        inline bvh_options(void)
+        {
+            max_leaf_size = 8U;
+            bins = 16U;
+            quality = bvh_sah;
+            traversal_cost = 3.0;
+        }
+    };
+
+    /*  Deepest level a traversal can reach. The builder switches to median   *
+     *  splits past half of this, which keeps every tree well within it.      */
+    const unsigned int bvh_max_depth = 96U;
+
+    /*  A bounding volume hierarchy over a list of spheres, stored as a flat  *
+     *  array of nodes with the root at index zero.                           */
+    struct bvh {
+
+        /*  Array type used for the nodes.                                    */
+        typedef mappable_array<bvh_node> node_array;
+
+        /*  The nodes of the tree. Parents come before their children. Nodes  *
+         *  refer to each other and to the spheres by index, never by address,*
+         *  so the tree can be saved and mapped back anywhere in memory.      */
+        node_array nodes;
+
+        /*  The spheres, reordered so the spheres of every leaf are adjacent. */
+        sphere_list spheres;
+
+        /*  indices[i] is the position of spheres[i] in the original list.    */
+        mappable_array<unsigned int> indices;
+
+        /*  Builds the hierarchy on the calling thread. Any previous tree is  *
+         *  discarded.                                                        */
+        inline void build(const sphere_list &scene,
+                          const bvh_options &options = bvh_options());
+
+        /*  Builds the hierarchy using every thread of the pool. The result is*
+         *  the same tree the serial build produces.                          */
+        inline void build(const sphere_list &scene, const bvh_options &options,
+                          thread_pool &pool);
+
+        /*  Finds the sphere hit first by r, with t in (t_min, t_max). On a   *
+         *  hit, t and index are set and true is returned. index refers to the*
+         *  list the tree was built from.                                     */
+        inline bool nearest_hit(const ray &r, double t_min, double t_max,
+                                double &t, std::size_t &index) const;
+
+        /*  Finds the nearest hit as above and fills in the record for it,    *
+         *  rec.index being the index in the list the tree was built from.    */
+        inline bool hit(const ray &r, double t_min, double t_max,
+                        hit_record &rec) const;
+
+        /*  Same as above, and adds the number of boxes and spheres tested to *
+         *  tests.                                                            */
+        inline bool hit(const ray &r, double t_min, double t_max,
+                        hit_record &rec, unsigned long long &tests) const;
+
+        /*  The traversal behind nearest_hit and hit. leaf is the position of *
+         *  the sphere hit in the leaf-ordered list, spheres. The boxes and   *
+         *  spheres tested are added to tests.                                */
+        inline bool nearest_leaf_hit(const ray &r, double t_min, double t_max,
+                                     double &t, std::size_t &leaf,
+                                     unsigned long long &tests) const;
+
+        /*  Bookkeeping for a sphere while the tree is being built. code is   *
+         *  the Morton code of the centroid, used by bvh_fast.                */
+        struct reference {
+            aabb box;
+            vec3 centroid;
+            unsigned int index;
+            unsigned int code;
+        };
+
+        /*  A range of references still to be turned into a subtree.          */
+        struct job {
+            unsigned int node, depth;
+            std::size_t begin, end;
+        };
+
+        /*  Per axis bins for the SAH, laid out as bins for x, then y, then z.*/
+        struct bin_set {
+            std::vector<aabb> box;
+            std::vector<std::size_t> count;
+        };
+
+        /*  Returns component 0, 1, or 2 (x, y, or z) of a vector.            */
+        static inline double component(const vec3 &v, unsigned int axis);
+
+        /*  Fills in the box, centroid, and index of references[begin, end).  */
+        static inline void
+        make_references(const sphere_list &scene,
+                        std::vector<reference> &references,
+                        std::size_t begin, std::size_t end);
+
+        /*  Computes the Morton codes of references[begin, end), given the box*
+         *  around all of the centroids.                                      */
+        static inline void
+        make_codes(std::vector<reference> &references, std::size_t begin,
+                   std::size_t end, const aabb &centroids);
+
+        /*  Computes the box of references[begin, end) and of their centroids.*/
+        static inline void bounds(const std::vector<reference> &references,
+                                  std::size_t begin, std::size_t end,
+                                  aabb &box, aabb &centroids);
+
+        /*  Empties a bin_set and sizes it for the given number of bins.      */
+        static inline void reset(bin_set &set, unsigned int bins);
+
+        /*  Adds references[begin, end) to the bins.                          */
+        static inline void bin(const std::vector<reference> &references,
+                               std::size_t begin, std::size_t end,
+                               const aabb &centroids, unsigned int bins,
+                               bin_set &set);
+
+        /*  Splits references[begin, end) using bins already filled for that  *
+         *  range. Returns the index of the first reference of the right half,*
+         *  or begin if the range should be a leaf.                           */
+        static inline std::size_t
+        split_binned(std::vector<reference> &references, std::size_t begin,
+                     std::size_t end, const aabb &box, const aabb &centroids,
+                     const bin_set &set, const bvh_options &options);
+
+        /*  Splits references[begin, end), which are sorted by Morton code, at*
+         *  the highest bit where the codes differ. Same return value as      *
+         *  above.                                                            */
+        static inline std::size_t
+        split_morton(const std::vector<reference> &references,
+                     std::size_t begin, std::size_t end,
+                     const bvh_options &options);
+
+        /*  Splits at the median centroid along the widest axis.              */
+        static inline std::size_t
+        split_median(std::vector<reference> &references, std::size_t begin,
+                     std::size_t end, const aabb &centroids,
+                     const bvh_options &options);
+
+        /*  Picks and applies the split for references[begin, end).           */
+        static inline std::size_t
+        split(std::vector<reference> &references, std::size_t begin,
+              std::size_t end, const aabb &box, const aabb &centroids,
+              unsigned int depth, const bvh_options &options);
+
+        /*  Turns node into a leaf, or into a parent of two new nodes, and    *
+         *  returns the jobs for the two children.                            */
+        static inline bool
+        place(node_array &out, const job &current, std::size_t mid,
+              const aabb &box, job &left, job &right);
+
+        /*  Builds the subtree for one job into out, with its root at out[0]. */
+        static inline void
+        build_subtree(std::vector<reference> &references, const job &root,
+                      const bvh_options &options, node_array &out);
+
+        /*  Orders references by Morton code, ties broken by index so that the*
+         *  order never depends on the sorting algorithm.                     */
+        static inline bool by_code(const reference &a, const reference &b);
+
+        /*  Copies the spheres into leaf order once the tree is complete.     */
+        inline void gather(const sphere_list &scene,
+                           const std::vector<reference> &references,
+                           std::size_t begin, std::size_t end);
+    };
+    /*  End of bvh definition.                                                */
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  vec3 has named members rather than an array, so select by hand.           */
+inline double psow::bvh::component(const psow::vec3 &v, unsigned int axis)
+{
+    if (axis == 0U)
+        return v.x;
+
+    if (axis == 1U)
+        return v.y;
+
+    return v.z;
+}
+
+/*  Each sphere is summarized by its box and the center of that box.          */
+inline void
+psow::bvh::make_references(const psow::sphere_list &scene,
+                           std::vector<reference> &references,
+                           std::size_t begin, std::size_t end)
+{
+    std::size_t n;
+
+    for (n = begin; n < end; ++n)
+    {
+        references[n].box = psow::aabb::from_sphere(scene.get(n));
+        references[n].centroid = references[n].box.centroid();
+        references[n].index = static_cast<unsigned int>(n);
+        references[n].code = 0U;
+    }
+}
+
+/*  A 30-bit Morton code interleaves the top ten bits of the x, y, and z      *
+ *  coordinates of the centroid, scaled to [0, 1023]. Points close on the     *
+ *  Z-order curve are close in space, so sorting by code groups neighbours.   */
+inline void
+psow::bvh::make_codes(std::vector<reference> &references, std::size_t begin,
+                      std::size_t end, const psow::aabb &centroids)
+{
+    std::size_t n;
+    unsigned int axis;
+    const psow::vec3 extent = centroids.hi - centroids.lo;
+
+    for (n = begin; n < end; ++n)
+    {
+        unsigned int code = 0U;
+
+        for (axis = 0U; axis < 3U; ++axis)
+        {
+            const double size = component(extent, axis);
+            const double offset = component(references[n].centroid, axis) -
+                                  component(centroids.lo, axis);
+            const double scaled = (size > 0.0 ? 1023.0 * offset / size : 0.0);
+            unsigned int bits = static_cast<unsigned int>(scaled);
+
+            /*  Spread the ten bits out so there are two zeros between each.  */
+            bits = (bits | (bits << 16)) & 0x030000FFU;
+            bits = (bits | (bits <<  8)) & 0x0300F00FU;
+            bits = (bits | (bits <<  4)) & 0x030C30C3U;
+            bits = (bits | (bits <<  2)) & 0x09249249U;
+            code |= bits << (2U - axis);
+        }
+
+        references[n].code = code;
+    }
+}
+
+/*  Sort key for bvh_fast.                                                    */
+inline bool psow::bvh::by_code(const reference &a, const reference &b)
+{
+    if (a.code != b.code)
+        return a.code < b.code;
+
+    return a.index < b.index;
+}
+
+/*  Union of the boxes, and of the centroids.                                 */
+inline void psow::bvh::bounds(const std::vector<reference> &references,
+                              std::size_t begin, std::size_t end,
+                              psow::aabb &box, psow::aabb &centroids)
+{
+    std::size_t n;
+
+    box = psow::aabb();
+    centroids = psow::aabb();
+
+    for (n = begin; n < end; ++n)
+    {
+        box.grow(references[n].box);
+        centroids.grow(references[n].centroid);
+    }
+}
+
+/*  Empty boxes, zero counts.                                                 */
+inline void psow::bvh::reset(bin_set &set, unsigned int bins)
+{
+    set.box.assign(3U * bins, psow::aabb());
+    set.count.assign(3U * bins, 0);
+}
+
+/*  The centroids are dropped into equal width bins along each axis.          */
+inline void psow::bvh::bin(const std::vector<reference> &references,
+                           std::size_t begin, std::size_t end,
+                           const psow::aabb &centroids, unsigned int bins,
+                           bin_set &set)
+{
+    std::size_t n;
+    unsigned int axis;
+
+    for (axis = 0U; axis < 3U; ++axis)
+    {
+        const double lo = component(centroids.lo, axis);
+        const double extent = component(centroids.hi, axis) - lo;
+
+        if (!(extent > 0.0))
+            continue;
+
+        const double scale = bins / extent;
+
+        for (n = begin; n < end; ++n)
+        {
+            const double c = component(references[n].centroid, axis);
+            unsigned int b = static_cast<unsigned int>((c - lo) * scale);
+            b = axis * bins + (b >= bins ? bins - 1U : b);
+            set.box[b].grow(references[n].box);
+            ++set.count[b];
+        }
+    }
+}
+
+/*  The cost of splitting between every pair of neighbouring bins is swept    *
+ *  from both sides, and the cheapest split is compared with the cost of not  *
+ *  splitting at all. Testing a sphere costs one unit, and traversing a node  *
+ *  costs options.traversal_cost of them.                                     */
+inline std::size_t
+psow::bvh::split_binned(std::vector<reference> &references, std::size_t begin,
+                        std::size_t end, const psow::aabb &box,
+                        const psow::aabb &centroids, const bin_set &set,
+                        const bvh_options &options)
+{
+    const std::size_t count = end - begin;
+    const unsigned int bins = static_cast<unsigned int>(set.box.size() / 3U);
+    const double area = box.surface_area();
+    double best_cost = std::numeric_limits<double>::infinity();
+    unsigned int best_axis = 0U, best_bin = 0U;
+    unsigned int axis, k;
+    std::vector<aabb> left_box(bins);
+    std::vector<std::size_t> left_count(bins);
+
+    for (axis = 0U; axis < 3U; ++axis)
+    {
+        const psow::aabb *bin_box = &set.box[axis * bins];
+        const std::size_t *bin_count = &set.count[axis * bins];
+
+        /*  left_box[k] and left_count[k] describe bins 0, ..., k.            */
+        left_box[0] = bin_box[0];
+        left_count[0] = bin_count[0];
+
+        for (k = 1U; k < bins; ++k)
+        {
+            left_box[k] = left_box[k - 1U];
+            left_box[k].grow(bin_box[k]);
+            left_count[k] = left_count[k - 1U] + bin_count[k];
+        }
+
+        /*  Sweep from the right, splitting after bin k - 1.                  */
+        psow::aabb right_box;
+        std::size_t right_count = 0;
+
+        for (k = bins - 1U; k > 0U; --k)
+        {
+            right_box.grow(bin_box[k]);
+            right_count += bin_count[k];
+
+            if (right_count == 0 || left_count[k - 1U] == 0)
+                continue;
+
+            const double cost =
+                left_box[k - 1U].surface_area() * left_count[k - 1U] +
+                right_box.surface_area() * right_count;
+
+            if (cost < best_cost)
+            {
+                best_cost = cost;
+                best_axis = axis;
+                best_bin = k;
+            }
+        }
+    }
+
+    /*  The SAH cost relative to a leaf, which costs count.                   */
+    const double split_cost = options.traversal_cost +
+                              (area > 0.0 ? best_cost / area : best_cost);
+
+    if (count <= options.max_leaf_size &&
+        !(split_cost < static_cast<double>(count)))
+        return begin;
+
+    if (!(best_cost < std::numeric_limits<double>::infinity()))
+        return split_median(references, begin, end, centroids, options);
+
+    const double lo = component(centroids.lo, best_axis);
+    const double scale = bins / (component(centroids.hi, best_axis) - lo);
+
+    const std::vector<reference>::iterator middle = std::partition(
+        references.begin() + begin, references.begin() + end,
+        [=](const reference &ref) -> bool {
+            const double c = component(ref.centroid, best_axis);
+            return static_cast<unsigned int>((c - lo) * scale) < best_bin;
+        }
+    );
+
+    const std::size_t mid =
+        static_cast<std::size_t>(middle - references.begin());
+
+    if (mid == begin || mid == end)
+        return split_median(references, begin, end, centroids, options);
+
+    return mid;
+}
+/*  End of split_binned.                                                      */
+
+/*  The codes are sorted, so the references with the highest differing bit set*
+ *  form the upper part of the range, found with a binary search.             */
+inline std::size_t
+psow::bvh::split_morton(const std::vector<reference> &references,
+                        std::size_t begin, std::size_t end,
+                        const bvh_options &options)
+{
+    const std::size_t count = end - begin;
+    const unsigned int first = references[begin].code;
+    const unsigned int last = references[end - 1].code;
+    unsigned int bit = 31U;
+
+    if (count <= options.max_leaf_size)
+        return begin;
+
+    /*  Identical codes. The order is arbitrary, so cut the range in half.    */
+    if (first == last)
+        return begin + count / 2;
+
+    while (((first ^ last) >> bit) == 0U)
+        --bit;
+
+    const std::vector<reference>::const_iterator middle = std::partition_point(
+        references.begin() + begin, references.begin() + end,
+        [=](const reference &ref) -> bool {
+            return ((ref.code >> bit) & 1U) == 0U;
+        }
+    );
+
+    return static_cast<std::size_t>(middle - references.begin());
+}
+/*  End of split_morton.                                                      */
+
+/*  Used when the tree is very deep or every centroid is in the same place.   *
+ *  Splitting at the median of the widest axis always makes progress.         */
+inline std::size_t
+psow::bvh::split_median(std::vector<reference> &references, std::size_t begin,
+                        std::size_t end, const psow::aabb &centroids,
+                        const bvh_options &options)
+{
+    const std::size_t count = end - begin;
+    const std::size_t mid = begin + count / 2;
+    const psow::vec3 extent = centroids.hi - centroids.lo;
+    unsigned int axis;
+
+    if (count <= options.max_leaf_size)
+        return begin;
+
+    axis = (extent.x > extent.y ? 0U : 1U);
+    axis = (extent.z > component(extent, axis) ? 2U : axis);
+
+    std::nth_element(
+        references.begin() + begin, references.begin() + mid,
+        references.begin() + end,
+        [=](const reference &a, const reference &b) -> bool {
+            return component(a.centroid, axis) < component(b.centroid, axis);
+        }
+    );
+
+    return mid;
+}
+/*  End of split_median.                                                      */
+
+/*  Chooses the split strategy for the node.                                  */
+inline std::size_t
+psow::bvh::split(std::vector<reference> &references, std::size_t begin,
+                 std::size_t end, const psow::aabb &box,
+                 const psow::aabb &centroids, unsigned int depth,
+                 const bvh_options &options)
+{
+    bin_set set;
+    const unsigned int bins = (options.bins < 2U ? 2U : options.bins);
+
+    if (end - begin <= 1)
+        return begin;
+
+    /*  Morton order is kept by cutting in half, rather than by nth_element.  */
+    if (options.quality == bvh_fast)
+    {
+        if (depth < bvh_max_depth / 2U)
+            return split_morton(references, begin, end, options);
+
+        if (end - begin <= options.max_leaf_size)
+            return begin;
+
+        return begin + (end - begin) / 2;
+    }
+
+    if (depth >= bvh_max_depth / 2U)
+        return split_median(references, begin, end, centroids, options);
+
+    reset(set, bins);
+    bin(references, begin, end, centroids, bins, set);
+    return split_binned(references, begin, end, box, centroids, set, options);
+}
+/*  End of split.                                                             */
+
+/*  A split at begin means the node is a leaf. Otherwise two children are     *
+ *  appended next to each other and the node points at the first.             */
+inline bool
+psow::bvh::place(node_array &out, const job &current,
+                 std::size_t mid, const psow::aabb &box, job &left, job &right)
+{
+    out[current.node].box = box;
+
+    if (mid == current.begin)
+    {
+        out[current.node].first = static_cast<unsigned int>(mid);
+        out[current.node].count =
+            static_cast<unsigned int>(current.end - current.begin);
+        return false;
+    }
+
+    const unsigned int child = static_cast<unsigned int>(out.size());
+    out[current.node].first = child;
+    out[current.node].count = 0U;
+    out.push_back(bvh_node());
+    out.push_back(bvh_node());
+
+    left.node = child;
+    left.depth = current.depth + 1U;
+    left.begin = current.begin;
+    left.end = mid;
+
+    right.node = child + 1U;
+    right.depth = current.depth + 1U;
+    right.begin = mid;
+    right.end = current.end;
+    return true;
+}
+/*  End of place.                                                             */
+
+/*  Top-down construction with an explicit stack of ranges still to be split. *
+ *  The left child is always finished before the right, so the layout depends *
+ *  only on the references and not on the timing of any threads.              */
+inline void
+psow::bvh::build_subtree(std::vector<reference> &references, const job &root,
+                         const bvh_options &options,
+                         node_array &out)
+{
+    std::vector<job> jobs;
+    job local_root = root;
+
+    local_root.node = 0U;
+    out.clear();
+    out.push_back(bvh_node());
+    jobs.push_back(local_root);
+
+    while (!jobs.empty())
+    {
+        const job current = jobs.back();
+        psow::aabb box, centroids;
+        job left, right;
+
+        jobs.pop_back();
+        bounds(references, current.begin, current.end, box, centroids);
+
+        const std::size_t mid = split(references, current.begin, current.end,
+                                      box, centroids, current.depth, options);
+
+        if (place(out, current, mid, box, left, right))
+        {
+            jobs.push_back(right);
+            jobs.push_back(left);
+        }
+    }
+}
+/*  End of build_subtree.                                                     */
+
+/*  Leaves reference contiguous ranges of "references", so copying the spheres*
+ *  in that order makes each leaf a contiguous range of "spheres" too.        */
+inline void psow::bvh::gather(const psow::sphere_list &scene,
+                              const std::vector<reference> &references,
+                              std::size_t begin, std::size_t end)
+{
+    std::size_t n;
+
+    for (n = begin; n < end; ++n)
+    {
+        spheres.set(n, scene.get(references[n].index));
+        indices[n] = references[n].index;
+    }
+}
+
+/*  The serial build is the whole tree as one subtree.                        */
+inline void psow::bvh::build(const psow::sphere_list &scene,
+                             const bvh_options &options)
+{
+    const std::size_t n = scene.size();
+    std::vector<reference> references(n);
+    const job root = {0U, 0U, 0, n};
+
+    nodes.clear();
+    spheres.resize(n);
+    indices.resize(n);
+
+    if (n == 0)
+        return;
+
+    make_references(scene, references, 0, n);
+
+    if (options.quality == bvh_fast)
+    {
+        psow::aabb box, centroids;
+        bounds(references, 0, n, box, centroids);
+        make_codes(references, 0, n, centroids);
+        std::sort(references.begin(), references.end(), by_code);
+    }
+
+    build_subtree(references, root, options, nodes);
+    gather(scene, references, 0, n);
+}
+/*  End of build.                                                             */
+
+/*  The top of the tree is built breadth first on the calling thread, with the*
+ *  bounds and the SAH bins of each node computed in parallel, until the      *
+ *  pending ranges are small enough to keep every thread busy. Each of those  *
+ *  ranges then becomes a task building its own subtree, and the subtrees are *
+ *  appended after the top of the tree. Every split is made exactly as in the *
+ *  serial build, so the tree is the same, though its nodes are stored in a   *
+ *  different order.                                                          */
+inline void psow::bvh::build(const psow::sphere_list &scene,
+                             const bvh_options &options, thread_pool &pool)
+{
+    const std::size_t n = scene.size();
+    const std::size_t threads = static_cast<std::size_t>(pool.size());
+    const std::size_t chunks = parallel_chunks(pool);
+    const std::size_t subtree_size = n / (8 * threads) + 1;
+    const unsigned int bins = (options.bins < 2U ? 2U : options.bins);
+    const job root = {0U, 0U, 0, n};
+    std::vector<reference> references(n);
+    std::vector<job> pending, subtrees;
+    std::vector<node_array> local;
+    std::vector<aabb> chunk_box(chunks), chunk_centroids(chunks);
+    std::vector<bin_set> chunk_bins(chunks);
+    std::size_t k, c, next;
+
+    if (threads == 1U || n == 0)
+    {
+        build(scene, options);
+        return;
+    }
+
+    nodes.clear();
+    spheres.resize(n);
+    indices.resize(n);
+
+    parallel_for_chunks(pool, 0, n,
+        [&](std::size_t, std::size_t first, std::size_t last) {
+            make_references(scene, references, first, last);
+        }
+    );
+
+    /*  Computes the box and centroid box of a range, one chunk per task.     */
+    const auto parallel_bounds = [&](std::size_t begin, std::size_t end,
+                                     psow::aabb &box, psow::aabb &centroids)
+    {
+        std::fill(chunk_box.begin(), chunk_box.end(), psow::aabb());
+        std::fill(chunk_centroids.begin(), chunk_centroids.end(), psow::aabb());
+
+        parallel_for_chunks(pool, begin, end,
+            [&](std::size_t chunk, std::size_t first, std::size_t last) {
+                bounds(references, first, last,
+                       chunk_box[chunk], chunk_centroids[chunk]);
+            }
+        );
+
+        box = psow::aabb();
+        centroids = psow::aabb();
+
+        for (c = 0; c < chunks; ++c)
+        {
+            box.grow(chunk_box[c]);
+            centroids.grow(chunk_centroids[c]);
+        }
+    };
+
+    if (options.quality == bvh_fast)
+    {
+        psow::aabb box, centroids;
+        parallel_bounds(0, n, box, centroids);
+
+        parallel_for_chunks(pool, 0, n,
+            [&](std::size_t, std::size_t first, std::size_t last) {
+                make_codes(references, first, last, centroids);
+            }
+        );
+
+        parallel_sort(pool, references.begin(), references.end(), by_code);
+    }
+
+    nodes.reserve(2 * n);
+    nodes.push_back(bvh_node());
+    pending.push_back(root);
+
+    for (next = 0; next < pending.size(); ++next)
+    {
+        const job current = pending[next];
+        psow::aabb box, centroids;
+        std::size_t mid;
+        job left, right;
+
+        if (current.end - current.begin <= subtree_size ||
+            current.depth >= bvh_max_depth / 2U)
+        {
+            subtrees.push_back(current);
+            continue;
+        }
+
+        parallel_bounds(current.begin, current.end, box, centroids);
+
+        if (options.quality == bvh_fast)
+            mid = split_morton(references, current.begin, current.end,
+                               options);
+        else
+        {
+            bin_set set;
+            reset(set, bins);
+
+            for (c = 0; c < chunks; ++c)
+                reset(chunk_bins[c], bins);
+
+            parallel_for_chunks(pool, current.begin, current.end,
+                [&](std::size_t chunk, std::size_t first, std::size_t last) {
+                    bin(references, first, last, centroids, bins,
+                        chunk_bins[chunk]);
+                }
+            );
+
+            for (c = 0; c < chunks; ++c)
+            {
+                for (k = 0; k < set.box.size(); ++k)
+                {
+                    set.box[k].grow(chunk_bins[c].box[k]);
+                    set.count[k] += chunk_bins[c].count[k];
+                }
+            }
+
+            mid = split_binned(references, current.begin, current.end, box,
+                               centroids, set, options);
+        }
+
+        if (place(nodes, current, mid, box, left, right))
+        {
+            pending.push_back(left);
+            pending.push_back(right);
+        }
+    }
+
+    local.resize(subtrees.size());
+
+    for (k = 0; k < subtrees.size(); ++k)
+    {
+        pool.submit([&, k]() {
+            build_subtree(references, subtrees[k], options, local[k]);
+        });
+    }
+
+    pool.wait();
+
+    /*  Node i > 0 of a subtree goes to offset + i - 1, its root replaces the *
+     *  placeholder left for it in the top of the tree.                       */
+    for (k = 0; k < subtrees.size(); ++k)
+    {
+        const node_array &tree = local[k];
+        const unsigned int offset = static_cast<unsigned int>(nodes.size());
+
+        for (c = 0; c < tree.size(); ++c)
+        {
+            bvh_node node = tree[c];
+
+            if (node.count == 0U)
+                node.first = offset + node.first - 1U;
+
+            if (c == 0)
+                nodes[subtrees[k].node] = node;
+            else
+                nodes.push_back(node);
+        }
+    }
+
+    parallel_for_chunks(pool, 0, n,
+        [&](std::size_t, std::size_t first, std::size_t last) {
+            gather(scene, references, first, last);
+        }
+    );
+}
+/*  End of build.                                                             */
+
+/*  Depth-first traversal with a small stack. Of two children the nearer is   *
+ *  visited first, and the entry distance of the farther is kept on the stack *
+ *  so it can be skipped if a closer hit has been found by the time it is     *
+ *  popped. The tests are tallied in a local and added to tests once.         */
+inline bool psow::bvh::nearest_leaf_hit(const psow::ray &r, double t_min,
+                                        double t_max, double &t,
+                                        std::size_t &leaf,
+                                        unsigned long long &tests) const
+{
+    struct entry {
+        unsigned int node;
+        double t;
+    };
+
+    const double infinity = std::numeric_limits<double>::infinity();
+    const psow::vec3 rcpr_v = psow::vec3(1.0 / r.v.x, 1.0 / r.v.y,
+                                         1.0 / r.v.z);
+    entry stack[bvh_max_depth];
+    unsigned int top = 0U;
+    unsigned int node = 0U;
+    double best = t_max;
+    std::size_t found = psow::sphere_list::no_hit;
+    unsigned long long count = 1ULL;
+
+    if (nodes.empty())
+        return false;
+
+    if (nodes[0].box.entry(r, rcpr_v, t_min, best) == infinity)
+    {
+        tests += count;
+        return false;
+    }
+
+    while (true)
+    {
+        const bvh_node &current = nodes[node];
+
+        if (current.count != 0U)
+        {
+            double t_leaf;
+            std::size_t i;
+
+            if (spheres.nearest_hit(r, current.first,
+                                    current.first + current.count,
+                                    t_min, best, t_leaf, i, count))
+            {
+                best = t_leaf;
+                found = i;
+            }
+        }
+        else
+        {
+            unsigned int near = current.first;
+            unsigned int far = current.first + 1U;
+            double t_near = nodes[near].box.entry(r, rcpr_v, t_min, best);
+            double t_far = nodes[far].box.entry(r, rcpr_v, t_min, best);
+
+            count += 2ULL;
+
+            if (t_far < t_near)
+            {
+                std::swap(near, far);
+                std::swap(t_near, t_far);
+            }
+
+            if (t_near != infinity)
+            {
+                if (t_far != infinity)
+                {
+                    stack[top].node = far;
+                    stack[top].t = t_far;
+                    ++top;
+                }
+
+                node = near;
+                continue;
+            }
+        }
+
+        /*  Pop the next subtree that could still hold a closer hit.          */
+        bool more = false;
+
+        while (top > 0U)
+        {
+            --top;
+
+            if (stack[top].t < best)
+            {
+                node = stack[top].node;
+                more = true;
+                break;
+            }
+        }
+
+        if (!more)
+            break;
+    }
+
+    tests += count;
+
+    if (found == psow::sphere_list::no_hit)
+        return false;
+
+    t = best;
+    leaf = found;
+    return true;
+}
+/*  End of nearest_leaf_hit.                                                  */
+
+/*  Translates the leaf position back to the index in the original list.      */
+inline bool psow::bvh::nearest_hit(const psow::ray &r, double t_min,
+                                   double t_max, double &t,
+                                   std::size_t &index) const
+{
+    std::size_t leaf;
+    unsigned long long tests = 0ULL;
+
+    if (!nearest_leaf_hit(r, t_min, t_max, t, leaf, tests))
+        return false;
+
+    index = indices[leaf];
+    return true;
+}
+
+/*  The sphere is read from the leaf-ordered copy, next to the ones the       *
+ *  traversal just tested, so it is likely still in cache.                    */
+inline bool psow::bvh::hit(const psow::ray &r, double t_min, double t_max,
+                           psow::hit_record &rec,
+                           unsigned long long &tests) const
+{
+    double t;
+    std::size_t leaf;
+
+    if (!nearest_leaf_hit(r, t_min, t_max, t, leaf, tests))
+        return false;
+
+    rec.set_sphere(r, t, psow::vec3(spheres.cx[leaf], spheres.cy[leaf],
+                                    spheres.cz[leaf]),
+                   spheres.radius[leaf]);
+    rec.index = indices[leaf];
+    return true;
+}
+
+/*  Without counting the tests.                                               */
+inline bool psow::bvh::hit(const psow::ray &r, double t_min, double t_max,
+                           psow::hit_record &rec) const
+{
+    unsigned long long tests = 0ULL;
+    return hit(r, t_min, t_max, rec, tests);
+}
+
+#endif
+/*  End of include guard.                                                     */
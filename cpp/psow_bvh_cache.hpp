@@ -0,0 +1,743 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides a cache of bounding volume hierarchies on disk. A built tree *
+ *      is saved in a relocatable layout, every node referring to others by   *
+ *      index, under a name derived from a hash of the spheres and the build  *
+ *      options. Later runs over the same scene map the file and use the tree *
+ *      in place instead of building it again.                                *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_BVH_CACHE_HPP
+#define PSOW_BVH_CACHE_HPP
+
+/*  Fixed-width integers for the header and the hash.                         */
+#include <cstdint>
+
+/*  fopen, fread, fwrite, and snprintf.                                       */
+#include <cstdio>
+
+/*  memcmp, memcpy, and memset.                                               */
+#include <cstring>
+
+/*  std::string, the directory and the file names.                            */
+#include <string>
+
+/*  std::is_trivially_copyable, checked for the nodes that are mapped.        */
+#include <type_traits>
+
+/*  std::vector, the marks on nodes, spheres, and indices when checking.      */
+#include <vector>
+
+/*  The tree that is cached, and the pool it is built with on a miss.         */
+#include "psow_bvh.hpp"
+#include "psow_thread_pool.hpp"
+
+/*  PSOW_HAS_MMAP, the POSIX headers, and the helpers for reading and writing *
+ *  aligned arrays are shared with the binary scene files.                    */
+#include "psow_scene_file.hpp"
+
+/*  Files are written under a temporary name and renamed into place.          */
+#include "psow_temporary_file.hpp"
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  A cache file starts with a bvh_file_header, followed by the nodes, the*
+     *  leaf-ordered cx, cy, cz, and radius arrays of the tree's spheres, and *
+     *  the indices back into the original list. As with binary scenes, every *
+     *  array begins at a multiple of 64 bytes into the file and the numbers  *
+     *  are in the byte order of the machine that wrote it. Nodes refer to    *
+     *  their children and spheres by index, so the arrays are used wherever  *
+     *  the file is mapped.                                                   */
+    struct bvh_file_header {
+
+        /*  "PSOWBVH" followed by a zero byte.                                */
+        char magic[8];
+
+        /*  bvh_file_version, and 0x01020304 as written by the machine.       */
+        std::uint32_t version;
+        std::uint32_t byte_order;
+
+        /*  bvh_key of the spheres and options the tree was built from.       */
+        std::uint64_t key;
+
+        std::uint64_t node_count;
+        std::uint64_t sphere_count;
+
+        /*  Byte offsets of the arrays: node_count bvh_nodes, sphere_count    *
+         *  doubles for each of cx, cy, cz, and radius, and sphere_count      *
+         *  32-bit indices.                                                   */
+        std::uint64_t nodes, cx, cy, cz, radius, indices;
+    };
+
+    /*  The layout of the records must not depend on the compiler.            */
+    static_assert(sizeof(bvh_file_header) == 88 &&
+                  sizeof(bvh_node) == 56 &&
+                  sizeof(unsigned int) == 4,
+                  "unexpected sizes for the BVH cache format");
+
+    static_assert(std::is_trivially_copyable<bvh_node>::value,
+                  "bvh_node must be trivially copyable to be mapped");
+
+    /*  Version of the format written by write_bvh. It is also part of the    *
+     *  key, so a change to the builder that changes its trees should bump it.*/
+    const std::uint32_t bvh_file_version = 1U;
+
+    /*  A 64-bit hash of the spheres and of the options that affect the tree  *
+     *  built over them. The coordinates are hashed bit for bit, four words at*
+     *  a time in independent lanes, so hashing a scene runs at memory speed  *
+     *  and costs a small part of a build.                                    */
+    inline std::uint64_t bvh_key(const sphere_list &scene,
+                                 const bvh_options &options);
+
+    /*  Writes a tree to path, tagged with key. The file is written under a   *
+     *  temporary name unique to the call, see open_temporary, and renamed    *
+     *  into place, so a reader never sees half a file. Returns false on      *
+     *  failure.                                                              */
+    inline bool write_bvh(const char *path, const bvh &tree, std::uint64_t key);
+
+    /*  Reads a cached tree into tree, copying it. The file must carry key and*
+     *  its tree must be one over exactly the spheres of scene. Works on every*
+     *  platform, mapped_bvh avoids the copy where mmap is available. Returns *
+     *  false on failure, leaving tree empty.                                 */
+    inline bool read_bvh(const char *path, std::uint64_t key,
+                         const sphere_list &scene, bvh &tree);
+
+    /*  Checks that a header describes a tree that fits in a file of the given*
+     *  size.                                                                 */
+    inline bool valid_bvh_header(const bvh_file_header &header,
+                                 std::uint64_t file_size);
+
+#if PSOW_HAS_MMAP
+
+    /*  A cached tree mapped into memory. The arrays of the tree point into   *
+     *  the mapping, so the tree must not be used after the mapping is closed.*
+     *  The mapping is private, as with mapped_scene.                         */
+    class mapped_bvh {
+        public:
+
+            /*  Empty constructor. Nothing is mapped.                         */
+            inline mapped_bvh(void);
+
+            /*  Unmaps the file if needed.                                    */
+            inline ~mapped_bvh(void);
+
+            /*  Maps the cache file at path and makes tree use it, replacing  *
+             *  what tree held. The checks of read_bvh are made on the mapped *
+             *  arrays. Returns false on failure, leaving tree empty.         */
+            inline bool open(const char *path, std::uint64_t key,
+                             const sphere_list &scene, bvh &tree);
+
+            /*  Unmaps the file. Returns false on failure.                    */
+            inline bool close(void);
+
+        private:
+            unsigned char *map;
+            std::size_t length;
+
+            /*  A mapping cannot be shared between two owners.                */
+            mapped_bvh(const mapped_bvh &);
+            mapped_bvh &operator = (const mapped_bvh &);
+    };
+    /*  End of mapped_bvh definition.                                         */
+
+#endif
+
+    /*  What bvh_cache::build did.                                            */
+    enum bvh_cache_result {
+
+        /*  The tree was found in the cache and loaded.                       */
+        bvh_cache_loaded,
+
+        /*  The tree was built and saved to the cache.                        */
+        bvh_cache_stored,
+
+        /*  The tree was built, but could not be saved.                       */
+        bvh_cache_built
+    };
+
+    /*  A directory of cached trees, one file per key, named by the key in    *
+     *  hexadecimal. The directory must exist. Several processes may share it.*
+     *  Each writer has its own temporary file, and the rename replaces the   *
+     *  whole file, so the worst a race does is build the same tree twice.    */
+    class bvh_cache {
+        public:
+
+            /*  Cache in the given directory. An empty string is the working  *
+             *  directory.                                                    */
+            inline explicit bvh_cache(const std::string &directory);
+
+            /*  The path of the file for a key.                               */
+            inline std::string path_of(std::uint64_t key) const;
+
+            /*  Makes tree a BVH over scene. A cached tree is used if there is*
+             *  one, otherwise the tree is built on the pool and saved for    *
+             *  next time. A loaded tree may be mapped, in which case it is   *
+             *  only valid while the cache exists and until the next call to  *
+             *  build.                                                        */
+            inline bvh_cache_result build(bvh &tree, const sphere_list &scene,
+                                          const bvh_options &options,
+                                          thread_pool &pool);
+
+        private:
+            std::string directory;
+
+#if PSOW_HAS_MMAP
+            mapped_bvh mapping;
+#endif
+
+            /*  The mapping cannot be shared, and neither can the cache.      */
+            bvh_cache(const bvh_cache &);
+            bvh_cache &operator = (const bvh_cache &);
+    };
+    /*  End of bvh_cache definition.                                          */
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  Helpers for the cache, not part of the interface.                         */
+namespace psow {
+    namespace bvh_cache_detail {
+
+        /*  Constants of the rounds, as used by xxHash.                       */
+        const std::uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+        const std::uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+        const std::uint64_t prime3 = 0x165667B19E3779F9ULL;
+
+        /*  Rotates x left by r bits, 0 < r < 64.                             */
+        inline std::uint64_t rotate(std::uint64_t x, unsigned int r)
+        {
+            return (x << r) | (x >> (64U - r));
+        }
+
+        /*  Mixes one word into an accumulator.                               */
+        inline std::uint64_t step(std::uint64_t lane, std::uint64_t word)
+        {
+            return rotate(lane + word * prime2, 31U) * prime1;
+        }
+
+        /*  Spreads every bit of h over the whole word.                       */
+        inline std::uint64_t finish(std::uint64_t h)
+        {
+            h ^= h >> 33;
+            h *= prime2;
+            h ^= h >> 29;
+            h *= prime3;
+            h ^= h >> 32;
+            return h;
+        }
+
+        /*  Hashes the bits of n doubles into four lanes. The lanes do not    *
+         *  depend on each other, so the rounds of the four overlap in the    *
+         *  pipeline.                                                         */
+        inline void hash_doubles(const double *x, std::size_t n,
+                                 std::uint64_t lanes[4])
+        {
+            std::uint64_t w[4];
+            std::size_t k;
+            unsigned int j;
+
+            for (k = 0; k + 4U <= n; k += 4U)
+            {
+                std::memcpy(w, x + k, sizeof(w));
+
+                for (j = 0U; j < 4U; ++j)
+                    lanes[j] = step(lanes[j], w[j]);
+            }
+
+            for (j = 0U; k < n; ++k, ++j)
+            {
+                std::memcpy(w, x + k, sizeof(double));
+                lanes[j] = step(lanes[j], w[0]);
+            }
+        }
+
+        /*  True if two doubles have the same bits. Unlike ==, this matches   *
+         *  the hash: NaNs equal themselves and 0 differs from -0.            */
+        inline bool same_bits(double a, double b)
+        {
+            return std::memcmp(&a, &b, sizeof(double)) == 0;
+        }
+
+        /*  True if two boxes have the same bits in every coordinate.         */
+        inline bool same_box(const aabb &a, const aabb &b)
+        {
+            return same_bits(a.lo.x, b.lo.x) && same_bits(a.lo.y, b.lo.y) &&
+                   same_bits(a.lo.z, b.lo.z) && same_bits(a.hi.x, b.hi.x) &&
+                   same_bits(a.hi.y, b.hi.y) && same_bits(a.hi.z, b.hi.z);
+        }
+
+        /*  Checks a tree as read from a file. Every node must be reached from*
+         *  the root exactly once, through children that come after their     *
+         *  parents, no deeper than the traversal's stack allows. The leaf    *
+         *  ranges must tile the spheres exactly, with no gap or overlap. The *
+         *  box of a leaf must be the union of its spheres' boxes, and that   *
+         *  of an interior node the union of its children's boxes, bit for    *
+         *  bit, in the order the builder grows them. A damaged file, or one  *
+         *  whose key matches by chance, cannot make the traversal read out of*
+         *  bounds or skip a sphere whose box it no longer encloses.          */
+        inline bool valid_nodes(const bvh_node *nodes, std::size_t node_count,
+                                const sphere_list &spheres)
+        {
+            /*  depth[k] is one more than the depth of node k, zero if no     *
+             *  parent has claimed it yet. Parents come first, so one pass in *
+             *  order sees every parent before its children.                  */
+            std::vector<unsigned char> depth(node_count, 0U);
+            const std::size_t n = spheres.size();
+            std::vector<unsigned char> claimed(n, 0U);
+            std::size_t k, i, covered = 0;
+
+            if (n == 0)
+                return node_count == 0;
+
+            if (node_count == 0 || node_count > 2 * n - 1)
+                return false;
+
+            depth[0] = 1U;
+
+            for (k = 0; k < node_count; ++k)
+            {
+                const bvh_node &node = nodes[k];
+                const std::size_t child = node.first;
+                const unsigned int d = depth[k];
+                aabb box;
+
+                if (d == 0U)
+                    return false;
+
+                if (node.count != 0U)
+                {
+                    if (node.first > n || node.count > n - node.first)
+                        return false;
+
+                    for (i = node.first; i < node.first + node.count; ++i)
+                    {
+                        if (claimed[i] != 0U)
+                            return false;
+
+                        claimed[i] = 1U;
+                        box.grow(aabb::from_sphere(spheres.get(i)));
+                    }
+
+                    if (!same_box(box, node.box))
+                        return false;
+
+                    covered += node.count;
+                    continue;
+                }
+
+                if (child <= k || child >= node_count - 1 ||
+                    d >= bvh_max_depth || depth[child] != 0U ||
+                    depth[child + 1] != 0U)
+                    return false;
+
+                /*  The children's boxes are checked when they are reached.   */
+                box.grow(nodes[child].box);
+                box.grow(nodes[child + 1].box);
+
+                if (!same_box(box, node.box))
+                    return false;
+
+                depth[child] = static_cast<unsigned char>(d + 1U);
+                depth[child + 1] = static_cast<unsigned char>(d + 1U);
+            }
+
+            /*  No leaf overlaps another, so covering n spheres covers all.   */
+            return covered == n;
+        }
+        /*  End of valid_nodes.                                               */
+
+        /*  True if indices is a permutation of 0 to n - 1 and sphere k of    *
+         *  the tree is sphere indices[k] of the scene, bit for bit, for      *
+         *  every k. Together with valid_nodes this rejects a file whose key  *
+         *  matches by chance, unless it holds this scene's spheres in a tree *
+         *  whose boxes are consistent with them.                             */
+        inline bool same_spheres(const sphere_list &spheres,
+                                 const unsigned int *indices,
+                                 const sphere_list &scene)
+        {
+            const std::size_t n = scene.size();
+            std::vector<unsigned char> seen(n, 0U);
+            std::size_t k;
+
+            if (spheres.size() != n)
+                return false;
+
+            for (k = 0; k < n; ++k)
+            {
+                const unsigned int i = indices[k];
+
+                if (i >= n || seen[i] != 0U ||
+                    !same_bits(spheres.cx[k], scene.cx[i]) ||
+                    !same_bits(spheres.cy[k], scene.cy[i]) ||
+                    !same_bits(spheres.cz[k], scene.cz[i]) ||
+                    !same_bits(spheres.radius[k], scene.radius[i]))
+                    return false;
+
+                seen[i] = 1U;
+            }
+
+            return true;
+        }
+        /*  End of same_spheres.                                              */
+
+        /*  The header's key and sizes must match before the arrays are looked*
+         *  at.                                                               */
+        inline bool matches(const bvh_file_header &header, std::uint64_t key,
+                            std::uint64_t file_size, const sphere_list &scene)
+        {
+            return valid_bvh_header(header, file_size) &&
+                   header.key == key &&
+                   header.sphere_count == scene.size();
+        }
+    }
+    /*  End of "bvh_cache_detail" namespace.                                  */
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  The lanes start apart so that equal words in different lanes do not       *
+ *  cancel. The count and the options are mixed in after the coordinates.     */
+inline std::uint64_t psow::bvh_key(const sphere_list &scene,
+                                   const bvh_options &options)
+{
+    using bvh_cache_detail::prime1;
+    using bvh_cache_detail::prime2;
+    using bvh_cache_detail::prime3;
+    using bvh_cache_detail::rotate;
+    using bvh_cache_detail::step;
+
+    const std::size_t n = scene.size();
+    std::uint64_t traversal_cost;
+    std::memcpy(&traversal_cost, &options.traversal_cost, sizeof(double));
+
+    const std::uint64_t tail[6] = {
+        n, options.max_leaf_size, options.bins,
+        static_cast<std::uint64_t>(options.quality), traversal_cost,
+        bvh_file_version
+    };
+    std::uint64_t lanes[4] = {
+        prime1 + prime2, prime2, 0U, static_cast<std::uint64_t>(0U) - prime1
+    };
+    std::uint64_t h;
+    unsigned int k;
+
+    bvh_cache_detail::hash_doubles(scene.cx.data(), n, lanes);
+    bvh_cache_detail::hash_doubles(scene.cy.data(), n, lanes);
+    bvh_cache_detail::hash_doubles(scene.cz.data(), n, lanes);
+    bvh_cache_detail::hash_doubles(scene.radius.data(), n, lanes);
+
+    h = rotate(lanes[0], 1U) + rotate(lanes[1], 7U) +
+        rotate(lanes[2], 12U) + rotate(lanes[3], 18U);
+
+    for (k = 0U; k < 6U; ++k)
+        h = rotate(h ^ step(0U, tail[k]), 27U) * prime1 + prime3;
+
+    return bvh_cache_detail::finish(h);
+}
+/*  End of bvh_key.                                                           */
+
+/*  The layout mirrors write_scene_binary: the header padded to 64 bytes, then*
+ *  the arrays in the order of the offsets in the header.                     */
+inline bool psow::write_bvh(const char *path, const bvh &tree,
+                            std::uint64_t key)
+{
+    using scene_file_detail::align;
+    using scene_file_detail::write_array;
+
+    const std::size_t n = tree.spheres.size();
+    const std::size_t nodes = tree.nodes.size();
+    const std::uint64_t doubles = align(n * sizeof(double));
+    std::string temporary;
+    bvh_file_header header;
+    bool ok;
+    FILE *fp;
+
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "PSOWBVH", 8);
+    header.version = bvh_file_version;
+    header.byte_order = 0x01020304U;
+    header.key = key;
+    header.node_count = nodes;
+    header.sphere_count = n;
+    header.nodes = align(sizeof(header));
+    header.cx = header.nodes + align(nodes * sizeof(bvh_node));
+    header.cy = header.cx + doubles;
+    header.cz = header.cy + doubles;
+    header.radius = header.cz + doubles;
+    header.indices = header.radius + doubles;
+
+    fp = open_temporary(path, temporary);
+
+    if (!fp)
+        return false;
+
+    ok = write_array(fp, &header, sizeof(header)) &&
+         write_array(fp, tree.nodes.data(), nodes * sizeof(bvh_node)) &&
+         write_array(fp, tree.spheres.cx.data(), n * sizeof(double)) &&
+         write_array(fp, tree.spheres.cy.data(), n * sizeof(double)) &&
+         write_array(fp, tree.spheres.cz.data(), n * sizeof(double)) &&
+         write_array(fp, tree.spheres.radius.data(), n * sizeof(double)) &&
+         write_array(fp, tree.indices.data(), n * sizeof(unsigned int));
+
+    return commit_temporary(fp, temporary, path, ok);
+}
+/*  End of write_bvh.                                                         */
+
+/*  As valid_scene_header, the counts are checked against the file size before*
+ *  they are multiplied.                                                      */
+inline bool psow::valid_bvh_header(const bvh_file_header &header,
+                                   std::uint64_t file_size)
+{
+    const std::uint64_t offsets[6] = {
+        header.nodes, header.cx, header.cy, header.cz, header.radius,
+        header.indices
+    };
+    const std::uint64_t sizes[6] = {
+        sizeof(bvh_node), sizeof(double), sizeof(double), sizeof(double),
+        sizeof(double), sizeof(unsigned int)
+    };
+    unsigned int k;
+
+    if (std::memcmp(header.magic, "PSOWBVH", 8) != 0 ||
+        header.version != bvh_file_version ||
+        header.byte_order != 0x01020304U)
+        return false;
+
+    if (header.sphere_count > 0xFFFFFFFFU ||
+        header.sphere_count > file_size || header.node_count > file_size)
+        return false;
+
+    for (k = 0U; k < 6U; ++k)
+    {
+        const std::uint64_t count =
+            (k == 0U ? header.node_count : header.sphere_count);
+
+        if ((offsets[k] & 63U) != 0 || offsets[k] > file_size ||
+            count * sizes[k] > file_size - offsets[k])
+            return false;
+    }
+
+    return true;
+}
+/*  End of valid_bvh_header.                                                  */
+
+/*  Reads the header, then each array straight into the tree's storage.       */
+inline bool psow::read_bvh(const char *path, std::uint64_t key,
+                           const sphere_list &scene, bvh &tree)
+{
+    using scene_file_detail::read_array;
+
+    bvh_file_header header;
+    std::size_t n, nodes;
+    long file_size;
+    bool ok;
+    FILE *fp = std::fopen(path, "rb");
+
+    tree = bvh();
+
+    if (!fp)
+        return false;
+
+    ok = std::fseek(fp, 0, SEEK_END) == 0 &&
+         (file_size = std::ftell(fp)) >= 0 &&
+         std::fseek(fp, 0, SEEK_SET) == 0 &&
+         std::fread(&header, sizeof(header), 1, fp) == 1 &&
+         bvh_cache_detail::matches(header, key,
+                                   static_cast<std::uint64_t>(file_size),
+                                   scene);
+
+    if (ok)
+    {
+        n = static_cast<std::size_t>(header.sphere_count);
+        nodes = static_cast<std::size_t>(header.node_count);
+
+        ok = read_array(fp, header.nodes, nodes, tree.nodes) &&
+             read_array(fp, header.cx, n, tree.spheres.cx) &&
+             read_array(fp, header.cy, n, tree.spheres.cy) &&
+             read_array(fp, header.cz, n, tree.spheres.cz) &&
+             read_array(fp, header.radius, n, tree.spheres.radius) &&
+             read_array(fp, header.indices, n, tree.indices) &&
+             bvh_cache_detail::valid_nodes(tree.nodes.data(), nodes,
+                                           tree.spheres) &&
+             bvh_cache_detail::same_spheres(tree.spheres,
+                                            tree.indices.data(), scene);
+    }
+
+    std::fclose(fp);
+
+    if (!ok)
+        tree = bvh();
+
+    return ok;
+}
+/*  End of read_bvh.                                                          */
+
+#if PSOW_HAS_MMAP
+
+/*  Nothing is mapped yet.                                                    */
+inline psow::mapped_bvh::mapped_bvh(void) : map(NULL), length(0)
+{
+    return;
+}
+
+/*  Release the mapping if the caller did not.                                */
+inline psow::mapped_bvh::~mapped_bvh(void)
+{
+    close();
+}
+
+/*  As mapped_scene::open. The checks read every node and sphere of the file  *
+ *  once, which also brings the pages in that the first rays would fault on.  */
+inline bool psow::mapped_bvh::open(const char *path, std::uint64_t key,
+                                   const sphere_list &scene, bvh &tree)
+{
+    struct stat info;
+    void *address;
+    int fd;
+
+    tree = bvh();
+
+    if (!close())
+        return false;
+
+    fd = ::open(path, O_RDONLY);
+
+    if (fd < 0)
+        return false;
+
+    if (::fstat(fd, &info) != 0 ||
+        static_cast<std::uint64_t>(info.st_size) < sizeof(bvh_file_header))
+    {
+        ::close(fd);
+        return false;
+    }
+
+    length = static_cast<std::size_t>(info.st_size);
+    address = ::mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (address == MAP_FAILED)
+    {
+        length = 0;
+        return false;
+    }
+
+    map = static_cast<unsigned char *>(address);
+
+    const bvh_file_header &header =
+        *reinterpret_cast<const bvh_file_header *>(map);
+
+    if (!bvh_cache_detail::matches(header, key, length, scene))
+    {
+        close();
+        return false;
+    }
+
+    const std::size_t n = static_cast<std::size_t>(header.sphere_count);
+    const std::size_t nodes = static_cast<std::size_t>(header.node_count);
+
+    tree.nodes.borrow(reinterpret_cast<bvh_node *>(map + header.nodes), nodes);
+    tree.spheres.cx.borrow(reinterpret_cast<double *>(map + header.cx), n);
+    tree.spheres.cy.borrow(reinterpret_cast<double *>(map + header.cy), n);
+    tree.spheres.cz.borrow(reinterpret_cast<double *>(map + header.cz), n);
+    tree.spheres.radius.borrow(
+        reinterpret_cast<double *>(map + header.radius), n
+    );
+    tree.indices.borrow(
+        reinterpret_cast<unsigned int *>(map + header.indices), n
+    );
+
+    if (!bvh_cache_detail::valid_nodes(tree.nodes.data(), nodes,
+                                       tree.spheres) ||
+        !bvh_cache_detail::same_spheres(tree.spheres, tree.indices.data(),
+                                        scene))
+    {
+        tree = bvh();
+        close();
+        return false;
+    }
+
+    return true;
+}
+/*  End of mapped_bvh::open.                                                  */
+
+inline bool psow::mapped_bvh::close(void)
+{
+    bool ok = true;
+
+    if (map)
+        ok = (::munmap(map, length) == 0);
+
+    map = NULL;
+    length = 0;
+    return ok;
+}
+
+#endif
+/*  End of #if PSOW_HAS_MMAP.                                                 */
+
+/*  A trailing slash is added unless the directory already ends in one.       */
+inline psow::bvh_cache::bvh_cache(const std::string &directory)
+    : directory(directory)
+{
+    if (!this->directory.empty() &&
+        this->directory[this->directory.size() - 1] != '/')
+        this->directory += '/';
+}
+
+/*  Sixteen hexadecimal digits, so every key has a name of the same length.   */
+inline std::string psow::bvh_cache::path_of(std::uint64_t key) const
+{
+    char name[32];
+
+    std::snprintf(name, sizeof(name), "%016llx.bvh",
+                  static_cast<unsigned long long>(key));
+
+    return directory + name;
+}
+
+/*  A file that fails any check is treated as a miss and overwritten.         */
+inline psow::bvh_cache_result
+psow::bvh_cache::build(bvh &tree, const sphere_list &scene,
+                       const bvh_options &options, thread_pool &pool)
+{
+    const std::uint64_t key = bvh_key(scene, options);
+    const std::string path = path_of(key);
+
+#if PSOW_HAS_MMAP
+    if (mapping.open(path.c_str(), key, scene, tree))
+        return bvh_cache_loaded;
+#else
+    if (read_bvh(path.c_str(), key, scene, tree))
+        return bvh_cache_loaded;
+#endif
+
+    tree.build(scene, options, pool);
+
+    if (write_bvh(path.c_str(), tree, key))
+        return bvh_cache_stored;
+
+    return bvh_cache_built;
+}
+/*  End of bvh_cache::build.                                                  */
+
+#endif
+/*  End of include guard.                                                     */
@@ -0,0 +1,281 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides a positionable camera with a field of view and defocus blur, *
+ *      generating rays one at a time or a tile at a time in packets.         *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_CAMERA_HPP
+#define PSOW_CAMERA_HPP
+
+/*  std::tan is found here.                                                   */
+#include <cmath>
+
+/*  std::size_t is found here.                                                */
+#include <cstddef>
+
+/*  vec3 struct provided here.                                                */
+#include "psow_vec3.hpp"
+
+/*  ray struct given here.                                                    */
+#include "psow_ray.hpp"
+
+/*  Rays for a tile are written as packets.                                   */
+#include "psow_ray_packet.hpp"
+
+/*  disk_from_square, for points on the lens.                                 */
+#include "psow_low_discrepancy.hpp"
+
+/*  The tile struct.                                                          */
+#include "psow_renderer.hpp"
+
+/*  PSOW_TRACE_SCOPE, compiled out unless PSOW_TRACE is set.                  */
+#include "psow_trace.hpp"
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  Where a camera is and how it is focused.                              */
+    struct camera_options {
+
+        /*  The camera sits at look_from facing look_at, with up pointing to  *
+         *  the top of the image. up must not be parallel to the view.        */
+        vec3 look_from, look_at, up;
+
+        /*  Angle from the top of the image to the bottom, in degrees.        */
+        double vertical_fov;
+
+        /*  Width over height of the image. Zero means the ratio of the       *
+         *  pixel counts, that is square pixels.                              */
+        double aspect_ratio;
+
+        /*  Diameter of the lens. Zero gives a pinhole, everything in focus.  */
+        double aperture;
+
+        /*  Distance to the plane in perfect focus. Zero means the distance   *
+         *  from look_from to look_at.                                        */
+        double focus_distance;
+
+        /*  At the origin looking down the negative z axis, y up, with a 90   *
+         *  degree field of view and no blur. This is the camera of the       *
+         *  examples from the book, a viewport of height 2 one unit away.     */
+        constexpr camera_options(void)
+            : look_from(0.0, 0.0, 0.0), look_at(0.0, 0.0, -1.0),
+              up(0.0, 1.0, 0.0), vertical_fov(90.0), aspect_ratio(0.0),
+              aperture(0.0), focus_distance(0.0)
+        {
+        }
+
+        /*  Constructor from every member, in the order above, so that a      *
+         *  fixed view can be a constexpr constant. The basis and viewport    *
+         *  still need tan and sqrt, and are made by the camera at runtime.   */
+        constexpr camera_options(const vec3 &from, const vec3 &at,
+                                 const vec3 &up_direction, double fov,
+                                 double aspect, double lens_diameter,
+                                 double focus)
+            : look_from(from), look_at(at), up(up_direction),
+              vertical_fov(fov), aspect_ratio(aspect),
+              aperture(lens_diameter), focus_distance(focus)
+        {
+        }
+    };
+
+    /*  A thin-lens camera for an image of width x height pixels. The image   *
+     *  is laid out on the plane of focus when the camera is made, as a       *
+     *  corner and the steps across one pixel, so a ray costs two scaled adds *
+     *  instead of rebuilding the viewport from the basis vectors.            */
+    struct camera {
+        unsigned int width, height;
+
+        /*  Center of the lens.                                               */
+        vec3 origin;
+
+        /*  Right, up, and backwards, an orthonormal basis.                   */
+        vec3 u, v, w;
+
+        /*  Top left corner of the image on the plane of focus, relative to   *
+         *  the origin, and the steps one pixel right and one pixel down.     */
+        vec3 corner, du, dv;
+
+        /*  Half the aperture.                                                */
+        double lens_radius;
+
+        /*  Constructor from the image size and the placement.                */
+        inline camera(unsigned int image_width, unsigned int image_height,
+                      const camera_options &options = camera_options());
+
+        /*  Ray from the center of the lens through the point (dx, dy) of     *
+         *  pixel (x, y), with dx and dy in [0, 1) as in pixel_sample.        */
+        inline ray get_ray(unsigned int x, unsigned int y,
+                           double dx, double dy) const;
+
+        /*  Same, but from the point of the lens given by (lens_u, lens_v) in *
+         *  the unit square, see disk_from_square. This is the defocus blur.  */
+        inline ray get_ray(unsigned int x, unsigned int y, double dx,
+                           double dy, double lens_u, double lens_v) const;
+
+        /*  Writes the rays through pixels x to x + count - 1 of row y,       *
+         *  offset by (dx, dy), to the first count lanes of packet, from the  *
+         *  center of the lens. The remaining lanes repeat the last ray, so a *
+         *  kernel may run on the full packet and ignore their results. A     *
+         *  count above N is taken as N, and a count of zero leaves the packet*
+         *  untouched, as there is no last ray to repeat.                     */
+        template <unsigned int N>
+        inline void get_packet(unsigned int x, unsigned int y,
+                               double dx, double dy, unsigned int count,
+                               ray_packet<N> &packet) const;
+
+        /*  Number of packets of N rays get_tile_packets writes for t.        */
+        template <unsigned int N>
+        static inline std::size_t tile_packet_count(const tile &t);
+
+        /*  Writes the rays of every pixel of t to packets, row by row, each  *
+         *  row starting a new packet, and returns the number written. Keep   *
+         *  packets in a std::vector with aligned_allocator, std::allocator   *
+         *  does not honor their 64-byte alignment before C++17.              */
+        template <unsigned int N>
+        inline std::size_t get_tile_packets(const tile &t, double dx,
+                                            double dy,
+                                            ray_packet<N> *packets) const;
+    };
+    /*  End of camera definition.                                             */
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  The viewport is 2 tan(fov / 2) high at distance one, scaled out to the    *
+ *  plane of focus so that rays from anywhere on the lens meet there.         */
+inline psow::camera::camera(unsigned int image_width,
+                            unsigned int image_height,
+                            const camera_options &options)
+    : width(image_width), height(image_height), origin(options.look_from)
+{
+    const double pi = 3.141592653589793;
+    const double theta = options.vertical_fov * pi / 180.0;
+    const double aspect =
+        (options.aspect_ratio > 0.0 ? options.aspect_ratio :
+                                      static_cast<double>(image_width) /
+                                      image_height);
+    const double distance =
+        (options.focus_distance > 0.0 ? options.focus_distance :
+                                        (options.look_from -
+                                         options.look_at).norm());
+    const double viewport_height = 2.0 * std::tan(0.5 * theta) * distance;
+    const double viewport_width = aspect * viewport_height;
+
+    w = (options.look_from - options.look_at).unit();
+    u = options.up.cross(w).unit();
+    v = w.cross(u);
+
+    du = (viewport_width / image_width) * u;
+    dv = (-viewport_height / image_height) * v;
+    corner = 0.5 * viewport_height * v - 0.5 * viewport_width * u -
+             distance * w;
+    lens_radius = 0.5 * options.aperture;
+}
+
+/*  The point on the image, relative to the origin, is the direction.         */
+inline psow::ray
+psow::camera::get_ray(unsigned int x, unsigned int y,
+                      double dx, double dy) const
+{
+    PSOW_TRACE_SCOPE("camera::get_ray");
+    return psow::ray(origin, corner + (x + dx) * du + (y + dy) * dv);
+}
+
+/*  Moving the start by a point of the lens moves the direction back by it,   *
+ *  so the ray still passes through the same point of the plane of focus.     */
+inline psow::ray
+psow::camera::get_ray(unsigned int x, unsigned int y, double dx, double dy,
+                      double lens_u, double lens_v) const
+{
+    PSOW_TRACE_SCOPE("camera::get_ray");
+    const psow::vec3 disk = lens_radius * disk_from_square(lens_u, lens_v);
+    const psow::vec3 offset = disk.x * u + disk.y * v;
+    return psow::ray(origin + offset,
+                     corner + (x + dx) * du + (y + dy) * dv - offset);
+}
+
+/*  Incremental generation: the first direction of the row is computed once,  *
+ *  and lane i adds i steps to it, one multiply-add per component, in a loop  *
+ *  over the component arrays that vectorizes.                                */
+template <unsigned int N>
+inline void
+psow::camera::get_packet(unsigned int x, unsigned int y, double dx,
+                         double dy, unsigned int count,
+                         ray_packet<N> &packet) const
+{
+    const psow::vec3 first = corner + (x + dx) * du + (y + dy) * dv;
+    unsigned int k;
+
+    if (count == 0U)
+        return;
+
+    for (k = 0U; k < N; ++k)
+    {
+        packet.px[k] = origin.x;
+        packet.py[k] = origin.y;
+        packet.pz[k] = origin.z;
+        packet.vx[k] = first.x + k * du.x;
+        packet.vy[k] = first.y + k * du.y;
+        packet.vz[k] = first.z + k * du.z;
+    }
+
+    /*  Only the last packet of a row that is not a multiple of N is padded.  */
+    for (k = count; k < N; ++k)
+    {
+        packet.vx[k] = packet.vx[count - 1U];
+        packet.vy[k] = packet.vy[count - 1U];
+        packet.vz[k] = packet.vz[count - 1U];
+    }
+}
+
+/*  Each row takes the width rounded up to whole packets.                     */
+template <unsigned int N>
+inline std::size_t psow::camera::tile_packet_count(const tile &t)
+{
+    const std::size_t columns = (t.x1 - t.x0 + N - 1U) / N;
+    return columns * (t.y1 - t.y0);
+}
+
+/*  Rows never share a packet, so lane i is always pixel x + i of its row.    */
+template <unsigned int N>
+inline std::size_t
+psow::camera::get_tile_packets(const tile &t, double dx, double dy,
+                               ray_packet<N> *packets) const
+{
+    unsigned int x, y;
+    std::size_t n = 0;
+
+    for (y = t.y0; y < t.y1; ++y)
+    {
+        for (x = t.x0; x < t.x1; x += N)
+        {
+            const unsigned int left = t.x1 - x;
+            get_packet(x, y, dx, dy, (left < N ? left : N), packets[n]);
+            ++n;
+        }
+    }
+
+    return n;
+}
+
+#endif
+/*  End of include guard.                                                     */
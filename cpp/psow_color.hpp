@@ -31,6 +31,9 @@
 /*  And the equivalent of stdio.h.                                            */
 #include <cstdio>
 
+/*  PSOW_TRACE_SCOPE, compiled out unless PSOW_TRACE is set.                  */
+#include "psow_trace.hpp"
+
 /*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
 namespace psow {
 
@@ -39,22 +42,17 @@ namespace psow {
     struct color {
         unsigned char red, green, blue;
 
-        /*  Empty constructor.                                                */
-        color(void)
-        {
-            return;
-        }
+        /*  Empty constructor. The channels are left uninitialized.           */
+        color(void) = default;
 
         /*  Constructor from three values, RGB.                               */
-        color(unsigned char r, unsigned char g, unsigned char b)
+        constexpr color(unsigned char r, unsigned char g, unsigned char b)
+            : red(r), green(g), blue(b)
         {
-            red   = r;
-            green = g;
-            blue  = b;
         }
 
         /*  Operator for adding colors.                                       */
-        color operator + (color r)
+        constexpr color operator + (color r) const
         {
             /*  To avoid an arithmetic overflow with unsigned char's, compute *
              *  the sum using unsigned int's. Unsigned int's are required to  *
@@ -64,52 +62,35 @@ namespace psow {
              *  at least 8 bits, and we only want values 0 to 255, which is   *
              *  8-bit), if we use unsigned int's to perform the addition, we  *
              *  are guaranteed to NOT get an overflow, which is useful.       */
-            unsigned char out_red, out_green, out_blue;
-
-            /*  Cast to unsigned int's and compute the sum.                   */
-            const unsigned int x = static_cast<unsigned int>(r.red) +
-                                   static_cast<unsigned int>(red);
-            const unsigned int y = static_cast<unsigned int>(r.green) +
-                                   static_cast<unsigned int>(green);
-            const unsigned int z = static_cast<unsigned int>(r.blue) +
-                                   static_cast<unsigned int>(blue);
-
-            /*  If the values exceed 255 return 255. 255 is the max intensity.*/
-            if (x >= 255U)
-                out_red = 255U;
-            else
-                out_red = static_cast<unsigned char>(x);
-
-            if (y >= 255U)
-                out_green = 255U;
-            else
-                out_green = static_cast<unsigned char>(y);
-
-            if (z >= 255U)
-                out_blue = 255U;
-            else
-                out_blue = static_cast<unsigned char>(z);
-
-            /*  Use the constructor to return the sum from the RGB values.    */
-            return color(out_red, out_green, out_blue);
+            return color(saturate(static_cast<unsigned int>(r.red) +
+                                  static_cast<unsigned int>(red)),
+                         saturate(static_cast<unsigned int>(r.green) +
+                                  static_cast<unsigned int>(green)),
+                         saturate(static_cast<unsigned int>(r.blue) +
+                                  static_cast<unsigned int>(blue)));
         }
         /*  End of color addition.                                            */
 
         /*  Scaling a color by a real number.                                 */
-        color operator * (double a)
+        constexpr color operator * (double a) const
+        {
+            return color(
+                static_cast<unsigned char>(a * static_cast<double>(red)),
+                static_cast<unsigned char>(a * static_cast<double>(green)),
+                static_cast<unsigned char>(a * static_cast<double>(blue))
+            );
+        }
+
+        /*  If the value exceeds 255 return 255. 255 is the max intensity.    */
+        static constexpr unsigned char saturate(unsigned int x)
         {
-            const unsigned char r =
-                static_cast<unsigned char>(a * static_cast<double>(red));
-            const unsigned char g =
-                static_cast<unsigned char>(a * static_cast<double>(green));
-            const unsigned char b =
-                static_cast<unsigned char>(a * static_cast<double>(blue));
-            return color(r, g, b);
+            return static_cast<unsigned char>(x >= 255U ? 255U : x);
         }
 
         /*  Function for writing the color to a PPM file.                     */
         void write(FILE *fp) const
         {
+            PSOW_TRACE_SCOPE("color::write");
             std::fputc(red, fp);
             std::fputc(green, fp);
             std::fputc(blue, fp);
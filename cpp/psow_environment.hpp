@@ -0,0 +1,338 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides lookup tables for the background: a gradient over the height *
+ *      of the direction, and a cube map baked from a function or resampled   *
+ *      from an equirectangular image. A lookup is a table fetch.             *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_ENVIRONMENT_HPP
+#define PSOW_ENVIRONMENT_HPP
+
+/*  std::atan2, std::acos, std::sin, std::cos, std::sqrt, and std::fabs.      */
+#include <cmath>
+
+/*  std::size_t is found here.                                                */
+#include <cstddef>
+
+/*  The tables are std::vectors.                                              */
+#include <vector>
+
+/*  vec3 struct provided here.                                                */
+#include "psow_vec3.hpp"
+
+/*  Values of the cube maps made from images.                                 */
+#include "psow_rgb.hpp"
+
+/*  Equirectangular images are read from Radiance files.                      */
+#include "psow_hdr.hpp"
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  A background that depends only on the height of the direction, the y  *
+     *  component of the unit vector, such as the sky gradient of the book.   *
+     *  The table is indexed by s = y |y| / |v|^2, the height squared keeping *
+     *  its sign, which needs neither a square root nor a normalized vector.  *
+     *  Entries are evenly spaced in s, so those near the horizon are further *
+     *  apart in height. At the default size this is under one 8-bit level   *
+     *  for the book's gradient. texel is any copyable type, psow::color or   *
+     *  psow::rgb for instance.                                               */
+    template <class texel>
+    struct sky_lut {
+
+        /*  4096 entries of psow::color fit in 12 kB, well within L1.         */
+        static const unsigned int default_size = 4096U;
+
+        std::vector<texel> table;
+
+        /*  Half of the number of entries less one, maps s to an index.       */
+        double half_span;
+
+        /*  Empty constructor, an empty table.                                */
+        inline sky_lut(void);
+
+        /*  Fills the table with size values of f(height), for heights from   *
+         *  -1, straight down, to 1, straight up. size must be at least 2.    */
+        template <class function>
+        inline void bake(const function &f,
+                         unsigned int size = default_size);
+
+        /*  The entry nearest the height of the direction, which need not be  *
+         *  normalized, but must not be zero.                                 */
+        inline const texel &lookup(const vec3 &direction) const;
+    };
+    /*  End of sky_lut definition.                                            */
+
+    /*  A background over every direction, stored as the six faces of a cube, *
+     *  size x size texels each. A direction is looked up by its component of *
+     *  largest magnitude, which picks the face, and the other two divided by *
+     *  it, which pick the texel. There is no square root or trigonometry, as *
+     *  an equirectangular lookup would need. Faces are ordered +x, -x, +y,   *
+     *  -y, +z, -z, and the texel coordinates of the x, y, and z faces are    *
+     *  (y, z), (z, x), and (x, y). Lookups take the nearest texel.           */
+    template <class texel>
+    struct cube_map {
+
+        /*  128 x 128 faces resolve about half a degree.                      */
+        static const unsigned int default_size = 128U;
+
+        unsigned int size;
+
+        /*  Texel (i, j) of face f is texels[(f size + j) size + i].          */
+        std::vector<texel> texels;
+
+        /*  Half of size, maps the coordinates in [-1, 1] to texels.          */
+        double half_size;
+
+        /*  Empty constructor, no faces.                                      */
+        inline cube_map(void);
+
+        /*  Fills every texel with f(d), d the unit direction through its     *
+         *  center.                                                           */
+        template <class function>
+        inline void bake(const function &f,
+                         unsigned int face_size = default_size);
+
+        /*  The texel the direction points at. The direction need not be      *
+         *  normalized, but must not be zero.                                 */
+        inline const texel &lookup(const vec3 &direction) const;
+
+        /*  Unit direction through the center of texel (i, j) of face f.      */
+        inline vec3 texel_direction(unsigned int f, unsigned int i,
+                                    unsigned int j) const;
+    };
+    /*  End of cube_map definition.                                           */
+
+    /*  Equirectangular maps cover longitude with u and latitude with v, both *
+     *  in [0, 1]. The center of the image, (1/2, 1/2), looks down -z, the    *
+     *  default view of psow::camera, and the top row looks straight up.      */
+    inline void equirect_from_direction(const vec3 &unit_direction,
+                                        double &u, double &v);
+
+    inline vec3 direction_from_equirect(double u, double v);
+
+    /*  Resamples an equirectangular image to the faces of a cube map, with   *
+     *  bilinear filtering. Sizes beyond a quarter of the image width only    *
+     *  add texels that are interpolated.                                     */
+    inline void cube_map_from_equirect(const hdr_image &equirect,
+                                       cube_map<rgb> &environment,
+                                       unsigned int face_size =
+                                           cube_map<rgb>::default_size);
+
+    /*  Reads an equirectangular Radiance file into a cube map. Returns false *
+     *  if the file could not be read, leaving the cube map as it was.        */
+    inline bool load_environment(const char *path, cube_map<rgb> &environment,
+                                 unsigned int face_size =
+                                     cube_map<rgb>::default_size);
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  No entries.                                                               */
+template <class texel>
+inline psow::sky_lut<texel>::sky_lut(void)
+    : half_span(0.0)
+{
+    return;
+}
+
+/*  Entry k is at s = 2k / (size - 1) - 1, so the height is the square root   *
+ *  of |s| with the sign of s.                                                */
+template <class texel>
+template <class function>
+inline void psow::sky_lut<texel>::bake(const function &f, unsigned int size)
+{
+    unsigned int k;
+    const double step = 2.0 / (size - 1U);
+
+    table.clear();
+    table.reserve(size);
+    half_span = 0.5 * (size - 1U);
+
+    for (k = 0U; k < size; ++k)
+    {
+        const double s = k * step - 1.0;
+        const double height = (s < 0.0 ? -std::sqrt(-s) : std::sqrt(s));
+        table.push_back(f(height));
+    }
+}
+/*  End of bake.                                                              */
+
+/*  s is in [-1, 1] and |s| is 1 only for vertical directions, where the      *
+ *  division is exact, so the rounded index is always in range.               */
+template <class texel>
+inline const texel &
+psow::sky_lut<texel>::lookup(const psow::vec3 &direction) const
+{
+    const double s = direction.y * std::fabs(direction.y) / direction.normsq();
+    const double index = s * half_span + half_span + 0.5;
+    return table[static_cast<unsigned int>(index)];
+}
+
+/*  No faces.                                                                 */
+template <class texel>
+inline psow::cube_map<texel>::cube_map(void)
+    : size(0U), half_size(0.0)
+{
+    return;
+}
+
+/*  Face by face, row by row, in the order of the texels.                     */
+template <class texel>
+template <class function>
+inline void
+psow::cube_map<texel>::bake(const function &f, unsigned int face_size)
+{
+    unsigned int face, i, j;
+
+    size = face_size;
+    half_size = 0.5 * face_size;
+    texels.clear();
+    texels.reserve(6U * static_cast<std::size_t>(size) * size);
+
+    for (face = 0U; face < 6U; ++face)
+        for (j = 0U; j < size; ++j)
+            for (i = 0U; i < size; ++i)
+                texels.push_back(f(texel_direction(face, i, j)));
+}
+/*  End of bake.                                                              */
+
+/*  The major axis picks the face, the other two components divided by its    *
+ *  magnitude are in [-1, 1], and map to [0, size]. Only the edge value size  *
+ *  is out of range, and is clamped.                                          */
+template <class texel>
+inline const texel &
+psow::cube_map<texel>::lookup(const psow::vec3 &direction) const
+{
+    const double ax = std::fabs(direction.x);
+    const double ay = std::fabs(direction.y);
+    const double az = std::fabs(direction.z);
+    unsigned int face;
+    double major, a, b;
+
+    if (ax >= ay && ax >= az)
+    {
+        face = (direction.x < 0.0 ? 1U : 0U);
+        major = ax;
+        a = direction.y;
+        b = direction.z;
+    }
+
+    else if (ay >= az)
+    {
+        face = (direction.y < 0.0 ? 3U : 2U);
+        major = ay;
+        a = direction.z;
+        b = direction.x;
+    }
+
+    else
+    {
+        face = (direction.z < 0.0 ? 5U : 4U);
+        major = az;
+        a = direction.x;
+        b = direction.y;
+    }
+
+    const double scale = half_size / major;
+    const unsigned int i = static_cast<unsigned int>(a * scale + half_size);
+    const unsigned int j = static_cast<unsigned int>(b * scale + half_size);
+    const unsigned int last = size - 1U;
+    const std::size_t row = static_cast<std::size_t>(face) * size +
+                            (j < last ? j : last);
+
+    return texels[row * size + (i < last ? i : last)];
+}
+/*  End of lookup.                                                            */
+
+/*  The inverse of lookup at the center of the texel.                         */
+template <class texel>
+inline psow::vec3
+psow::cube_map<texel>::texel_direction(unsigned int f, unsigned int i,
+                                       unsigned int j) const
+{
+    const double sign = (f % 2U == 0U ? 1.0 : -1.0);
+    const double a = (i + 0.5) / half_size - 1.0;
+    const double b = (j + 0.5) / half_size - 1.0;
+
+    if (f < 2U)
+        return psow::vec3(sign, a, b).unit();
+
+    if (f < 4U)
+        return psow::vec3(b, sign, a).unit();
+
+    return psow::vec3(a, b, sign).unit();
+}
+
+/*  Longitude is measured from -z towards +x, latitude down from +y.          */
+inline void psow::equirect_from_direction(const psow::vec3 &unit_direction,
+                                          double &u, double &v)
+{
+    const double pi = 3.141592653589793;
+    const double y = unit_direction.y;
+
+    u = 0.5 + std::atan2(unit_direction.x, -unit_direction.z) / (2.0 * pi);
+    v = std::acos(y < -1.0 ? -1.0 : (y > 1.0 ? 1.0 : y)) / pi;
+}
+
+/*  The inverse of equirect_from_direction.                                   */
+inline psow::vec3 psow::direction_from_equirect(double u, double v)
+{
+    const double pi = 3.141592653589793;
+    const double longitude = (2.0 * u - 1.0) * pi;
+    const double latitude = v * pi;
+    const double rho = std::sin(latitude);
+
+    return psow::vec3(rho * std::sin(longitude), std::cos(latitude),
+                      -rho * std::cos(longitude));
+}
+
+/*  Every texel samples the image in the direction through its center.        */
+inline void psow::cube_map_from_equirect(const psow::hdr_image &equirect,
+                                         psow::cube_map<psow::rgb> &environment,
+                                         unsigned int face_size)
+{
+    const auto texel = [&](const psow::vec3 &direction) -> psow::rgb
+    {
+        double u, v;
+        psow::equirect_from_direction(direction, u, v);
+        return equirect.sample(u, v);
+    };
+
+    environment.bake(texel, face_size);
+}
+
+/*  Read, then resample.                                                      */
+inline bool psow::load_environment(const char *path,
+                                   psow::cube_map<psow::rgb> &environment,
+                                   unsigned int face_size)
+{
+    psow::hdr_image equirect;
+
+    if (!equirect.read(path))
+        return false;
+
+    psow::cube_map_from_equirect(equirect, environment, face_size);
+    return true;
+}
+
+#endif
+/*  End of include guard.                                                     */
@@ -0,0 +1,351 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides a floating point image that is read from and written to      *
+ *      Radiance RGBE (.hdr) files, the usual format of environment maps.     *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_HDR_HPP
+#define PSOW_HDR_HPP
+
+/*  std::floor, std::frexp, and std::ldexp are found here.                    */
+#include <cmath>
+
+/*  std::size_t is found here.                                                */
+#include <cstddef>
+
+/*  fopen, fgets, fread, and fwrite are found here.                           */
+#include <cstdio>
+
+/*  memcpy and strncmp are found here.                                        */
+#include <cstring>
+
+/*  The pixels and the scanline buffer are std::vectors.                      */
+#include <vector>
+
+/*  Pixels are linear rgb values.                                             */
+#include "psow_rgb.hpp"
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  A width x height grid of rgb values, stored row by row, top row       *
+     *  first. Unlike psow::image the values are not clamped or quantized.    */
+    struct hdr_image {
+        unsigned int width, height;
+        std::vector<rgb> pixels;
+
+        /*  Empty constructor, an image with no pixels.                       */
+        inline hdr_image(void);
+
+        /*  Constructor from the dimensions. The pixels are set to black.     */
+        inline hdr_image(unsigned int w, unsigned int h);
+
+        /*  The pixel in column x of row y, and setting it.                   */
+        inline const rgb &get(unsigned int x, unsigned int y) const;
+        inline void set(unsigned int x, unsigned int y, const rgb &c);
+
+        /*  Bilinear interpolation at (u, v) in [0, 1] x [0, 1], (0, 0) being *
+         *  the top left corner of the image. u wraps around, as the columns  *
+         *  of an equirectangular map do, and v is clamped.                   */
+        inline rgb sample(double u, double v) const;
+
+        /*  Reads a Radiance file, with flat or run-length encoded scanlines. *
+         *  Only the standard orientation, "-Y h +X w", is understood, and    *
+         *  not the original run-length encoding, which nothing has written   *
+         *  in decades. Returns false, leaving the image empty, on failure.   */
+        inline bool read(const char *path);
+
+        /*  Writes a Radiance file with flat scanlines. Returns false if the  *
+         *  file could not be written.                                        */
+        inline bool write(const char *path) const;
+
+        /*  Reads count run-length encoded bytes to out[0], out[4], ...       */
+        static inline bool read_runs(FILE *fp, unsigned char *out,
+                                     unsigned int count);
+    };
+    /*  End of hdr_image definition.                                          */
+
+    /*  Conversions between rgb and the four bytes of an RGBE pixel: three    *
+     *  8-bit mantissas and a shared exponent.                                */
+    inline rgb rgb_from_rgbe(const unsigned char *rgbe);
+    inline void rgbe_from_rgb(const rgb &c, unsigned char *rgbe);
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  Zero size, no memory.                                                     */
+inline psow::hdr_image::hdr_image(void)
+    : width(0U), height(0U)
+{
+    return;
+}
+
+/*  Every pixel starts black.                                                 */
+inline psow::hdr_image::hdr_image(unsigned int w, unsigned int h)
+    : width(w), height(h),
+      pixels(static_cast<std::size_t>(w) * h, rgb(0.0, 0.0, 0.0))
+{
+    return;
+}
+
+/*  Row y starts y * width pixels in.                                         */
+inline const psow::rgb &
+psow::hdr_image::get(unsigned int x, unsigned int y) const
+{
+    return pixels[static_cast<std::size_t>(y) * width + x];
+}
+
+inline void
+psow::hdr_image::set(unsigned int x, unsigned int y, const psow::rgb &c)
+{
+    pixels[static_cast<std::size_t>(y) * width + x] = c;
+}
+
+/*  Pixel centers sit at half integers, so the four pixels around (u w, v h)  *
+ *  are the ones around (u w - 1/2, v h - 1/2).                               */
+inline psow::rgb psow::hdr_image::sample(double u, double v) const
+{
+    const double x = u * width - 0.5;
+    const double y = v * height - 0.5;
+    const double x_floor = std::floor(x);
+    const double y_floor = std::floor(y);
+    const double fx = x - x_floor;
+    const double fy = y - y_floor;
+    const long columns = static_cast<long>(width);
+    const long last_row = static_cast<long>(height) - 1L;
+    long x0 = static_cast<long>(x_floor) % columns;
+    long y0 = static_cast<long>(y_floor);
+    long y1 = y0 + 1L;
+
+    if (x0 < 0L)
+        x0 += columns;
+
+    const long x1 = (x0 + 1L == columns ? 0L : x0 + 1L);
+
+    y0 = (y0 < 0L ? 0L : (y0 > last_row ? last_row : y0));
+    y1 = (y1 < 0L ? 0L : (y1 > last_row ? last_row : y1));
+
+    const unsigned int c0 = static_cast<unsigned int>(x0);
+    const unsigned int c1 = static_cast<unsigned int>(x1);
+    const unsigned int r0 = static_cast<unsigned int>(y0);
+    const unsigned int r1 = static_cast<unsigned int>(y1);
+    const rgb top = get(c0, r0)*(1.0 - fx) + get(c1, r0)*fx;
+    const rgb bottom = get(c0, r1)*(1.0 - fx) + get(c1, r1)*fx;
+
+    return top*(1.0 - fy) + bottom*fy;
+}
+/*  End of sample.                                                            */
+
+/*  The header is lines of text, the first starting with "#?", ending in a    *
+ *  blank line, and then the resolution. An encoded scanline starts with 2, 2 *
+ *  and the width, followed by the four components one after another.         */
+inline bool psow::hdr_image::read(const char *path)
+{
+    char line[256];
+    unsigned long w = 0UL, h = 0UL;
+    unsigned int x, y, k;
+    bool magic = false, format = true, ok = true;
+    std::vector<unsigned char> scanline;
+    FILE *fp = std::fopen(path, "rb");
+
+    *this = hdr_image();
+
+    if (!fp)
+        return false;
+
+    if (std::fgets(line, sizeof(line), fp))
+        magic = (std::strncmp(line, "#?", 2) == 0);
+
+    while (magic && std::fgets(line, sizeof(line), fp) && line[0] != '\n')
+    {
+        if (std::strncmp(line, "FORMAT=", 7) == 0)
+            format = (std::strncmp(line, "FORMAT=32-bit_rle_rgbe", 22) == 0);
+    }
+
+    if (!magic || !format || !std::fgets(line, sizeof(line), fp) ||
+        std::sscanf(line, "-Y %lu +X %lu", &h, &w) != 2 ||
+        w == 0UL || h == 0UL || w > 0xFFFFUL || h > 0xFFFFUL)
+    {
+        std::fclose(fp);
+        return false;
+    }
+
+    *this = hdr_image(static_cast<unsigned int>(w),
+                      static_cast<unsigned int>(h));
+    scanline.resize(4U * static_cast<std::size_t>(width));
+
+    for (y = 0U; ok && y < height; ++y)
+    {
+        unsigned char *start = &scanline[0];
+        ok = (std::fread(start, 1, 4, fp) == 4);
+
+        if (!ok)
+            break;
+
+        /*  Widths outside [8, 32768) are never encoded.                      */
+        const bool encoded = (width >= 8U && width < 0x8000U &&
+                              start[0] == 2U && start[1] == 2U &&
+                              (start[2] & 0x80U) == 0U);
+
+        if (encoded)
+        {
+            ok = ((static_cast<unsigned int>(start[2]) << 8 | start[3]) ==
+                  width);
+
+            for (k = 0U; ok && k < 4U; ++k)
+                ok = read_runs(fp, &scanline[k], width);
+        }
+
+        /*  A flat scanline, whose first pixel has just been read.            */
+        else if (width > 1U)
+            ok = (std::fread(&scanline[4], 4, width - 1U, fp) == width - 1U);
+
+        for (x = 0U; ok && x < width; ++x)
+            set(x, y, rgb_from_rgbe(&scanline[4U * x]));
+    }
+
+    std::fclose(fp);
+
+    if (!ok)
+        *this = hdr_image();
+
+    return ok;
+}
+/*  End of read.                                                              */
+
+/*  A count above 128 is a run, the next byte repeated count - 128 times. Any *
+ *  other count is followed by that many literal bytes.                       */
+inline bool
+psow::hdr_image::read_runs(FILE *fp, unsigned char *out, unsigned int count)
+{
+    unsigned char literal[128];
+    unsigned int x = 0U, n;
+
+    while (x < count)
+    {
+        const int code = std::fgetc(fp);
+
+        if (code == EOF || code == 0)
+            return false;
+
+        if (code > 128)
+        {
+            const int value = std::fgetc(fp);
+            const unsigned int run = static_cast<unsigned int>(code) - 128U;
+
+            if (value == EOF || run > count - x)
+                return false;
+
+            for (n = 0U; n < run; ++n, ++x)
+                out[4U * x] = static_cast<unsigned char>(value);
+        }
+
+        else
+        {
+            const unsigned int run = static_cast<unsigned int>(code);
+
+            if (run > count - x || std::fread(literal, 1, run, fp) != run)
+                return false;
+
+            for (n = 0U; n < run; ++n, ++x)
+                out[4U * x] = literal[n];
+        }
+    }
+
+    return true;
+}
+/*  End of read_runs.                                                         */
+
+/*  Flat scanlines are valid for any width, and every reader understands them.*/
+inline bool psow::hdr_image::write(const char *path) const
+{
+    unsigned int x, y;
+    std::vector<unsigned char> scanline(4U * static_cast<std::size_t>(width));
+    FILE *fp = std::fopen(path, "wb");
+
+    if (!fp)
+        return false;
+
+    bool ok = (std::fprintf(fp, "#?RADIANCE\nFORMAT=32-bit_rle_rgbe\n\n"
+                                "-Y %u +X %u\n", height, width) > 0);
+
+    for (y = 0U; ok && y < height; ++y)
+    {
+        for (x = 0U; x < width; ++x)
+            rgbe_from_rgb(get(x, y), &scanline[4U * x]);
+
+        ok = (std::fwrite(&scanline[0], 4, width, fp) == width);
+    }
+
+    return (std::fclose(fp) == 0) && ok;
+}
+/*  End of write.                                                             */
+
+/*  The mantissas are read at the middle of their step, as Radiance does. An  *
+ *  exponent byte of zero is black.                                           */
+inline psow::rgb psow::rgb_from_rgbe(const unsigned char *rgbe)
+{
+    if (rgbe[3] == 0U)
+        return rgb(0.0, 0.0, 0.0);
+
+    const double scale = std::ldexp(1.0, static_cast<int>(rgbe[3]) - 136);
+    return rgb((rgbe[0] + 0.5) * scale, (rgbe[1] + 0.5) * scale,
+               (rgbe[2] + 0.5) * scale);
+}
+
+/*  The largest channel sets the exponent, so its mantissa is in [128, 256).  *
+ *  Values too small to represent, and negative ones, become zero.            */
+inline void psow::rgbe_from_rgb(const psow::rgb &c, unsigned char *rgbe)
+{
+    const double largest = (c.r > c.g ? (c.r > c.b ? c.r : c.b) :
+                                        (c.g > c.b ? c.g : c.b));
+    const double channels[3] = {c.r, c.g, c.b};
+    unsigned int k;
+    int exponent;
+
+    if (!(largest > 1.0E-32))
+    {
+        rgbe[0] = rgbe[1] = rgbe[2] = rgbe[3] = 0U;
+        return;
+    }
+
+    const double scale = std::frexp(largest, &exponent) * 256.0 / largest;
+
+    /*  2^127 is the largest exponent the byte holds, larger values saturate. */
+    if (exponent > 127)
+    {
+        rgbe[0] = rgbe[1] = rgbe[2] = 255U;
+        rgbe[3] = 255U;
+        return;
+    }
+
+    for (k = 0U; k < 3U; ++k)
+    {
+        const double m = (channels[k] > 0.0 ? channels[k] * scale : 0.0);
+        rgbe[k] = static_cast<unsigned char>(m < 255.0 ? m : 255.0);
+    }
+
+    rgbe[3] = static_cast<unsigned char>(exponent + 128);
+}
+/*  End of rgbe_from_rgb.                                                     */
+
+#endif
+/*  End of include guard.                                                     */
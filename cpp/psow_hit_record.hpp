@@ -0,0 +1,78 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides a record of where a ray hit a surface, for shading.          *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_HIT_RECORD_HPP
+#define PSOW_HIT_RECORD_HPP
+
+/*  std::size_t is found here.                                                */
+#include <cstddef>
+
+/*  vec3 struct provided here.                                                */
+#include "psow_vec3.hpp"
+
+/*  ray struct given here.                                                    */
+#include "psow_ray.hpp"
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  Everything shading needs to know about a hit, computed once by the    *
+     *  intersection routine that found it.                                   */
+    struct hit_record {
+
+        /*  Parameter of the hit along the ray, and the point p + tv.         */
+        double t;
+        vec3 point;
+
+        /*  Unit normal pointing out of the surface, whichever side the ray   *
+         *  came from. front_face is true if the ray hit the outside.         */
+        vec3 normal;
+        bool front_face;
+
+        /*  Index of the object hit in the list or tree that was searched.    */
+        std::size_t index;
+
+        /*  Fills in the record for a hit at t on the sphere with the given   *
+         *  center and radius. Dividing by the radius normalizes the normal   *
+         *  without a square root.                                            */
+        inline void set_sphere(const ray &r, double hit_t, const vec3 &center,
+                               double radius);
+    };
+    /*  End of hit_record definition.                                         */
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  The ray hits the outside if it runs against the outward normal.           */
+inline void psow::hit_record::set_sphere(const psow::ray &r, double hit_t,
+                                         const psow::vec3 &center,
+                                         double radius)
+{
+    t = hit_t;
+    point = r.point(hit_t);
+    normal = (point - center) / radius;
+    front_face = (r.v.dot(normal) < 0.0);
+}
+
+#endif
+/*  End of include guard.                                                     */
@@ -0,0 +1,410 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides an in-memory framebuffer that is written to a PPM file with a*
+ *      single call, and a memory-mapped PPM file that can be rendered into   *
+ *      directly.                                                             *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_IMAGE_HPP
+#define PSOW_IMAGE_HPP
+
+/*  std::size_t is found here.                                                */
+#include <cstddef>
+
+/*  snprintf and fwrite are found here.                                       */
+#include <cstdio>
+
+/*  memcpy and memcmp are found here.                                         */
+#include <cstring>
+
+/*  std::move, for the move constructor and assignment.                       */
+#include <utility>
+
+/*  The pixels of an image that owns its memory are stored in a std::vector.  */
+#include <vector>
+
+/*  color struct provided here.                                               */
+#include "psow_color.hpp"
+
+/*  Memory-mapped files use the POSIX calls open, ftruncate, and mmap.        */
+#if defined(__unix__) || defined(__APPLE__)
+#define PSOW_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#else
+#define PSOW_HAS_MMAP 0
+#endif
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  An image is a width x height grid of RGB triples stored row by row,   *
+     *  top row first. The memory holds a complete binary (P6) PPM file, the  *
+     *  header immediately followed by the pixels, so writing the image out is*
+     *  a single call. An image either owns this memory, or is a view of      *
+     *  memory owned by someone else, such as a mapped_ppm.                   */
+    struct image {
+        unsigned int width, height;
+
+        /*  The first pixel, just past the header.                            */
+        unsigned char *pixels;
+
+        /*  Backing memory for images that own their pixels.                  */
+        std::vector<unsigned char> storage;
+
+        /*  Empty constructor, an image with no pixels.                       */
+        inline image(void);
+
+        /*  Constructor from the dimensions. The pixels are set to black.     */
+        inline image(unsigned int w, unsigned int h);
+
+        /*  Constructor for a view of memory owned by the caller, which must  *
+         *  be file_size(w, h) bytes long. The header is written into it.     */
+        inline image(unsigned int w, unsigned int h, unsigned char *file);
+
+        /*  Copies of an image that owns its pixels get their own copy of     *
+         *  them. Copies of a view are views of the same memory.              */
+        inline image(const image &other);
+        inline image &operator = (const image &other);
+
+        /*  Moves take the storage over without copying the pixels, so images *
+         *  can be returned by value and kept in a std::vector cheaply. The   *
+         *  moved-from image is left empty.                                   */
+        inline image(image &&other) noexcept;
+        inline image &operator = (image &&other) noexcept;
+
+        /*  Length of the header "P6\nW H\n255\n" for the given dimensions.   */
+        static inline std::size_t header_size(unsigned int w, unsigned int h);
+
+        /*  Length of the whole PPM file, header and pixels.                  */
+        static inline std::size_t file_size(unsigned int w, unsigned int h);
+
+        /*  Sets the pixel in column x, row y. Row zero is the top row.       */
+        inline void set(unsigned int x, unsigned int y, const color &c);
+
+        /*  Returns the color of the pixel in column x, row y.                */
+        inline color get(unsigned int x, unsigned int y) const;
+
+        /*  Returns true if two images have the same size and pixels.         */
+        inline bool same_pixels(const image &other) const;
+
+        /*  Writes the image as a binary (P6) PPM. Returns false on failure.  */
+        inline bool write(FILE *fp) const;
+
+        /*  Writes the header for a width x height image to the given buffer, *
+         *  which must have room for header_size(w, h) + 1 bytes.             */
+        static inline void write_header(unsigned int w, unsigned int h,
+                                        unsigned char *buffer);
+    };
+    /*  End of image definition.                                              */
+
+#if PSOW_HAS_MMAP
+
+    /*  A PPM file mapped into memory. Render threads write their pixels      *
+     *  straight into the page cache through frame(), and the operating system*
+     *  writes the file back, so the frame is never copied or passed through  *
+     *  stdio.                                                                */
+    class mapped_ppm {
+        public:
+
+            /*  Empty constructor. Nothing is mapped.                         */
+            inline mapped_ppm(void);
+
+            /*  Unmaps and closes the file if needed.                         */
+            inline ~mapped_ppm(void);
+
+            /*  Creates (or truncates) the file at path, sizes it for a w x h *
+             *  image, maps it and writes the header. Returns false on        *
+             *  failure.                                                      */
+            inline bool open(const char *path, unsigned int w, unsigned int h);
+
+            /*  The image living in the mapped file.                          */
+            inline image &frame(void);
+
+            /*  Unmaps and closes the file. Returns false on failure.         */
+            inline bool close(void);
+
+        private:
+            int fd;
+            unsigned char *map;
+            std::size_t length;
+            image view;
+
+            /*  A mapping cannot be shared between two owners.                */
+            mapped_ppm(const mapped_ppm &);
+            mapped_ppm &operator = (const mapped_ppm &);
+    };
+    /*  End of mapped_ppm definition.                                         */
+
+#endif
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  An empty image has no pixels and no header.                               */
+inline psow::image::image(void)
+{
+    width = 0U;
+    height = 0U;
+    pixels = NULL;
+}
+
+/*  Allocate the header and the pixels together.                              */
+inline psow::image::image(unsigned int w, unsigned int h)
+{
+    width = w;
+    height = h;
+
+    /*  One extra byte for the terminator snprintf writes.                    */
+    storage.resize(file_size(w, h) + 1);
+    write_header(w, h, &storage[0]);
+    storage.pop_back();
+    pixels = &storage[0] + header_size(w, h);
+}
+
+/*  Views only write the header, the caller owns the memory.                  */
+inline psow::image::image(unsigned int w, unsigned int h, unsigned char *file)
+{
+    const std::size_t header = header_size(w, h);
+
+    /*  snprintf always writes a terminator, so format into a temporary.      */
+    std::vector<unsigned char> buffer(header + 1);
+    write_header(w, h, &buffer[0]);
+    std::memcpy(file, &buffer[0], header);
+
+    width = w;
+    height = h;
+    pixels = file + header;
+}
+
+/*  An owning image points into its own storage, a view points elsewhere.     */
+inline psow::image::image(const image &other)
+    : width(other.width), height(other.height), pixels(other.pixels),
+      storage(other.storage)
+{
+    if (!other.storage.empty())
+        pixels = &storage[0] + header_size(width, height);
+}
+
+/*  Same rules as the copy constructor.                                       */
+inline psow::image &psow::image::operator = (const image &other)
+{
+    width = other.width;
+    height = other.height;
+    storage = other.storage;
+    pixels = other.pixels;
+
+    if (!other.storage.empty())
+        pixels = &storage[0] + header_size(width, height);
+
+    return *this;
+}
+
+/*  The offset of the pixels in the storage is kept, rather than recomputed   *
+ *  from the header, so nothing here can throw.                               */
+inline psow::image::image(image &&other) noexcept
+    : width(other.width), height(other.height), pixels(other.pixels)
+{
+    const std::size_t offset =
+        (other.storage.empty() ? 0 : other.pixels - &other.storage[0]);
+
+    storage = std::move(other.storage);
+
+    if (!storage.empty())
+        pixels = &storage[0] + offset;
+
+    other.storage.clear();
+    other.width = 0U;
+    other.height = 0U;
+    other.pixels = NULL;
+}
+
+/*  Same rules as the move constructor.                                       */
+inline psow::image &psow::image::operator = (image &&other) noexcept
+{
+    if (this == &other)
+        return *this;
+
+    const std::size_t offset =
+        (other.storage.empty() ? 0 : other.pixels - &other.storage[0]);
+
+    width = other.width;
+    height = other.height;
+    pixels = other.pixels;
+    storage = std::move(other.storage);
+
+    if (!storage.empty())
+        pixels = &storage[0] + offset;
+
+    other.storage.clear();
+    other.width = 0U;
+    other.height = 0U;
+    other.pixels = NULL;
+    return *this;
+}
+
+/*  snprintf with a zero size returns the length it would have written.       */
+inline std::size_t psow::image::header_size(unsigned int w, unsigned int h)
+{
+    return static_cast<std::size_t>(
+        std::snprintf(NULL, 0, "P6\n%u %u\n255\n", w, h)
+    );
+}
+
+/*  Three bytes per pixel after the header.                                   */
+inline std::size_t psow::image::file_size(unsigned int w, unsigned int h)
+{
+    return header_size(w, h) + 3UL * static_cast<std::size_t>(w) * h;
+}
+
+/*  The header used for every PPM in this project.                            */
+inline void psow::image::write_header(unsigned int w, unsigned int h,
+                                      unsigned char *buffer)
+{
+    std::snprintf(reinterpret_cast<char *>(buffer), header_size(w, h) + 1,
+                  "P6\n%u %u\n255\n", w, h);
+}
+
+/*  Pixels are stored as consecutive RGB triples.                             */
+inline void psow::image::set(unsigned int x, unsigned int y, const color &c)
+{
+    unsigned char * const p =
+        pixels + 3UL * (static_cast<std::size_t>(y) * width + x);
+
+    p[0] = c.red;
+    p[1] = c.green;
+    p[2] = c.blue;
+}
+
+/*  Reads back the RGB triple for a pixel.                                    */
+inline psow::color psow::image::get(unsigned int x, unsigned int y) const
+{
+    const unsigned char * const p =
+        pixels + 3UL * (static_cast<std::size_t>(y) * width + x);
+
+    return color(p[0], p[1], p[2]);
+}
+
+/*  Compare the dimensions, then the raw bytes.                               */
+inline bool psow::image::same_pixels(const image &other) const
+{
+    if (width != other.width || height != other.height)
+        return false;
+
+    if (width == 0U || height == 0U)
+        return true;
+
+    return std::memcmp(pixels, other.pixels, 3UL * width * height) == 0;
+}
+
+/*  The header sits right before the pixels, so the whole file goes out with  *
+ *  one fwrite. Large writes bypass the stdio buffer and become a single      *
+ *  write system call.                                                        */
+inline bool psow::image::write(FILE *fp) const
+{
+    PSOW_TRACE_SCOPE("image::write");
+    const std::size_t header = header_size(width, height);
+    const std::size_t size = file_size(width, height);
+
+    if (!pixels)
+        return false;
+
+    return std::fwrite(pixels - header, 1, size, fp) == size;
+}
+
+#if PSOW_HAS_MMAP
+
+/*  Nothing is open yet.                                                      */
+inline psow::mapped_ppm::mapped_ppm(void) : fd(-1), map(NULL), length(0)
+{
+    return;
+}
+
+/*  Release the mapping if the caller did not.                                */
+inline psow::mapped_ppm::~mapped_ppm(void)
+{
+    close();
+}
+
+/*  Size the file first, mmap cannot extend it.                               */
+inline bool
+psow::mapped_ppm::open(const char *path, unsigned int w, unsigned int h)
+{
+    void *address;
+
+    if (!close())
+        return false;
+
+    length = image::file_size(w, h);
+    fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+    if (fd < 0)
+        return false;
+
+    if (::ftruncate(fd, static_cast<off_t>(length)) != 0)
+    {
+        close();
+        return false;
+    }
+
+    address = ::mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    if (address == MAP_FAILED)
+    {
+        close();
+        return false;
+    }
+
+    map = static_cast<unsigned char *>(address);
+    view = image(w, h, map);
+    return true;
+}
+
+/*  The view into the mapping.                                                */
+inline psow::image &psow::mapped_ppm::frame(void)
+{
+    return view;
+}
+
+/*  munmap schedules the dirty pages to be written back to the file.          */
+inline bool psow::mapped_ppm::close(void)
+{
+    bool ok = true;
+
+    if (map)
+        ok = (::munmap(map, length) == 0);
+
+    if (fd >= 0)
+        ok = (::close(fd) == 0) && ok;
+
+    fd = -1;
+    map = NULL;
+    length = 0;
+    view = image();
+    return ok;
+}
+
+#endif
+/*  End of #if PSOW_HAS_MMAP.                                                 */
+
+#endif
+/*  End of include guard.                                                     */
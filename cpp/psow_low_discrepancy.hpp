@@ -0,0 +1,324 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides scrambled low-discrepancy sequences, Sobol and Halton, for   *
+ *      choosing where in a pixel, and where on the lens, samples are taken.  *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_LOW_DISCREPANCY_HPP
+#define PSOW_LOW_DISCREPANCY_HPP
+
+/*  std::sqrt, std::cos, and std::sin are found here.                         */
+#include <cmath>
+
+/*  vec3 struct provided here.                                                */
+#include "psow_vec3.hpp"
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  The sequences a renderer can draw sample positions from.              */
+    enum sample_sequence {
+
+        /*  The R2 sequence, the same points in every pixel, starting at the  *
+         *  center. It only has two dimensions, the others are hashed noise.  */
+        sequence_r2,
+
+        /*  Sobol, Owen scrambled with a different seed in every pixel.       */
+        sequence_sobol,
+
+        /*  Halton, digit scrambled with a different seed in every pixel.     */
+        sequence_halton
+    };
+
+    /*  Dimensions with their own direction numbers, or their own prime base. *
+     *  Higher dimensions reuse these with independent scrambles.             */
+    const unsigned int sobol_dimensions = 8U;
+    const unsigned int halton_dimensions = 8U;
+
+    /*  The 32 direction numbers of each of the first sobol_dimensions        *
+     *  dimensions of the Sobol sequence, one row per dimension.              */
+    inline const unsigned int *sobol_directions(void);
+
+    /*  Unscrambled 32-bit Sobol point, index and dimension as given.         */
+    inline unsigned int sobol_bits(unsigned int index, unsigned int dimension);
+
+    /*  Mixes the bits of x so that nearby inputs give unrelated outputs.     */
+    inline unsigned int hash_bits(unsigned int x);
+
+    /*  Reverses the order of the 32 bits of x.                               */
+    inline unsigned int reverse_bits(unsigned int x);
+
+    /*  Owen (nested uniform) scramble of the 32-bit fraction x by the hash   *
+     *  of Laine and Karras, as made practical by Burley.                     */
+    inline unsigned int owen_scramble(unsigned int x, unsigned int seed);
+
+    /*  Coordinate dimension of point index of the Sobol sequence scrambled   *
+     *  by seed, in [0, 1).                                                   */
+    inline double sobol(unsigned int index, unsigned int dimension,
+                        unsigned int seed);
+
+    /*  Coordinate dimension of point index of the Halton sequence scrambled  *
+     *  by seed, in [0, 1).                                                   */
+    inline double halton(unsigned int index, unsigned int dimension,
+                         unsigned int seed);
+
+    /*  Coordinate dimension of point index of the given sequence.            */
+    inline double sequence_value(sample_sequence sequence, unsigned int index,
+                                 unsigned int dimension, unsigned int seed);
+
+    /*  Scramble seed of pixel (x, y), mixed with a seed for the whole image. */
+    inline unsigned int pixel_seed(unsigned int x, unsigned int y,
+                                   unsigned int image_seed = 0U);
+
+    /*  Maps a point of the unit square to the unit disk of the xy plane so   *
+     *  that uniform points stay uniform, for sampling a lens.                */
+    inline vec3 disk_from_square(double u, double v);
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  Generated from the primitive polynomials and initial direction numbers of *
+ *  Joe and Kuo (new-joe-kuo-6.21201). Dimension 0 is the van der Corput      *
+ *  sequence, the bits of the index reversed.                                 */
+inline const unsigned int *psow::sobol_directions(void)
+{
+    static const unsigned int table[32 * sobol_dimensions] = {
+        /*  Dimension 0.                                                      */
+        0x80000000U, 0x40000000U, 0x20000000U, 0x10000000U, 0x08000000U,
+        0x04000000U, 0x02000000U, 0x01000000U, 0x00800000U, 0x00400000U,
+        0x00200000U, 0x00100000U, 0x00080000U, 0x00040000U, 0x00020000U,
+        0x00010000U, 0x00008000U, 0x00004000U, 0x00002000U, 0x00001000U,
+        0x00000800U, 0x00000400U, 0x00000200U, 0x00000100U, 0x00000080U,
+        0x00000040U, 0x00000020U, 0x00000010U, 0x00000008U, 0x00000004U,
+        0x00000002U, 0x00000001U,
+        /*  Dimension 1.                                                      */
+        0x80000000U, 0xC0000000U, 0xA0000000U, 0xF0000000U, 0x88000000U,
+        0xCC000000U, 0xAA000000U, 0xFF000000U, 0x80800000U, 0xC0C00000U,
+        0xA0A00000U, 0xF0F00000U, 0x88880000U, 0xCCCC0000U, 0xAAAA0000U,
+        0xFFFF0000U, 0x80008000U, 0xC000C000U, 0xA000A000U, 0xF000F000U,
+        0x88008800U, 0xCC00CC00U, 0xAA00AA00U, 0xFF00FF00U, 0x80808080U,
+        0xC0C0C0C0U, 0xA0A0A0A0U, 0xF0F0F0F0U, 0x88888888U, 0xCCCCCCCCU,
+        0xAAAAAAAAU, 0xFFFFFFFFU,
+        /*  Dimension 2.                                                      */
+        0x80000000U, 0xC0000000U, 0x60000000U, 0x90000000U, 0xE8000000U,
+        0x5C000000U, 0x8E000000U, 0xC5000000U, 0x68800000U, 0x9CC00000U,
+        0xEE600000U, 0x55900000U, 0x80680000U, 0xC09C0000U, 0x60EE0000U,
+        0x90550000U, 0xE8808000U, 0x5CC0C000U, 0x8E606000U, 0xC5909000U,
+        0x6868E800U, 0x9C9C5C00U, 0xEEEE8E00U, 0x5555C500U, 0x8000E880U,
+        0xC0005CC0U, 0x60008E60U, 0x9000C590U, 0xE8006868U, 0x5C009C9CU,
+        0x8E00EEEEU, 0xC5005555U,
+        /*  Dimension 3.                                                      */
+        0x80000000U, 0xC0000000U, 0x20000000U, 0x50000000U, 0xF8000000U,
+        0x74000000U, 0xA2000000U, 0x93000000U, 0xD8800000U, 0x25400000U,
+        0x59E00000U, 0xE6D00000U, 0x78080000U, 0xB40C0000U, 0x82020000U,
+        0xC3050000U, 0x208F8000U, 0x51474000U, 0xFBEA2000U, 0x75D93000U,
+        0xA0858800U, 0x914E5400U, 0xDBE79E00U, 0x25DB6D00U, 0x58800080U,
+        0xE54000C0U, 0x79E00020U, 0xB6D00050U, 0x800800F8U, 0xC00C0074U,
+        0x200200A2U, 0x50050093U,
+        /*  Dimension 4.                                                      */
+        0x80000000U, 0x40000000U, 0x20000000U, 0xB0000000U, 0xF8000000U,
+        0xDC000000U, 0x7A000000U, 0x9D000000U, 0x5A800000U, 0x2FC00000U,
+        0xA1600000U, 0xF0B00000U, 0xDA880000U, 0x6FC40000U, 0x81620000U,
+        0x40BB0000U, 0x22878000U, 0xB3C9C000U, 0xFB65A000U, 0xDDB2D000U,
+        0x78022800U, 0x9C0B3C00U, 0x5A0FB600U, 0x2D0DDB00U, 0xA2878080U,
+        0xF3C9C040U, 0xDB65A020U, 0x6DB2D0B0U, 0x800228F8U, 0x400B3CDCU,
+        0x200FB67AU, 0xB00DDB9DU,
+        /*  Dimension 5.                                                      */
+        0x80000000U, 0x40000000U, 0x60000000U, 0x30000000U, 0xC8000000U,
+        0x24000000U, 0x56000000U, 0xFB000000U, 0xE0800000U, 0x70400000U,
+        0xA8600000U, 0x14300000U, 0x9EC80000U, 0xDF240000U, 0xB6D60000U,
+        0x8BBB0000U, 0x48008000U, 0x64004000U, 0x36006000U, 0xCB003000U,
+        0x2880C800U, 0x54402400U, 0xFE605600U, 0xEF30FB00U, 0x7E48E080U,
+        0xAF647040U, 0x1EB6A860U, 0x9F8B1430U, 0xD6C81EC8U, 0xBB249F24U,
+        0x80D6D6D6U, 0x40BBBBBBU,
+        /*  Dimension 6.                                                      */
+        0x80000000U, 0xC0000000U, 0xA0000000U, 0xD0000000U, 0x58000000U,
+        0x94000000U, 0x3E000000U, 0xE3000000U, 0xBE800000U, 0x23C00000U,
+        0x1E200000U, 0xF3100000U, 0x46780000U, 0x67840000U, 0x78460000U,
+        0x84670000U, 0xC6788000U, 0xA784C000U, 0xD846A000U, 0x5467D000U,
+        0x9E78D800U, 0x33845400U, 0xE6469E00U, 0xB7673300U, 0x20F86680U,
+        0x104477C0U, 0xF8668020U, 0x4477C010U, 0x668020F8U, 0x77C01044U,
+        0x8020F866U, 0xC0104477U,
+        /*  Dimension 7.                                                      */
+        0x80000000U, 0x40000000U, 0xA0000000U, 0x50000000U, 0x88000000U,
+        0x24000000U, 0x12000000U, 0x2D000000U, 0x76800000U, 0x9E400000U,
+        0x08200000U, 0x64100000U, 0xB2280000U, 0x7D140000U, 0xFEA20000U,
+        0xBA490000U, 0x1A248000U, 0x491B4000U, 0xC4B5A000U, 0xE3739000U,
+        0xF6800800U, 0xDE400400U, 0xA8200A00U, 0x34100500U, 0x3A280880U,
+        0x59140240U, 0xECA20120U, 0x974902D0U, 0x6CA48768U, 0xD75B49E4U,
+        0xCC95A082U, 0x87639641U
+    };
+
+    return table;
+}
+/*  End of sobol_directions.                                                  */
+
+/*  Each set bit of the index xors in a direction number.                     */
+inline unsigned int
+psow::sobol_bits(unsigned int index, unsigned int dimension)
+{
+    const unsigned int *v = sobol_directions() + 32U * dimension;
+    unsigned int x = 0U;
+
+    for (; index != 0U; index >>= 1, ++v)
+        if (index & 1U)
+            x ^= *v;
+
+    return x;
+}
+
+/*  Wellons' lowbias32, two multiply-xorshift rounds.                         */
+inline unsigned int psow::hash_bits(unsigned int x)
+{
+    x ^= x >> 16;
+    x *= 0x7FEB352DU;
+    x ^= x >> 15;
+    x *= 0x846CA68BU;
+    x ^= x >> 16;
+    return x;
+}
+
+/*  Swap halves, then quarters, and so on down to single bits.                */
+inline unsigned int psow::reverse_bits(unsigned int x)
+{
+    x = (x << 16) | (x >> 16);
+    x = ((x & 0x00FF00FFU) << 8) | ((x & 0xFF00FF00U) >> 8);
+    x = ((x & 0x0F0F0F0FU) << 4) | ((x & 0xF0F0F0F0U) >> 4);
+    x = ((x & 0x33333333U) << 2) | ((x & 0xCCCCCCCCU) >> 2);
+    x = ((x & 0x55555555U) << 1) | ((x & 0xAAAAAAAAU) >> 1);
+    return x;
+}
+
+/*  In the reversed bits, multiplying by an even number only carries from low *
+ *  bits to high ones, so each output bit depends only on the bits below it.  *
+ *  After reversing back, each bit of the fraction is flipped or not by a     *
+ *  function of the bits above it, which is what an Owen scramble does.       */
+inline unsigned int psow::owen_scramble(unsigned int x, unsigned int seed)
+{
+    x = reverse_bits(x);
+    x += seed;
+    x ^= x * 0x6C50B47CU;
+    x ^= x * 0xB82F1E52U;
+    x ^= x * 0xC7AFE638U;
+    x ^= x * 0x8D22F6E6U;
+    return reverse_bits(x);
+}
+
+/*  Burley: Owen scrambling the index shuffles the order of the points while  *
+ *  keeping every power-of-two prefix stratified, so pixels do not share      *
+ *  patterns. Dimensions in the same block of sobol_dimensions share the      *
+ *  shuffle, which keeps them stratified against each other.                  */
+inline double
+psow::sobol(unsigned int index, unsigned int dimension, unsigned int seed)
+{
+    const unsigned int block = dimension / sobol_dimensions;
+    const unsigned int shuffled =
+        owen_scramble(index, hash_bits(seed ^ hash_bits(block)));
+    const unsigned int bits =
+        sobol_bits(shuffled, dimension % sobol_dimensions);
+    const unsigned int scramble = hash_bits(seed + hash_bits(dimension + 1U));
+
+    return static_cast<double>(owen_scramble(bits, scramble)) / 4294967296.0;
+}
+
+/*  The radical inverse in a prime base, the digits of the index mirrored     *
+ *  about the point. Each digit position gets its own random shift mod the    *
+ *  base, which keeps the points stratified in every power of the base. All   *
+ *  the digits of a 32-bit fraction are visited, since a shifted zero digit   *
+ *  is no longer zero.                                                        */
+inline double
+psow::halton(unsigned int index, unsigned int dimension, unsigned int seed)
+{
+    static const unsigned int primes[halton_dimensions] = {
+        2U, 3U, 5U, 7U, 11U, 13U, 17U, 19U
+    };
+
+    const unsigned int base = primes[dimension % halton_dimensions];
+    const double inverse = 1.0 / base;
+    unsigned int key = hash_bits(seed + hash_bits(dimension + 1U));
+    unsigned long long scale = base;
+    double weight = inverse;
+    double value = 0.0;
+
+    for (; scale <= 4294967296ULL; scale *= base, weight *= inverse)
+    {
+        const unsigned int digit = index % base;
+        value += weight * ((digit + key % base) % base);
+        index /= base;
+        key = hash_bits(key);
+    }
+
+    /*  Rounding can reach 1 when every digit is base - 1.                    */
+    return (value < 1.0 ? value : 0.99999999999999989);
+}
+
+/*  The R2 points are the same in every pixel and have no seed.               */
+inline double
+psow::sequence_value(sample_sequence sequence, unsigned int index,
+                     unsigned int dimension, unsigned int seed)
+{
+    switch (sequence)
+    {
+        case sequence_sobol:
+            return sobol(index, dimension, seed);
+
+        case sequence_halton:
+            return halton(index, dimension, seed);
+
+        default:
+        {
+            /*  The R2 steps are 1/g and 1/g^2, g the plastic number.         */
+            const double a1 = 0.7548776662466927;
+            const double a2 = 0.5698402909980532;
+            double x;
+
+            if (dimension > 1U)
+            {
+                const unsigned int bits =
+                    hash_bits(seed ^ hash_bits(index ^ hash_bits(dimension)));
+                return static_cast<double>(bits) / 4294967296.0;
+            }
+
+            x = 0.5 + (dimension == 0U ? a1 : a2) * index;
+            return x - static_cast<double>(static_cast<unsigned long>(x));
+        }
+    }
+}
+
+/*  Hash the row, then the column into it.                                    */
+inline unsigned int
+psow::pixel_seed(unsigned int x, unsigned int y, unsigned int image_seed)
+{
+    return hash_bits(x ^ hash_bits(y ^ hash_bits(image_seed)));
+}
+
+/*  The square root of u as the radius makes the area, not the radius,        *
+ *  uniform, as in random_in_unit_disk.                                       */
+inline psow::vec3 psow::disk_from_square(double u, double v)
+{
+    const double two_pi = 6.283185307179586;
+    const double rho = std::sqrt(u);
+    const double phi = two_pi * v;
+    return psow::vec3(rho * std::cos(phi), rho * std::sin(phi), 0.0);
+}
+
+#endif
+/*  End of include guard.                                                     */
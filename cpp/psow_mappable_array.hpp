@@ -0,0 +1,301 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides an array that either owns its elements, in a cache-line      *
+ *      aligned std::vector, or refers to elements owned by someone else, such*
+ *      as a memory-mapped file. Arrays loaded from a file are used in place  *
+ *      instead of being copied.                                              *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_MAPPABLE_ARRAY_HPP
+#define PSOW_MAPPABLE_ARRAY_HPP
+
+/*  std::size_t is found here.                                                */
+#include <cstddef>
+
+/*  std::is_trivially_copyable, the requirement for borrowing raw memory.     */
+#include <type_traits>
+
+/*  std::move, for the move constructor and assignment.                       */
+#include <utility>
+
+/*  The owned elements are kept in a std::vector.                             */
+#include <vector>
+
+/*  Allocator for 64-byte aligned arrays.                                     */
+#include "psow_aligned_allocator.hpp"
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  An array of T that is either a cache-line aligned std::vector, or a   *
+     *  view of memory owned elsewhere. Element access goes through a single  *
+     *  pointer in both cases, so it costs the same as a std::vector. Anything*
+     *  that changes the size of a borrowed array first copies the elements   *
+     *  into an array of its own. Writing to an element of a borrowed array   *
+     *  writes to the borrowed memory.                                        */
+    template <class T>
+    class mappable_array {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "mappable_array elements must be trivially copyable");
+
+        public:
+
+            /*  Type of the elements.                                         */
+            typedef T value_type;
+
+            /*  Type used for the elements the array owns.                    */
+            typedef std::vector<T, aligned_allocator<T> > vector_type;
+
+            /*  Constructor for an empty array.                               */
+            inline mappable_array(void);
+
+            /*  Copies of a borrowed array borrow the same memory, copies of  *
+             *  an owning array own a copy of the elements.                   */
+            inline mappable_array(const mappable_array &other);
+            inline mappable_array &operator = (const mappable_array &other);
+
+            /*  Moves take the elements over without copying them.            */
+            inline mappable_array(mappable_array &&other);
+            inline mappable_array &operator = (mappable_array &&other);
+
+            /*  Number of elements.                                           */
+            inline std::size_t size(void) const;
+
+            /*  True if the array has no elements.                            */
+            inline bool empty(void) const;
+
+            /*  True if the elements are owned by someone else.               */
+            inline bool borrowed(void) const;
+
+            /*  The element with the given index.                             */
+            inline T &operator [] (std::size_t index);
+            inline const T &operator [] (std::size_t index) const;
+
+            /*  Pointer to the first element, NULL if the array is empty.     */
+            inline T *data(void);
+            inline const T *data(void) const;
+
+            /*  Makes the array refer to the n elements starting at elements, *
+             *  which must stay valid for as long as the array, or any copy of*
+             *  it, uses them. Any elements the array owned are freed.        */
+            inline void borrow(T *elements, std::size_t n);
+
+            /*  As std::vector. A borrowed array is copied to one of its own  *
+             *  first, which becomes the array.                               */
+            inline void reserve(std::size_t n);
+            inline void resize(std::size_t n);
+            inline void push_back(const T &value);
+            inline void clear(void);
+
+        private:
+
+            /*  Copies borrowed elements into owned, and points at them.      */
+            inline void own(void);
+
+            /*  Points first and count at the owned elements.                 */
+            inline void refresh(void);
+
+            vector_type owned;
+
+            /*  The elements in use, either owned's or the borrowed ones.     */
+            T *first;
+            std::size_t count;
+            bool is_borrowed;
+    };
+    /*  End of mappable_array definition.                                     */
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  Nothing owned, nothing borrowed.                                          */
+template <class T>
+inline psow::mappable_array<T>::mappable_array(void)
+    : first(NULL), count(0), is_borrowed(false)
+{
+    return;
+}
+
+/*  The vector copy gets storage of its own, first must then point at it.     */
+template <class T>
+inline psow::mappable_array<T>::mappable_array(const mappable_array &other)
+    : owned(other.owned), first(other.first), count(other.count),
+      is_borrowed(other.is_borrowed)
+{
+    if (!is_borrowed)
+        refresh();
+}
+
+template <class T>
+inline psow::mappable_array<T> &
+psow::mappable_array<T>::operator = (const mappable_array &other)
+{
+    if (this == &other)
+        return *this;
+
+    owned = other.owned;
+    first = other.first;
+    count = other.count;
+    is_borrowed = other.is_borrowed;
+
+    if (!is_borrowed)
+        refresh();
+
+    return *this;
+}
+
+/*  Moving a std::vector keeps its buffer, so first stays valid.              */
+template <class T>
+inline psow::mappable_array<T>::mappable_array(mappable_array &&other)
+    : owned(std::move(other.owned)), first(other.first), count(other.count),
+      is_borrowed(other.is_borrowed)
+{
+    other.owned.clear();
+    other.first = NULL;
+    other.count = 0;
+    other.is_borrowed = false;
+}
+
+template <class T>
+inline psow::mappable_array<T> &
+psow::mappable_array<T>::operator = (mappable_array &&other)
+{
+    if (this == &other)
+        return *this;
+
+    owned = std::move(other.owned);
+    first = other.first;
+    count = other.count;
+    is_borrowed = other.is_borrowed;
+    other.owned.clear();
+    other.first = NULL;
+    other.count = 0;
+    other.is_borrowed = false;
+    return *this;
+}
+
+template <class T>
+inline std::size_t psow::mappable_array<T>::size(void) const
+{
+    return count;
+}
+
+template <class T>
+inline bool psow::mappable_array<T>::empty(void) const
+{
+    return count == 0;
+}
+
+template <class T>
+inline bool psow::mappable_array<T>::borrowed(void) const
+{
+    return is_borrowed;
+}
+
+/*  No bounds checking, as with std::vector.                                  */
+template <class T>
+inline T &psow::mappable_array<T>::operator [] (std::size_t index)
+{
+    return first[index];
+}
+
+template <class T>
+inline const T &psow::mappable_array<T>::operator [] (std::size_t index) const
+{
+    return first[index];
+}
+
+template <class T>
+inline T *psow::mappable_array<T>::data(void)
+{
+    return first;
+}
+
+template <class T>
+inline const T *psow::mappable_array<T>::data(void) const
+{
+    return first;
+}
+
+/*  swap releases the owned memory, which clear would keep.                   */
+template <class T>
+inline void psow::mappable_array<T>::borrow(T *elements, std::size_t n)
+{
+    vector_type().swap(owned);
+    first = (n == 0 ? NULL : elements);
+    count = n;
+    is_borrowed = true;
+}
+
+template <class T>
+inline void psow::mappable_array<T>::reserve(std::size_t n)
+{
+    own();
+    owned.reserve(n);
+    refresh();
+}
+
+template <class T>
+inline void psow::mappable_array<T>::resize(std::size_t n)
+{
+    own();
+    owned.resize(n);
+    refresh();
+}
+
+template <class T>
+inline void psow::mappable_array<T>::push_back(const T &value)
+{
+    own();
+    owned.push_back(value);
+    refresh();
+}
+
+/*  A cleared array owns nothing, so there is nothing to copy.                */
+template <class T>
+inline void psow::mappable_array<T>::clear(void)
+{
+    owned.clear();
+    is_borrowed = false;
+    refresh();
+}
+
+/*  Owning arrays are left alone.                                             */
+template <class T>
+inline void psow::mappable_array<T>::own(void)
+{
+    if (!is_borrowed)
+        return;
+
+    owned.assign(first, first + count);
+    is_borrowed = false;
+    refresh();
+}
+
+/*  data() of an empty vector may or may not be NULL, make it so.             */
+template <class T>
+inline void psow::mappable_array<T>::refresh(void)
+{
+    count = owned.size();
+    first = (count == 0 ? NULL : owned.data());
+}
+
+#endif
+/*  End of include guard.                                                     */
@@ -0,0 +1,231 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides the materials of the path tracer: diffuse (Lambertian),      *
+ *      metal, and dielectric (glass).                                        *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_MATERIAL_HPP
+#define PSOW_MATERIAL_HPP
+
+/*  std::sqrt and std::fabs are found here.                                   */
+#include <cmath>
+
+/*  vec3 struct provided here.                                                */
+#include "psow_vec3.hpp"
+
+/*  ray struct given here.                                                    */
+#include "psow_ray.hpp"
+
+/*  The hit being shaded.                                                     */
+#include "psow_hit_record.hpp"
+
+/*  Random directions for the scattered rays.                                 */
+#include "psow_random.hpp"
+
+/*  Colors of the surfaces.                                                   */
+#include "psow_rgb.hpp"
+
+/*  PSOW_TRACE_SCOPE, compiled out unless PSOW_TRACE is set.                  */
+#include "psow_trace.hpp"
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  The kinds of surface a material can describe.                         */
+    enum material_kind {
+        material_lambertian,
+        material_metal,
+        material_dielectric
+    };
+
+    /*  A material is a tag and the parameters of every kind. Scattering is a *
+     *  switch on the tag rather than a virtual call, so materials are plain  *
+     *  values that can be stored in an array and copied freely.              */
+    struct material {
+        material_kind kind;
+
+        /*  Fraction of each channel reflected. Unused for dielectrics.       */
+        rgb albedo;
+
+        /*  Radius of the random perturbation of a metal's reflection.        */
+        double fuzz;
+
+        /*  Index of refraction of a dielectric, relative to the air.         */
+        double refraction_index;
+
+        /*  Empty constructor, the members are left uninitialized.            */
+        material(void) = default;
+
+        /*  Constructor from every member. Prefer the named constructors      *
+         *  below, which set only what the kind uses. All three are constexpr *
+         *  so tables of materials can be built at compile time.              */
+        constexpr material(material_kind k, const rgb &a, double f, double n)
+            : kind(k), albedo(a), fuzz(f), refraction_index(n)
+        {
+        }
+
+        /*  Diffuse surface that scatters light in all directions.            */
+        static constexpr material lambertian(const rgb &albedo);
+
+        /*  Mirror, blurred by fuzz, which is clamped to [0, 1].              */
+        static constexpr material metal(const rgb &albedo, double fuzz);
+
+        /*  Clear surface that reflects and refracts, like glass or water.    */
+        static constexpr material dielectric(double refraction_index);
+    };
+    /*  End of material definition.                                           */
+
+    /*  Mirror image of v in the plane with unit normal n.                    */
+    inline vec3 reflect(const vec3 &v, const vec3 &n);
+
+    /*  Snell's law for the unit vector u entering a surface with unit normal *
+     *  n, eta being the ratio of the indices of refraction.                  */
+    inline vec3 refract(const vec3 &u, const vec3 &n, double eta);
+
+    /*  Schlick's approximation of the reflectance at the given cosine.       */
+    inline double reflectance(double cosine, double eta);
+
+    /*  Samples the ray scattered by the material at a hit. On success the    *
+     *  scattered ray and the fraction of light it carries are set and true is*
+     *  returned. False means the ray was absorbed.                           */
+    template <class rng_type>
+    inline bool scatter(const material &m, const ray &in,
+                        const hit_record &rec, rng_type &rng,
+                        rgb &attenuation, ray &scattered);
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  Only the albedo matters for a diffuse surface.                            */
+constexpr psow::material
+psow::material::lambertian(const psow::rgb &albedo)
+{
+    return material(material_lambertian, albedo, 0.0, 1.0);
+}
+
+/*  A fuzz of 1 already sends reflections anywhere in the hemisphere.         */
+constexpr psow::material psow::material::metal(const psow::rgb &albedo,
+                                               double fuzz)
+{
+    return material(material_metal, albedo,
+                    (fuzz < 1.0 ? (fuzz > 0.0 ? fuzz : 0.0) : 1.0), 1.0);
+}
+
+/*  Glass absorbs nothing, the albedo is white.                               */
+constexpr psow::material
+psow::material::dielectric(double refraction_index)
+{
+    return material(material_dielectric, rgb(1.0, 1.0, 1.0), 0.0,
+                    refraction_index);
+}
+
+/*  Subtract twice the normal component.                                      */
+inline psow::vec3 psow::reflect(const psow::vec3 &v, const psow::vec3 &n)
+{
+    return v - 2.0 * v.dot(n) * n;
+}
+
+/*  The refracted ray is split into parts perpendicular and parallel to n.    */
+inline psow::vec3
+psow::refract(const psow::vec3 &u, const psow::vec3 &n, double eta)
+{
+    const double cos_theta = std::fmin(-u.dot(n), 1.0);
+    const psow::vec3 perpendicular = eta * (u + cos_theta * n);
+    const double left = 1.0 - perpendicular.normsq();
+    const psow::vec3 parallel = -std::sqrt(std::fabs(left)) * n;
+    return perpendicular + parallel;
+}
+
+/*  R0 + (1 - R0)(1 - cos)^5, with R0 the reflectance head on.                */
+inline double psow::reflectance(double cosine, double eta)
+{
+    const double r = (1.0 - eta) / (1.0 + eta);
+    const double r0 = r * r;
+    const double k = 1.0 - cosine;
+    return r0 + (1.0 - r0) * k*k*k*k*k;
+}
+
+/*  The normal in the record points outward, flip it to face the ray.         */
+template <class rng_type>
+inline bool psow::scatter(const psow::material &m, const psow::ray &in,
+                          const psow::hit_record &rec, rng_type &rng,
+                          psow::rgb &attenuation, psow::ray &scattered)
+{
+    PSOW_TRACE_SCOPE("scatter");
+    const psow::vec3 n = (rec.front_face ? rec.normal : -rec.normal);
+
+    switch (m.kind)
+    {
+        /*  Lambertian reflection: the normal plus a random unit vector is    *
+         *  distributed as cos(theta) about the normal.                       */
+        case material_lambertian:
+        {
+            psow::vec3 direction = n + random_unit_vector(rng);
+
+            /*  The sum can vanish when the random vector is opposite n.      */
+            if (direction.normsq() < 1.0E-16)
+                direction = n;
+
+            scattered = psow::ray(rec.point, direction);
+            attenuation = m.albedo;
+            return true;
+        }
+
+        /*  Reflection about the normal, perturbed within a ball of radius    *
+         *  fuzz. Perturbations pointing into the surface are absorbed.       */
+        case material_metal:
+        {
+            const psow::vec3 direction = reflect(in.v.unit(), n) +
+                                         m.fuzz * random_unit_vector(rng);
+
+            scattered = psow::ray(rec.point, direction);
+            attenuation = m.albedo;
+            return direction.dot(n) > 0.0;
+        }
+
+        /*  Reflect with the probability given by Schlick's approximation, or *
+         *  always when Snell's law has no solution, and refract otherwise.   */
+        case material_dielectric:
+        {
+            const double eta = (rec.front_face ? 1.0 / m.refraction_index :
+                                                 m.refraction_index);
+            const psow::vec3 u = in.v.unit();
+            const double cos_theta = std::fmin(-u.dot(n), 1.0);
+            const double sin_theta = std::sqrt(1.0 - cos_theta*cos_theta);
+            const bool total = (eta * sin_theta > 1.0);
+
+            if (total || reflectance(cos_theta, eta) > rng.uniform())
+                scattered = psow::ray(rec.point, reflect(u, n));
+            else
+                scattered = psow::ray(rec.point, refract(u, n, eta));
+
+            attenuation = m.albedo;
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+/*  End of scatter.                                                           */
+
+#endif
+/*  End of include guard.                                                     */
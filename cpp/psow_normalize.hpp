@@ -0,0 +1,225 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides policies for normalizing vectors: the exact one, and a fast  *
+ *      one that refines the hardware estimate of the reciprocal square root. *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_NORMALIZE_HPP
+#define PSOW_NORMALIZE_HPP
+
+/*  sqrt function found here.                                                 */
+#include <cmath>
+
+/*  vec3 struct provided here.                                                */
+#include "psow_vec3.hpp"
+
+/*  The wide types and their per chunk estimates.                             */
+#include "psow_vec3_wide.hpp"
+
+/*  The estimate instruction for single values.                               */
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define PSOW_HAS_RSQRT_ESTIMATE 1
+#else
+#define PSOW_HAS_RSQRT_ESTIMATE 0
+#endif
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  One Newton step for 1 / sqrt(x) from the guess y, for value_type a    *
+     *  scalar or a wide type.                                                */
+    template <class value_type>
+    inline value_type rsqrt_newton(const value_type &half_x,
+                                   const value_type &y);
+
+    /*  Approximations of 1 / sqrt(x): the x86 estimate, good to 12 bits, and *
+     *  one Newton step, for a relative error below 4E-7 in either precision. *
+     *  Doubles are estimated as floats, so x must be within the range of a   *
+     *  float, between about 1E-38 and 3E38. Without an estimate these are    *
+     *  exact. Current x86 cores take a sqrt and a division in about the same *
+     *  time as the conversions and the step, so the scalar forms pay mostly  *
+     *  on older ones. The wide forms replace a vector sqrt and divide, and   *
+     *  are where this pays, floats most of all.                              */
+    inline float fast_rsqrt(float x);
+    inline double fast_rsqrt(double x);
+
+    /*  The same for each lane, with the estimate of wide_chunk_ops.          */
+    template <class real, unsigned int N>
+    inline wide<real, N> fast_rsqrt(const wide<real, N> &x);
+
+    /*  How a vector is normalized, passed as the template parameter of unit  *
+     *  and unit_or_zero below. exact_normalize computes 1 / sqrt(x) just as  *
+     *  basic_vec3::unit does, and gives the same bits. fast_normalize keeps  *
+     *  about float precision, enough for shading and the like. Code whose    *
+     *  results are compared exactly, or that cannot bound the length of its  *
+     *  vectors, should keep the exact policy.                                */
+    struct exact_normalize {
+        template <class real>
+        static inline real rsqrt(real x);
+
+        template <class real, unsigned int N>
+        static inline wide<real, N> rsqrt(const wide<real, N> &x);
+    };
+
+    struct fast_normalize {
+        template <class real>
+        static inline real rsqrt(real x);
+
+        template <class real, unsigned int N>
+        static inline wide<real, N> rsqrt(const wide<real, N> &x);
+    };
+
+    /*  P scaled to unit length with the given policy.                        */
+    template <class policy, class real>
+    inline basic_vec3<real> unit(const basic_vec3<real> &P);
+
+    template <class policy, class real, unsigned int N>
+    inline basic_vec3x<real, N> unit(const basic_vec3x<real, N> &P);
+
+    /*  Same, but zero vectors, or lanes, are left zero rather than NaN.      */
+    template <class policy, class real>
+    inline basic_vec3<real> unit_or_zero(const basic_vec3<real> &P);
+
+    template <class policy, class real, unsigned int N>
+    inline basic_vec3x<real, N> unit_or_zero(const basic_vec3x<real, N> &P);
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  y (3 - x y^2) / 2, which roughly squares the relative error of y.         */
+template <class value_type>
+inline value_type
+psow::rsqrt_newton(const value_type &half_x, const value_type &y)
+{
+    return y * (value_type(1.5) - half_x * y * y);
+}
+
+/*  The estimate of a single float, and one step.                             */
+inline float psow::fast_rsqrt(float x)
+{
+#if PSOW_HAS_RSQRT_ESTIMATE
+    const float y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+    return rsqrt_newton(0.5F * x, y);
+#else
+    return 1.0F / std::sqrt(x);
+#endif
+}
+
+/*  The float estimate, and the step in double precision.                     */
+inline double psow::fast_rsqrt(double x)
+{
+#if PSOW_HAS_RSQRT_ESTIMATE
+    const float estimate =
+        _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(static_cast<float>(x))));
+    const double half_x = 0.5 * x;
+    return rsqrt_newton(half_x, static_cast<double>(estimate));
+#else
+    return 1.0 / std::sqrt(x);
+#endif
+}
+
+/*  Every chunk is estimated, then the lanes are refined together. The AVX-512*
+ *  estimate is good to 14 bits, the step is the same for simplicity.         */
+template <class real, unsigned int N>
+inline psow::wide<real, N> psow::fast_rsqrt(const wide<real, N> &x)
+{
+    typedef wide_layout<real, N> layout;
+    typedef wide_chunk_ops<real, layout::bytes> ops;
+    const wide<real, N> half_x = real(0.5) * x;
+    wide<real, N> y;
+    unsigned int k;
+
+    for (k = 0U; k < layout::chunks; ++k)
+        y.chunk[k] = ops::rsqrt_estimate(x.chunk[k]);
+
+    return rsqrt_newton(half_x, y);
+}
+
+/*  Division by the square root, as basic_vec3::unit computes it.             */
+template <class real>
+inline real psow::exact_normalize::rsqrt(real x)
+{
+    return real(1) / std::sqrt(x);
+}
+
+template <class real, unsigned int N>
+inline psow::wide<real, N>
+psow::exact_normalize::rsqrt(const psow::wide<real, N> &x)
+{
+    return real(1) / psow::sqrt(x);
+}
+
+/*  Forwarded to fast_rsqrt.                                                  */
+template <class real>
+inline real psow::fast_normalize::rsqrt(real x)
+{
+    return psow::fast_rsqrt(x);
+}
+
+template <class real, unsigned int N>
+inline psow::wide<real, N>
+psow::fast_normalize::rsqrt(const psow::wide<real, N> &x)
+{
+    return psow::fast_rsqrt(x);
+}
+
+/*  One reciprocal square root and three multiplications.                     */
+template <class policy, class real>
+inline psow::basic_vec3<real> psow::unit(const psow::basic_vec3<real> &P)
+{
+    return P * policy::rsqrt(P.normsq());
+}
+
+template <class policy, class real, unsigned int N>
+inline psow::basic_vec3x<real, N>
+psow::unit(const psow::basic_vec3x<real, N> &P)
+{
+    return P * policy::rsqrt(P.normsq());
+}
+
+/*  Zero is the only vector with a zero norm.                                 */
+template <class policy, class real>
+inline psow::basic_vec3<real>
+psow::unit_or_zero(const psow::basic_vec3<real> &P)
+{
+    const real n = P.normsq();
+
+    if (n > real(0))
+        return P * policy::rsqrt(n);
+
+    return psow::basic_vec3<real>(real(0), real(0), real(0));
+}
+
+/*  Lanes of zero norm are selected from zero, whatever the policy gave them. */
+template <class policy, class real, unsigned int N>
+inline psow::basic_vec3x<real, N>
+psow::unit_or_zero(const psow::basic_vec3x<real, N> &P)
+{
+    const psow::wide<real, N> n = P.normsq();
+    const psow::wide<real, N> zero(real(0));
+
+    return psow::select(n > zero, P * policy::rsqrt(n),
+                        psow::basic_vec3x<real, N>(zero, zero, zero));
+}
+
+#endif
+/*  End of include guard.                                                     */
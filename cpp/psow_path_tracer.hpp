@@ -0,0 +1,174 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides a path tracer: the light arriving along a ray is estimated   *
+ *      by following it as it bounces around the scene.                       *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_PATH_TRACER_HPP
+#define PSOW_PATH_TRACER_HPP
+
+/*  ray struct given here.                                                    */
+#include "psow_ray.hpp"
+
+/*  hit_record struct, for the hits along the path.                           */
+#include "psow_hit_record.hpp"
+
+/*  Materials decide where the path goes next.                                */
+#include "psow_material.hpp"
+
+/*  Radiance is carried as rgb triples.                                       */
+#include "psow_rgb.hpp"
+
+/*  The spheres and their materials.                                          */
+#include "psow_scene.hpp"
+
+/*  Optional counters of the rays traced.                                     */
+#include "psow_telemetry.hpp"
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  Parameters of the path tracer.                                        */
+    struct path_options {
+
+        /*  Longest path followed, in bounces.                                */
+        unsigned int max_depth;
+
+        /*  Bounces after which Russian roulette may end a path.              */
+        unsigned int roulette_depth;
+
+        /*  Hits closer than this to the start of a ray are ignored, so that  *
+         *  rounding errors do not make a surface shadow itself.              */
+        double t_min;
+
+        /*  Fifty bounces, roulette from the third, t_min of 10^-3.           */
+        inline path_options(void)
+            : max_depth(50U), roulette_depth(3U), t_min(1.0E-3)
+        {
+            return;
+        }
+    };
+
+    /*  Estimates the radiance arriving along r. Rays that leave the scene see*
+     *  background(ray), which returns an rgb and is the only light source.   *
+     *  The bounce loop is iterative and uses only locals, so it neither      *
+     *  recurses nor allocates, and threads tracing paths never contend.      */
+    template <class rng_type, class background_type>
+    inline rgb trace_path(const scene &world, const ray &r, rng_type &rng,
+                          const background_type &background,
+                          const path_options &options = path_options());
+
+    /*  As above, also adding the rays traced and the surfaces hit along the  *
+     *  path to counters, unless it is NULL. The counts are kept in registers *
+     *  and added once per path.                                              */
+    template <class rng_type, class background_type>
+    inline rgb trace_path(const scene &world, const ray &r, rng_type &rng,
+                          const background_type &background,
+                          const path_options &options,
+                          telemetry_counters *counters);
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  The recursion L(r) = attenuation * L(scattered) is unrolled by carrying   *
+ *  the product of the attenuations so far, the throughput, along the path.   *
+ *  Russian roulette ends a path with probability 1 - p, where p is the       *
+ *  largest channel of the throughput, and divides the survivors by p. The    *
+ *  estimate stays unbiased, and dim paths, which contribute little, are      *
+ *  ended early instead of being followed to max_depth.                       */
+template <class rng_type, class background_type>
+inline psow::rgb
+psow::trace_path(const psow::scene &world, const psow::ray &r,
+                 rng_type &rng, const background_type &background,
+                 const path_options &options,
+                 psow::telemetry_counters *counters)
+{
+    psow::rgb throughput(1.0, 1.0, 1.0);
+
+    /*  Absorbed, ended by roulette, or out of bounces: no light arrives.     */
+    psow::rgb radiance(0.0, 0.0, 0.0);
+    psow::ray current = r;
+    psow::hit_record rec;
+    unsigned int depth;
+    unsigned int hits = 0U;
+    unsigned long long tests = 0ULL;
+    bool escaped = false;
+
+    for (depth = 0U; depth < options.max_depth; ++depth)
+    {
+        psow::rgb attenuation;
+        psow::ray scattered;
+
+        if (!world.hit(current, options.t_min, 1.0E300, rec, tests))
+        {
+            radiance = throughput * background(current);
+            escaped = true;
+            break;
+        }
+
+        ++hits;
+
+        if (!scatter(world.material_of_hit(rec), current, rec, rng,
+                     attenuation, scattered))
+            break;
+
+        throughput *= attenuation;
+        current = scattered;
+
+        if (depth + 1U >= options.roulette_depth)
+        {
+            double p = throughput.r;
+            p = (throughput.g > p ? throughput.g : p);
+            p = (throughput.b > p ? throughput.b : p);
+            p = (p < 0.95 ? p : 0.95);
+
+            if (rng.uniform() >= p)
+                break;
+
+            throughput *= 1.0 / p;
+        }
+    }
+
+    /*  Every ray either hit a surface or escaped to the background.          */
+    if (counters)
+    {
+        counters->add_rays(hits + (escaped ? 1U : 0U));
+        counters->add_intersection_tests(tests);
+        counters->add_hits(hits);
+    }
+
+    return radiance;
+}
+/*  End of trace_path.                                                        */
+
+/*  No counters.                                                              */
+template <class rng_type, class background_type>
+inline psow::rgb
+psow::trace_path(const psow::scene &world, const psow::ray &r,
+                 rng_type &rng, const background_type &background,
+                 const path_options &options)
+{
+    return trace_path(world, r, rng, background, options,
+                      static_cast<psow::telemetry_counters *>(NULL));
+}
+
+#endif
+/*  End of include guard.                                                     */
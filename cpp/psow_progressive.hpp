@@ -0,0 +1,375 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides progressive rendering: passes of one sample per pixel are    *
+ *      accumulated until a time or sample budget runs out, with optional     *
+ *      snapshots of the image so far.                                        *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_PROGRESSIVE_HPP
+#define PSOW_PROGRESSIVE_HPP
+
+/*  std::atomic, the flag set once the deadline has passed.                   */
+#include <atomic>
+
+/*  std::chrono::steady_clock, used for the time budget.                      */
+#include <chrono>
+
+/*  FILE, the snapshot being written.                                         */
+#include <cstdio>
+
+/*  std::string, the name of the temporary snapshot file.                     */
+#include <string>
+
+/*  The buffer the passes are accumulated in, and the tonemap.                */
+#include "psow_accumulator.hpp"
+
+/*  Snapshots are written as PPM images.                                      */
+#include "psow_image.hpp"
+
+/*  The sequences the sample positions are drawn from.                        */
+#include "psow_low_discrepancy.hpp"
+
+/*  tile and default_tile_size.                                               */
+#include "psow_renderer.hpp"
+
+/*  Samples are rgb triples.                                                  */
+#include "psow_rgb.hpp"
+
+/*  Optional counters of the samples and tiles rendered.                      */
+#include "psow_telemetry.hpp"
+
+/*  Snapshots are written under a temporary name and renamed into place.      */
+#include "psow_temporary_file.hpp"
+
+/*  The passes are spread over a thread pool.                                 */
+#include "psow_thread_pool.hpp"
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  Where in a pixel a sample is taken. dx and dy are in [0, 1), measured *
+     *  right and down from the top left corner of the pixel. index counts the*
+     *  samples taken in the pixel before this one.                           */
+    struct pixel_sample {
+        double dx, dy;
+        unsigned int index;
+
+        /*  The sequence the sample comes from and the pixel's scramble seed. */
+        sample_sequence sequence;
+        unsigned int seed;
+
+        /*  Coordinate of the sample in the given dimension, in [0, 1).       *
+         *  Dimensions 0 and 1 are dx and dy, shaders use 2 and up for the    *
+         *  lens and anything else they sample, in a fixed order.             */
+        inline double get(unsigned int dimension) const;
+    };
+
+    /*  Returns sample index of the given sequence in a pixel with the given  *
+     *  scramble seed, see pixel_seed.                                        */
+    inline pixel_sample sequence_sample(sample_sequence sequence,
+                                        unsigned int seed, unsigned int index);
+
+    /*  Returns the position of the sample with the given index. The first    *
+     *  sample is the pixel center, later ones follow the R2 sequence of      *
+     *  Roberts, whose points fill the square evenly for any number of them.  */
+    inline pixel_sample progressive_sample(unsigned int index);
+
+    /*  Budgets for a progressive render. A zero means no limit, but at least *
+     *  one of max_samples and time_budget_ms must be set. With neither, the  *
+     *  render would never end, so render_progressive does nothing and fails.*/
+    struct progressive_options {
+
+        /*  Stop after this many samples per pixel.                           */
+        unsigned int max_samples;
+
+        /*  Stop once this many milliseconds have passed. The pass running at *
+         *  the deadline is cut short, except for the first, which always     *
+         *  completes so that every pixel has a sample.                       */
+        unsigned int time_budget_ms;
+
+        /*  Write a snapshot to snapshot_path at most this often, and once    *
+         *  more at the end. With an interval of zero only the final image is *
+         *  written. Snapshots go to a temporary file which is then renamed,  *
+         *  so a viewer polling the path never sees a partial image.          */
+        unsigned int snapshot_interval_ms;
+        const char *snapshot_path;
+
+        /*  Used for the snapshots.                                           */
+        tonemap_options tonemap;
+
+        /*  Where the samples of each pixel are taken.                        */
+        sample_sequence sequence;
+
+        /*  If not NULL, every tile adds its samples and timing to the        *
+         *  counters of the thread rendering it.                              */
+        telemetry *monitor;
+
+        /*  Sixteen samples per pixel on the R2 sequence, no time budget, no  *
+         *  snapshots, no telemetry.                                          */
+        inline progressive_options(void)
+            : max_samples(16U), time_budget_ms(0U), snapshot_interval_ms(0U),
+              snapshot_path(NULL), sequence(sequence_r2), monitor(NULL)
+        {
+            return;
+        }
+    };
+
+    /*  Statistics returned by render_progressive.                            */
+    struct progressive_result {
+
+        /*  Passes started, including one cut short by the deadline.          */
+        unsigned int passes;
+
+        /*  Snapshots written.                                                */
+        unsigned int snapshots;
+
+        /*  Milliseconds until the first pass, the first usable image, ended. */
+        double first_pass_ms;
+
+        /*  Milliseconds spent in total.                                      */
+        double elapsed_ms;
+
+        /*  False if neither budget was set, or writing a snapshot failed.    */
+        bool ok;
+    };
+
+    /*  Adds passes of one sample per pixel to acc until a budget runs out.   *
+     *  shader(x, y, s) returns the rgb seen through the point s of pixel     *
+     *  (x, y), and must be safe to call from several threads at once. The    *
+     *  buffer may already hold samples, in which case the render continues   *
+     *  from where it left off.                                               */
+    template <class shader_type>
+    inline progressive_result
+    render_progressive(accumulator &acc, const shader_type &shader,
+                       thread_pool &pool, const progressive_options &options,
+                       unsigned int tile_size = default_tile_size);
+
+    /*  Tonemaps acc and writes it to path, via a temporary file. Returns     *
+     *  false on failure.                                                     */
+    inline bool write_snapshot(const accumulator &acc, const char *path,
+                               thread_pool &pool,
+                               const tonemap_options &options);
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  The other dimensions are computed when the shader asks for them.          */
+inline double psow::pixel_sample::get(unsigned int dimension) const
+{
+    if (dimension == 0U)
+        return dx;
+
+    if (dimension == 1U)
+        return dy;
+
+    return sequence_value(sequence, index, dimension, seed);
+}
+
+/*  The first two dimensions are the position in the pixel.                   */
+inline psow::pixel_sample
+psow::sequence_sample(sample_sequence sequence, unsigned int seed,
+                      unsigned int index)
+{
+    pixel_sample s;
+    s.dx = sequence_value(sequence, index, 0U, seed);
+    s.dy = sequence_value(sequence, index, 1U, seed);
+    s.index = index;
+    s.sequence = sequence;
+    s.seed = seed;
+    return s;
+}
+
+/*  The R2 points are the same in every pixel, the seed is unused.            */
+inline psow::pixel_sample psow::progressive_sample(unsigned int index)
+{
+    return sequence_sample(sequence_r2, 0U, index);
+}
+
+/*  The temporary name is unique to this call, so two renders snapshotting to *
+ *  the same path never write into one file.                                  */
+inline bool psow::write_snapshot(const accumulator &acc, const char *path,
+                                 thread_pool &pool,
+                                 const tonemap_options &options)
+{
+    PSOW_TRACE_SCOPE("write_snapshot");
+    std::string temporary;
+    image img(acc.width, acc.height);
+    FILE *fp;
+    bool ok;
+
+    tonemap(acc, img, pool, options);
+    fp = open_temporary(path, temporary);
+
+    if (!fp)
+        return false;
+
+    ok = img.write(fp);
+    return commit_temporary(fp, temporary, path, ok);
+}
+
+/*  Each pass is a set of tiles on the pool, as in psow::accumulate. Every    *
+ *  tile checks the clock before it starts, so a pass that overruns the       *
+ *  deadline stops within one tile per thread. Pixels of the skipped tiles    *
+ *  simply have one sample less, the accumulator keeps a count per pixel.     */
+template <class shader_type>
+inline psow::progressive_result
+psow::render_progressive(accumulator &acc, const shader_type &shader,
+                         thread_pool &pool, const progressive_options &options,
+                         unsigned int tile_size)
+{
+    typedef std::chrono::steady_clock clock;
+
+    unsigned int x, y;
+    const clock::time_point start = clock::now();
+    const clock::time_point deadline =
+        start + std::chrono::milliseconds(options.time_budget_ms);
+    clock::time_point last_snapshot = start;
+    std::atomic<bool> expired(false);
+    progressive_result result;
+
+    /*  Milliseconds between start and a later time.                          */
+    const auto since_start = [&start](clock::time_point t) -> double {
+        return std::chrono::duration<double, std::milli>(t - start).count();
+    };
+
+    result.passes = 0U;
+    result.snapshots = 0U;
+    result.first_pass_ms = 0.0;
+    result.elapsed_ms = 0.0;
+    result.ok = true;
+
+    if (options.max_samples == 0U && options.time_budget_ms == 0U)
+    {
+        result.ok = false;
+        return result;
+    }
+
+    if (tile_size == 0U)
+        tile_size = default_tile_size;
+
+    while (options.max_samples == 0U || result.passes < options.max_samples)
+    {
+        const bool first = (result.passes == 0U);
+
+        for (y = 0U; y < acc.height; y += tile_size)
+        {
+            for (x = 0U; x < acc.width; x += tile_size)
+            {
+                const unsigned int right = acc.width - x;
+                const unsigned int below = acc.height - y;
+                tile t;
+                t.x0 = x;
+                t.y0 = y;
+                t.x1 = (right < tile_size ? acc.width : x + tile_size);
+                t.y1 = (below < tile_size ? acc.height : y + tile_size);
+
+                pool.submit([&, t, first]() {
+                    PSOW_TRACE_SCOPE("progressive_tile");
+                    unsigned int px, py;
+                    telemetry_counters *counters = NULL;
+                    clock::time_point tile_start;
+
+                    if (!first && options.time_budget_ms != 0U)
+                    {
+                        if (expired.load(std::memory_order_relaxed))
+                            return;
+
+                        if (clock::now() >= deadline)
+                        {
+                            expired.store(true, std::memory_order_relaxed);
+                            return;
+                        }
+                    }
+
+                    if (options.monitor)
+                    {
+                        counters = &options.monitor->local();
+                        tile_start = clock::now();
+                    }
+
+                    for (py = t.y0; py < t.y1; ++py)
+                    {
+                        for (px = t.x0; px < t.x1; ++px)
+                        {
+                            const std::size_t n =
+                                static_cast<std::size_t>(py) * acc.width + px;
+                            const unsigned int index =
+                                static_cast<unsigned int>(acc.weight[n]);
+
+                            acc.add(px, py, shader(px, py, sequence_sample(
+                                options.sequence, pixel_seed(px, py), index
+                            )));
+                        }
+                    }
+
+                    if (counters)
+                    {
+                        counters->add_samples(
+                            static_cast<unsigned long long>(t.x1 - t.x0) *
+                            (t.y1 - t.y0)
+                        );
+                        counters->add_tile(nanoseconds_since(tile_start));
+                    }
+                });
+            }
+        }
+
+        pool.wait();
+        ++result.passes;
+
+        const clock::time_point now = clock::now();
+
+        if (first)
+            result.first_pass_ms = since_start(now);
+
+        if (options.time_budget_ms != 0U && now >= deadline)
+            break;
+
+        if (options.snapshot_path && options.snapshot_interval_ms != 0U &&
+            now - last_snapshot >=
+                std::chrono::milliseconds(options.snapshot_interval_ms))
+        {
+            if (write_snapshot(acc, options.snapshot_path, pool,
+                               options.tonemap))
+                ++result.snapshots;
+            else
+                result.ok = false;
+
+            last_snapshot = clock::now();
+        }
+    }
+
+    /*  The final image is always written when snapshots are on.              */
+    if (options.snapshot_path)
+    {
+        if (write_snapshot(acc, options.snapshot_path, pool, options.tonemap))
+            ++result.snapshots;
+        else
+            result.ok = false;
+    }
+
+    result.elapsed_ms = since_start(clock::now());
+    return result;
+}
+/*  End of render_progressive.                                                */
+
+#endif
+/*  End of include guard.                                                     */
@@ -0,0 +1,411 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides small, fast random number generators, a stateful one (PCG32) *
+ *      and a counter-based one (Philox), and the random directions the path  *
+ *      tracer samples with them, one at a time or in batches.                *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_RANDOM_HPP
+#define PSOW_RANDOM_HPP
+
+/*  std::sqrt, std::cos, std::sin, std::fabs, and std::copysign.              */
+#include <cmath>
+
+/*  std::size_t is found here.                                                */
+#include <cstddef>
+
+/*  vec3 struct provided here.                                                */
+#include "psow_vec3.hpp"
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  O'Neill's PCG32 (XSH-RR): a 64-bit linear congruential state with a   *
+     *  permuted 32-bit output. The whole generator is two integers, so each  *
+     *  thread keeps its own on the stack and nothing is shared or allocated. *
+     *  Different streams from the same seed are independent sequences.       */
+    struct pcg32 {
+        unsigned long long state, increment;
+
+        /*  Constructor from a seed and a stream number.                      */
+        inline pcg32(unsigned long long seed, unsigned long long stream = 0ULL);
+
+        /*  Next 32 random bits.                                              */
+        inline unsigned int next(void);
+
+        /*  Uniform double in [0, 1).                                         */
+        inline double uniform(void);
+
+        /*  Uniform double in [lo, hi).                                       */
+        inline double uniform(double lo, double hi);
+
+        /*  Writes n uniform doubles in [0, 1) to out.                        */
+        inline void fill_uniform(double *out, std::size_t n);
+    };
+    /*  End of pcg32 definition.                                              */
+
+    /*  Philox4x32-10, of Salmon, Moraes, Dror, and Shaw. Counter-based: each *
+     *  block of four 32-bit outputs is a fixed function (ten rounds of       *
+     *  multiplies and xors) of a 128-bit counter and a 64-bit key. The       *
+     *  counter holds the pixel, the sample, and the block number, so the     *
+     *  numbers a sample uses depend only on which sample it is, never on     *
+     *  which thread draws them or in what order. Blocks with different       *
+     *  counters are independent, which lets fill_uniform hash several of     *
+     *  them at once in SIMD lanes.                                           */
+    struct philox_rng {
+
+        /*  The key is the seed. counter[0] numbers the blocks of the stream, *
+         *  counter[1] is the sample, and counter[2], counter[3] the pixel.   */
+        unsigned int key[2];
+        unsigned int counter[4];
+
+        /*  Outputs of the current block not handed out yet.                  */
+        unsigned int buffer[4];
+        unsigned int available;
+
+        /*  Constructor for the stream of a given sample of a given pixel.    *
+         *  Each stream holds 2^34 numbers before it wraps around.            */
+        inline philox_rng(unsigned long long seed, unsigned long long pixel,
+                          unsigned int sample);
+
+        /*  Hashes a counter with a key into four 32-bit outputs.             */
+        static inline void block(const unsigned int ctr[4],
+                                 const unsigned int k[2],
+                                 unsigned int out[4]);
+
+        /*  Next 32 random bits.                                              */
+        inline unsigned int next(void);
+
+        /*  Uniform double in [0, 1).                                         */
+        inline double uniform(void);
+
+        /*  Uniform double in [lo, hi).                                       */
+        inline double uniform(double lo, double hi);
+
+        /*  Writes n uniform doubles in [0, 1) to out, hashing the blocks     *
+         *  they come from in a loop the compiler can vectorize. Numbers left *
+         *  in the buffer are discarded, the batch starts at a fresh block.   */
+        inline void fill_uniform(double *out, std::size_t n);
+    };
+    /*  End of philox_rng definition.                                         */
+
+    /*  Sine and cosine of 2 pi u for u in [0, 1), by polynomials with no     *
+     *  branches and no library calls, so loops calling it vectorize. The     *
+     *  error is below 10^-7.                                                 */
+    inline void sin_cos_turn(double u, double &s, double &c);
+
+    /*  Fills out with n points uniformly distributed on the unit sphere.     */
+    template <class rng_type>
+    inline void unit_vector_batch(rng_type &rng, vec3 *out, std::size_t n);
+
+    /*  Fills out with n unit vectors uniformly distributed on the hemisphere *
+     *  about the unit normal n_hat.                                          */
+    template <class rng_type>
+    inline void hemisphere_batch(rng_type &rng, const vec3 &n_hat,
+                                 vec3 *out, std::size_t n);
+
+    /*  Fills out with n directions, not normalized, distributed as cos(theta)*
+     *  about the unit normal n_hat. These are the Lambertian directions.     */
+    template <class rng_type>
+    inline void cosine_batch(rng_type &rng, const vec3 &n_hat,
+                             vec3 *out, std::size_t n);
+
+    /*  Uniformly distributed point on the unit sphere.                       */
+    template <class rng_type>
+    inline vec3 random_unit_vector(rng_type &rng);
+
+    /*  Uniformly distributed point in the unit disk of the xy plane.         */
+    template <class rng_type>
+    inline vec3 random_in_unit_disk(rng_type &rng);
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  The stream selects the increment, which must be odd.                      */
+inline psow::pcg32::pcg32(unsigned long long seed, unsigned long long stream)
+    : state(0ULL), increment((stream << 1) | 1ULL)
+{
+    next();
+    state += seed;
+    next();
+}
+
+/*  Advance the LCG, then rotate the xorshifted high bits by the top 5 bits.  */
+inline unsigned int psow::pcg32::next(void)
+{
+    const unsigned long long old = state;
+    const unsigned int shifted =
+        static_cast<unsigned int>(((old >> 18) ^ old) >> 27);
+    const unsigned int rotation = static_cast<unsigned int>(old >> 59);
+
+    state = old * 6364136223846793005ULL + increment;
+    return (shifted >> rotation) | (shifted << ((32U - rotation) & 31U));
+}
+
+/*  32 bits are plenty for sampling, the divisor is 2^32.                     */
+inline double psow::pcg32::uniform(void)
+{
+    return static_cast<double>(next()) / 4294967296.0;
+}
+
+/*  Scale and shift the unit interval.                                        */
+inline double psow::pcg32::uniform(double lo, double hi)
+{
+    return lo + (hi - lo) * uniform();
+}
+
+/*  The stateful generator can only produce its numbers in order.             */
+inline void psow::pcg32::fill_uniform(double *out, std::size_t n)
+{
+    std::size_t k;
+
+    for (k = 0; k < n; ++k)
+        out[k] = uniform();
+}
+
+/*  The key is the 64-bit seed, split in halves, as is the pixel.             */
+inline psow::philox_rng::philox_rng(unsigned long long seed,
+                                    unsigned long long pixel,
+                                    unsigned int sample)
+    : available(0U)
+{
+    key[0] = static_cast<unsigned int>(seed);
+    key[1] = static_cast<unsigned int>(seed >> 32);
+    counter[0] = 0U;
+    counter[1] = sample;
+    counter[2] = static_cast<unsigned int>(pixel);
+    counter[3] = static_cast<unsigned int>(pixel >> 32);
+    buffer[0] = buffer[1] = buffer[2] = buffer[3] = 0U;
+}
+
+/*  Each round multiplies two words by fixed odd constants and mixes the high *
+ *  and low halves of the products with the other words and the key, which is *
+ *  bumped by the Weyl constants between rounds.                              */
+inline void psow::philox_rng::block(const unsigned int ctr[4],
+                                    const unsigned int k[2],
+                                    unsigned int out[4])
+{
+    const unsigned long long m0 = 0xD2511F53ULL;
+    const unsigned long long m1 = 0xCD9E8D57ULL;
+    unsigned int c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+    unsigned int k0 = k[0], k1 = k[1];
+    unsigned int round;
+
+    for (round = 0U; round < 10U; ++round)
+    {
+        const unsigned long long p0 = m0 * c0;
+        const unsigned long long p1 = m1 * c2;
+        const unsigned int hi0 = static_cast<unsigned int>(p0 >> 32);
+        const unsigned int lo0 = static_cast<unsigned int>(p0);
+        const unsigned int hi1 = static_cast<unsigned int>(p1 >> 32);
+        const unsigned int lo1 = static_cast<unsigned int>(p1);
+
+        c0 = hi1 ^ c1 ^ k0;
+        c1 = lo1;
+        c2 = hi0 ^ c3 ^ k1;
+        c3 = lo0;
+        k0 += 0x9E3779B9U;
+        k1 += 0xBB67AE85U;
+    }
+
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
+/*  Hash the next block once the last one is used up.                         */
+inline unsigned int psow::philox_rng::next(void)
+{
+    if (available == 0U)
+    {
+        block(counter, key, buffer);
+        ++counter[0];
+        available = 4U;
+    }
+
+    --available;
+    return buffer[3U - available];
+}
+
+/*  32 bits are plenty for sampling, the divisor is 2^32.                     */
+inline double psow::philox_rng::uniform(void)
+{
+    return static_cast<double>(next()) / 4294967296.0;
+}
+
+/*  Scale and shift the unit interval.                                        */
+inline double psow::philox_rng::uniform(double lo, double hi)
+{
+    return lo + (hi - lo) * uniform();
+}
+
+/*  The blocks are done a chunk at a time. Within a chunk the loop over the   *
+ *  blocks has no dependencies between iterations, each hashes its own        *
+ *  counter, and the rounds are unrolled into straight-line integer code.     */
+inline void psow::philox_rng::fill_uniform(double *out, std::size_t n)
+{
+    const std::size_t chunk = 64;
+    unsigned int bits[4 * chunk];
+    std::size_t start, b, k;
+
+    available = 0U;
+
+    for (start = 0; start < n; start += 4 * chunk)
+    {
+        const std::size_t left = n - start;
+        const std::size_t count = (left < 4 * chunk ? left : 4 * chunk);
+        const std::size_t blocks = (count + 3) / 4;
+
+        for (b = 0; b < blocks; ++b)
+        {
+            const unsigned int ctr[4] = {
+                counter[0] + static_cast<unsigned int>(b),
+                counter[1], counter[2], counter[3]
+            };
+
+            block(ctr, key, bits + 4 * b);
+        }
+
+        counter[0] += static_cast<unsigned int>(blocks);
+
+        for (k = 0; k < count; ++k)
+            out[start + k] = static_cast<double>(bits[k]) / 4294967296.0;
+    }
+}
+
+/*  Write 2 pi u - pi = t, whose sine and cosine are the negatives of the ones*
+ *  wanted. Folding |t| into r in [0, pi/2] with sin(|t|) = sin(r) and        *
+ *  cos(|t|) = -+cos(r), the Taylor series to r^11 and r^12 are accurate to   *
+ *  4 x 10^-8 and 7 x 10^-9.                                                  */
+inline void psow::sin_cos_turn(double u, double &s, double &c)
+{
+    const double pi = 3.141592653589793;
+    const double t = 2.0 * pi * u - pi;
+    const double a = std::fabs(t);
+    const double r = (a < pi - a ? a : pi - a);
+    const double r2 = r * r;
+
+    const double sin_r = r * (1.0 + r2 * (-1.0 / 6.0 + r2 * (1.0 / 120.0 +
+                         r2 * (-1.0 / 5040.0 + r2 * (1.0 / 362880.0 +
+                         r2 * (-1.0 / 39916800.0))))));
+
+    const double cos_r = 1.0 + r2 * (-0.5 + r2 * (1.0 / 24.0 +
+                         r2 * (-1.0 / 720.0 + r2 * (1.0 / 40320.0 +
+                         r2 * (-1.0 / 3628800.0 + r2 / 479001600.0)))));
+
+    /*  Both values are signs applied with copysign, there are no branches.   */
+    s = std::copysign(sin_r, -t);
+    c = std::copysign(cos_r, a - 0.5 * pi);
+}
+
+/*  Archimedes: z is uniform in [-1, 1] on the sphere, and the angle around   *
+ *  the z axis is uniform. Unlike rejection sampling this always takes two    *
+ *  numbers, so the loop in the caller has no data-dependent branches.        */
+template <class rng_type>
+inline psow::vec3 psow::random_unit_vector(rng_type &rng)
+{
+    const double two_pi = 6.283185307179586;
+    const double z = 2.0 * rng.uniform() - 1.0;
+    const double phi = two_pi * rng.uniform();
+    const double rho = std::sqrt(1.0 - z*z);
+    return psow::vec3(rho * std::cos(phi), rho * std::sin(phi), z);
+}
+
+/*  The square root of a uniform variable as the radius makes the area, not   *
+ *  the radius, uniform.                                                      */
+template <class rng_type>
+inline psow::vec3 psow::random_in_unit_disk(rng_type &rng)
+{
+    const double two_pi = 6.283185307179586;
+    const double rho = std::sqrt(rng.uniform());
+    const double phi = two_pi * rng.uniform();
+    return psow::vec3(rho * std::cos(phi), rho * std::sin(phi), 0.0);
+}
+
+/*  The uniforms are drawn in one batch, the heights first and the angles     *
+ *  after, and turned into points by Archimedes' method as in                 *
+ *  random_unit_vector, with the sine and cosine from sin_cos_turn so that    *
+ *  the loop vectorizes.                                                      */
+template <class rng_type>
+inline void psow::unit_vector_batch(rng_type &rng, psow::vec3 *out,
+                                    std::size_t n)
+{
+    const std::size_t chunk = 128;
+    double u[2 * chunk];
+    double x[chunk], y[chunk], z[chunk];
+    std::size_t start, k;
+
+    for (start = 0; start < n; start += chunk)
+    {
+        const std::size_t left = n - start;
+        const std::size_t count = (left < chunk ? left : chunk);
+
+        rng.fill_uniform(u, 2 * count);
+
+        for (k = 0; k < count; ++k)
+        {
+            double s, c;
+            const double height = 2.0 * u[k] - 1.0;
+            const double rho = std::sqrt(1.0 - height * height);
+            sin_cos_turn(u[count + k], s, c);
+            x[k] = rho * c;
+            y[k] = rho * s;
+            z[k] = height;
+        }
+
+        for (k = 0; k < count; ++k)
+            out[start + k] = psow::vec3(x[k], y[k], z[k]);
+    }
+}
+
+/*  Points of the sphere on the wrong side of the plane are reflected through *
+ *  the origin, which is a select rather than a retry.                        */
+template <class rng_type>
+inline void psow::hemisphere_batch(rng_type &rng, const psow::vec3 &n_hat,
+                                   psow::vec3 *out, std::size_t n)
+{
+    std::size_t k;
+
+    unit_vector_batch(rng, out, n);
+
+    for (k = 0; k < n; ++k)
+    {
+        const double flip = (out[k].dot(n_hat) < 0.0 ? -1.0 : 1.0);
+        out[k] = out[k] * flip;
+    }
+}
+
+/*  The normal plus a uniform unit vector, as in the Lambertian material.     */
+template <class rng_type>
+inline void psow::cosine_batch(rng_type &rng, const psow::vec3 &n_hat,
+                               psow::vec3 *out, std::size_t n)
+{
+    std::size_t k;
+
+    unit_vector_batch(rng, out, n);
+
+    for (k = 0; k < n; ++k)
+        out[k] += n_hat;
+}
+
+#endif
+/*  End of include guard.                                                     */
@@ -31,50 +31,64 @@
 /*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
 namespace psow {
 
-    /*  Struct for rays which are Affine subspaces of R^3, L = {A+tB, t real}.*/
-    struct ray {
+    /*  Struct for rays which are Affine subspaces of R^3, L = {A+tB, t real}.*
+     *  The components are of type real, see the ray and rayf aliases.        */
+    template <class real>
+    struct basic_ray {
 
         /*  A ray is the set of all points of the form p + tv, where p and v  *
          *  are vectors and t is a real number.                               */
-        vec3 p, v;
+        basic_vec3<real> p, v;
 
-        /*  Empty construct, simply return.                                   */
-        inline ray(void)
+        /*  Empty constructor, the vectors are left uninitialized.            */
+        basic_ray(void) = default;
+
+        /*  Constructor from a starting point and a direction.                */
+        constexpr basic_ray(const basic_vec3<real> &P,
+                            const basic_vec3<real> &V)
+            : p(P), v(V)
         {
-            return;
         }
 
-        /*  Constructor from a starting point and a direction.                */
-        inline ray(const vec3 &P, const vec3 &V)
+        /*  Conversion from a ray of another precision.                       */
+        template <class other>
+        constexpr explicit basic_ray(const basic_ray<other> &r)
+            : p(r.p), v(r.v)
         {
-            p = P;
-            v = V;
         }
 
         /*  Computes a point on a ray from a real parameter. p + t*v.         */
-        inline vec3 point(double t) const;
+        constexpr basic_vec3<real> point(real t) const;
 
         /*  Function for creating a ray from two points on the ray.           */
-        inline ray from_points(const vec3 &P, const vec3 &V);
+        inline basic_ray from_points(const basic_vec3<real> &P,
+                                     const basic_vec3<real> &V);
     };
-    /*  End of ray struct.                                                    */
+    /*  End of basic_ray struct.                                              */
+
+    /*  Double and single precision rays.                                     */
+    typedef basic_ray<double> ray;
+    typedef basic_ray<float> rayf;
 }
 /*  End of "psow" namespace.                                                  */
 
 /*  Function for compute the point p + tv on the ray.                         */
-inline psow::vec3 psow::ray::point(double t) const
+template <class real>
+constexpr psow::basic_vec3<real> psow::basic_ray<real>::point(real t) const
 {
     return p + v*t;
 }
 
 
 /*  Creates a ray from two points that fall on it.                            */
-inline psow::ray
-psow::ray::from_points(const psow::vec3 &A, const psow::vec3 &B)
+template <class real>
+inline psow::basic_ray<real>
+psow::basic_ray<real>::from_points(const psow::basic_vec3<real> &A,
+                                   const psow::basic_vec3<real> &B)
 {
     /*  A tangent vector for the ray is given by the relative positive        *
      *  vector going from A to B. Compute this ray.                           */
-    return psow::ray(A, B-A);
+    return psow::basic_ray<real>(A, B-A);
 }
 
 #endif
@@ -0,0 +1,87 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides a structure-of-arrays packet of rays.                        *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_RAY_PACKET_HPP
+#define PSOW_RAY_PACKET_HPP
+
+/*  vec3 struct provided here.                                                */
+#include "psow_vec3.hpp"
+
+/*  ray struct given here.                                                    */
+#include "psow_ray.hpp"
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  A packet of N rays stored component by component, so that lane i of   *
+     *  every array belongs to ray i. This is the layout SIMD registers want. *
+     *  The hit masks returned by the packet kernels have one bit per ray, so *
+     *  N may be at most 32.                                                  */
+    template <unsigned int N>
+    struct ray_packet {
+        static_assert(N > 0U && N <= 32U, "ray_packet size must be 1 to 32");
+
+        /*  Number of rays in the packet.                                     */
+        static const unsigned int size = N;
+
+        /*  Components of the starting points p and directions v of the rays. */
+        alignas(64) double px[N];
+        alignas(64) double py[N];
+        alignas(64) double pz[N];
+        alignas(64) double vx[N];
+        alignas(64) double vy[N];
+        alignas(64) double vz[N];
+
+        /*  Stores a ray in lane i.                                           */
+        inline void set(unsigned int i, const ray &r);
+
+        /*  Returns the ray stored in lane i.                                 */
+        inline ray get(unsigned int i) const;
+    };
+    /*  End of ray_packet definition.                                         */
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  Scatter the components of the ray into the arrays.                        */
+template <unsigned int N>
+inline void psow::ray_packet<N>::set(unsigned int i, const psow::ray &r)
+{
+    px[i] = r.p.x;
+    py[i] = r.p.y;
+    pz[i] = r.p.z;
+    vx[i] = r.v.x;
+    vy[i] = r.v.y;
+    vz[i] = r.v.z;
+}
+
+/*  Gather the components back into a ray.                                    */
+template <unsigned int N>
+inline psow::ray psow::ray_packet<N>::get(unsigned int i) const
+{
+    return psow::ray(psow::vec3(px[i], py[i], pz[i]),
+                     psow::vec3(vx[i], vy[i], vz[i]));
+}
+
+#endif
+/*  End of include guard.                                                     */
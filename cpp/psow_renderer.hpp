@@ -0,0 +1,179 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides a multithreaded, tile-based renderer.                        *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_RENDERER_HPP
+#define PSOW_RENDERER_HPP
+
+/*  strcmp and strtoul, used for parsing the command line.                    */
+#include <cstdlib>
+#include <cstring>
+
+/*  color struct provided here.                                               */
+#include "psow_color.hpp"
+
+/*  The framebuffer the renderer writes into.                                 */
+#include "psow_image.hpp"
+
+/*  The tiles are scheduled on a work-stealing thread pool.                   */
+#include "psow_thread_pool.hpp"
+
+/*  PSOW_TRACE_SCOPE, compiled out unless PSOW_TRACE is set.                  */
+#include "psow_trace.hpp"
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  A rectangular block of pixels, [x0, x1) x [y0, y1).                   */
+    struct tile {
+        unsigned int x0, y0, x1, y1;
+    };
+
+    /*  Default width and height of a tile, in pixels. 32x32 tiles are small  *
+     *  enough to balance the load across many cores, and large enough that   *
+     *  the cost of scheduling them is negligible.                            */
+    const unsigned int default_tile_size = 32U;
+
+    /*  Renders every pixel of an image by calling shader(x, y), which must   *
+     *  return a psow::color and be safe to call from several threads at once.*
+     *  Row zero is the top row of the image.                                 */
+    template <class shader_type>
+    inline void
+    render(image &img, const shader_type &shader, thread_pool &pool,
+           unsigned int tile_size = default_tile_size);
+
+    /*  Renders the pixels of a single tile.                                  */
+    template <class shader_type>
+    inline void
+    render_tile(image &img, const shader_type &shader, const tile &t);
+
+    /*  Parses "--threads N" from the command line. Returns the number of     *
+     *  hardware threads if the option is absent, and zero if it is malformed.*/
+    inline unsigned int thread_count_from_args(int argc, char **argv);
+
+    /*  Parses "flag N" from the command line into value, which is left alone *
+     *  if the option is absent. Returns false if the option is malformed.    */
+    inline bool unsigned_from_args(int argc, char **argv, const char *flag,
+                                   unsigned int &value);
+
+    /*  Returns true if the given option, such as "--mmap", is in argv.       */
+    inline bool flag_from_args(int argc, char **argv, const char *flag);
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  Each tile writes to a disjoint part of the image, so no locking is needed.*/
+template <class shader_type>
+inline void
+psow::render_tile(image &img, const shader_type &shader, const tile &t)
+{
+    PSOW_TRACE_SCOPE("render_tile");
+    unsigned int x, y;
+
+    for (y = t.y0; y < t.y1; ++y)
+        for (x = t.x0; x < t.x1; ++x)
+            img.set(x, y, shader(x, y));
+}
+
+/*  Splits the image into tiles and hands them to the pool.                   */
+template <class shader_type>
+inline void
+psow::render(image &img, const shader_type &shader, thread_pool &pool,
+             unsigned int tile_size)
+{
+    unsigned int x, y;
+
+    if (tile_size == 0U)
+        tile_size = default_tile_size;
+
+    for (y = 0U; y < img.height; y += tile_size)
+    {
+        for (x = 0U; x < img.width; x += tile_size)
+        {
+            tile t;
+            t.x0 = x;
+            t.y0 = y;
+            t.x1 = (x + tile_size < img.width ? x + tile_size : img.width);
+            t.y1 = (y + tile_size < img.height ? y + tile_size : img.height);
+
+            pool.submit([&img, &shader, t]() {
+                render_tile(img, shader, t);
+            });
+        }
+    }
+
+    pool.wait();
+}
+
+/*  Looks for "--threads N" in argv.                                          */
+inline unsigned int psow::thread_count_from_args(int argc, char **argv)
+{
+    unsigned int count = thread_pool::hardware_threads();
+
+    if (!unsigned_from_args(argc, argv, "--threads", count))
+        return 0U;
+
+    return count;
+}
+
+/*  Looks for the flag in argv and parses the number following it. Zero is    *
+ *  rejected along with anything that is not a number.                        */
+inline bool psow::unsigned_from_args(int argc, char **argv, const char *flag,
+                                     unsigned int &value)
+{
+    int n;
+
+    for (n = 1; n < argc; ++n)
+    {
+        if (std::strcmp(argv[n], flag) != 0)
+            continue;
+
+        if (n + 1 == argc)
+            return false;
+
+        char *end;
+        const unsigned long number = std::strtoul(argv[n + 1], &end, 10);
+
+        if (*end != '\0' || number == 0UL)
+            return false;
+
+        value = static_cast<unsigned int>(number);
+        return true;
+    }
+
+    return true;
+}
+
+/*  Plain linear search, the command lines here are short.                    */
+inline bool psow::flag_from_args(int argc, char **argv, const char *flag)
+{
+    int n;
+
+    for (n = 1; n < argc; ++n)
+        if (std::strcmp(argv[n], flag) == 0)
+            return true;
+
+    return false;
+}
+
+#endif
+/*  End of include guard.                                                     */
@@ -0,0 +1,101 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides a linear, unclamped RGB radiance triple.                     *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_RGB_HPP
+#define PSOW_RGB_HPP
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  Linear radiance carried by a ray, one value per channel. Unlike       *
+     *  psow::color the channels are real numbers that are never clamped, so  *
+     *  sums and products are exact up to rounding. Values of 1 map to full   *
+     *  intensity after tonemapping, larger values are brighter than white.   */
+    struct rgb {
+        double r, g, b;
+
+        /*  Empty constructor. The channels are left uninitialized.           */
+        rgb(void) = default;
+
+        /*  Constructor from the three channels. It and the operators that    *
+         *  return a value are constexpr, for colors fixed at compile time.   */
+        constexpr rgb(double red, double green, double blue)
+            : r(red), g(green), b(blue)
+        {
+        }
+    };
+    /*  End of rgb definition.                                                */
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  Channelwise addition.                                                     */
+constexpr psow::rgb operator + (const psow::rgb &P, const psow::rgb &Q)
+{
+    return psow::rgb(P.r + Q.r, P.g + Q.g, P.b + Q.b);
+}
+
+/*  Channelwise addition.                                                     */
+inline void operator += (psow::rgb &P, const psow::rgb &Q)
+{
+    P.r += Q.r;
+    P.g += Q.g;
+    P.b += Q.b;
+}
+
+/*  Channelwise product, used for filtering light through a surface.          */
+constexpr psow::rgb operator * (const psow::rgb &P, const psow::rgb &Q)
+{
+    return psow::rgb(P.r * Q.r, P.g * Q.g, P.b * Q.b);
+}
+
+/*  Channelwise product.                                                      */
+inline void operator *= (psow::rgb &P, const psow::rgb &Q)
+{
+    P.r *= Q.r;
+    P.g *= Q.g;
+    P.b *= Q.b;
+}
+
+/*  Scalar multiplication operator.                                           */
+constexpr psow::rgb operator * (const psow::rgb &P, double a)
+{
+    return psow::rgb(P.r * a, P.g * a, P.b * a);
+}
+
+/*  Scalar multiplication operator.                                           */
+constexpr psow::rgb operator * (double a, const psow::rgb &P)
+{
+    return psow::rgb(a * P.r, a * P.g, a * P.b);
+}
+
+/*  Scalar multiplication operator.                                           */
+inline void operator *= (psow::rgb &P, double a)
+{
+    P.r *= a;
+    P.g *= a;
+    P.b *= a;
+}
+
+#endif
+/*  End of include guard.                                                     */
@@ -0,0 +1,162 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides a scene: spheres, their materials, and the BVH over them.    *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_SCENE_HPP
+#define PSOW_SCENE_HPP
+
+/*  std::size_t is found here.                                                */
+#include <cstddef>
+
+/*  std::vector, used for the material table.                                 */
+#include <vector>
+
+/*  The material indices, like the spheres, may be mapped from a file.       */
+#include "psow_mappable_array.hpp"
+
+/*  ray struct given here.                                                    */
+#include "psow_ray.hpp"
+
+/*  sphere struct provided here.                                              */
+#include "psow_sphere.hpp"
+
+/*  The spheres are stored as a structure of arrays.                          */
+#include "psow_sphere_list.hpp"
+
+/*  The hierarchy used to find hits quickly.                                  */
+#include "psow_bvh.hpp"
+
+/*  hit_record struct, filled in by scene::hit.                               */
+#include "psow_hit_record.hpp"
+
+/*  material struct, one per sphere.                                          */
+#include "psow_material.hpp"
+
+/*  The BVH can be built on a thread pool.                                    */
+#include "psow_thread_pool.hpp"
+
+/*  PSOW_TRACE_SCOPE, compiled out unless PSOW_TRACE is set.                  */
+#include "psow_trace.hpp"
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  A list of spheres, each with a material. Materials live in a table    *
+     *  and spheres refer to them by index, so many spheres can share one.    */
+    struct scene {
+        sphere_list spheres;
+
+        /*  material_of[i] is the index in materials of sphere i's material.  */
+        mappable_array<unsigned int> material_of;
+        std::vector<material> materials;
+
+        /*  Hierarchy over the spheres, see build.                            */
+        bvh tree;
+
+        /*  Adds a material to the table and returns its index.               */
+        inline unsigned int add_material(const material &m);
+
+        /*  Adds a sphere made of the material with the given index.          */
+        inline void add(const sphere &s, unsigned int material_index);
+
+        /*  Builds the BVH. Call this after the last sphere is added. Until   *
+         *  it is built, or if spheres are added afterwards, hit falls back   *
+         *  to the linear search of the sphere list.                          */
+        inline void build(const bvh_options &options = bvh_options());
+
+        /*  Same as above, using every thread of the pool.                    */
+        inline void build(thread_pool &pool,
+                          const bvh_options &options = bvh_options());
+
+        /*  Finds the nearest hit of r with t in (t_min, t_max). rec.index is *
+         *  the index of the sphere that was hit.                             */
+        inline bool hit(const ray &r, double t_min, double t_max,
+                        hit_record &rec) const;
+
+        /*  Same as above, and adds the number of boxes and spheres tested to *
+         *  tests.                                                            */
+        inline bool hit(const ray &r, double t_min, double t_max,
+                        hit_record &rec, unsigned long long &tests) const;
+
+        /*  The material of the sphere in a hit record.                       */
+        inline const material &material_of_hit(const hit_record &rec) const;
+    };
+    /*  End of scene definition.                                              */
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  New materials go at the end of the table.                                 */
+inline unsigned int psow::scene::add_material(const material &m)
+{
+    materials.push_back(m);
+    return static_cast<unsigned int>(materials.size() - 1);
+}
+
+/*  The sphere and its material index are appended side by side.              */
+inline void psow::scene::add(const sphere &s, unsigned int material_index)
+{
+    spheres.add(s);
+    material_of.push_back(material_index);
+}
+
+/*  Serial build.                                                             */
+inline void psow::scene::build(const bvh_options &options)
+{
+    tree.build(spheres, options);
+}
+
+/*  Parallel build.                                                           */
+inline void psow::scene::build(thread_pool &pool, const bvh_options &options)
+{
+    tree.build(spheres, options, pool);
+}
+
+/*  The tree is current if it indexes every sphere of the list.               */
+inline bool psow::scene::hit(const ray &r, double t_min, double t_max,
+                             hit_record &rec, unsigned long long &tests) const
+{
+    PSOW_TRACE_SCOPE("scene::hit");
+
+    if (tree.indices.size() == spheres.size())
+        return tree.hit(r, t_min, t_max, rec, tests);
+
+    return spheres.hit(r, t_min, t_max, rec, tests);
+}
+
+/*  Without counting the tests.                                               */
+inline bool psow::scene::hit(const ray &r, double t_min, double t_max,
+                             hit_record &rec) const
+{
+    unsigned long long tests = 0ULL;
+    return hit(r, t_min, t_max, rec, tests);
+}
+
+/*  Two lookups, sphere to material index to material.                        */
+inline const psow::material &
+psow::scene::material_of_hit(const hit_record &rec) const
+{
+    return materials[material_of[rec.index]];
+}
+
+#endif
+/*  End of include guard.                                                     */
@@ -0,0 +1,823 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides scene files. The text format is for writing scenes by hand,  *
+ *      one material or sphere per line. The binary format stores the         *
+ *      component arrays of the spheres exactly as psow::sphere_list keeps    *
+ *      them in memory, so a mapped file is used in place: opening a scene of *
+ *      millions of spheres parses and copies nothing.                        *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_SCENE_FILE_HPP
+#define PSOW_SCENE_FILE_HPP
+
+/*  std::isfinite, for checking the numbers of the materials.                 */
+#include <cmath>
+
+/*  Fixed-width integers for the binary header.                               */
+#include <cstdint>
+
+/*  fopen, fread, fwrite, and fprintf.                                        */
+#include <cstdio>
+
+/*  strtod, for the numbers of the text format.                               */
+#include <cstdlib>
+
+/*  memcmp and strcmp, for the magic number and the keywords.                 */
+#include <cstring>
+
+/*  std::map, from material names to indices while reading text.              */
+#include <map>
+
+/*  std::string, the material names.                                          */
+#include <string>
+
+/*  std::vector, used for the contents of a text file.                        */
+#include <vector>
+
+/*  The scene that is read or written.                                        */
+#include "psow_scene.hpp"
+
+/*  Binary scenes are mapped with the POSIX calls open, fstat, and mmap.      */
+#if defined(__unix__) || defined(__APPLE__)
+#define PSOW_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define PSOW_HAS_MMAP 0
+#endif
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  The text format. Everything after a # is a comment, blank lines are   *
+     *  skipped, and the fields are separated by white space. Materials are   *
+     *  named and must be defined before the spheres that use them:           *
+     *      material NAME lambertian R G B                                    *
+     *      material NAME metal R G B FUZZ                                    *
+     *      material NAME dielectric INDEX                                    *
+     *      sphere X Y Z RADIUS MATERIAL                                      *
+     *  The binary format starts with a scene_file_header. Every array begins *
+     *  at a multiple of 64 bytes into the file, so once mapped it is aligned *
+     *  to a cache line, as sphere_list aligns its own arrays. The numbers    *
+     *  are in the byte order of the machine that wrote the file, and files   *
+     *  of the other order are rejected.                                      */
+    struct scene_file_header {
+
+        /*  "PSOWSCN" followed by a zero byte.                                */
+        char magic[8];
+
+        /*  scene_file_version, and 0x01020304 as written by the machine.     */
+        std::uint32_t version;
+        std::uint32_t byte_order;
+
+        std::uint64_t sphere_count;
+        std::uint64_t material_count;
+
+        /*  Byte offsets of the arrays: sphere_count doubles for each of cx,  *
+         *  cy, cz, and radius, sphere_count 32-bit material indices, and     *
+         *  material_count scene_file_material records.                       */
+        std::uint64_t cx, cy, cz, radius, material_of, materials;
+    };
+
+    /*  A material as stored in a binary file.                                */
+    struct scene_file_material {
+        std::uint32_t kind;
+        std::uint32_t reserved;
+        double albedo[3];
+        double fuzz;
+        double refraction_index;
+    };
+
+    /*  The layout of the records must not depend on the compiler.            */
+    static_assert(sizeof(scene_file_header) == 80 &&
+                  sizeof(scene_file_material) == 48 &&
+                  sizeof(unsigned int) == 4,
+                  "unexpected sizes for the binary scene format");
+
+    /*  Version of the binary format written by write_scene_binary.           */
+    const std::uint32_t scene_file_version = 1U;
+
+    /*  Reads a text scene into world, replacing what it held. Returns false  *
+     *  if the file cannot be read or has an error, in which case error_line, *
+     *  if not NULL, is set to the line of the error, or zero if the file     *
+     *  could not be read at all.                                             */
+    inline bool read_scene_text(const char *path, scene &world,
+                                unsigned long *error_line = NULL);
+
+    /*  Writes the spheres and materials of world as text. Materials are named*
+     *  m0, m1, and so on. Returns false on failure.                          */
+    inline bool write_scene_text(const char *path, const scene &world);
+
+    /*  Writes the spheres and materials of world in the binary format.       *
+     *  Returns false on failure.                                             */
+    inline bool write_scene_binary(const char *path, const scene &world);
+
+    /*  Reads a binary scene into world, copying it. Works on every platform, *
+     *  mapped_scene avoids the copy where mmap is available. Returns false on*
+     *  failure.                                                              */
+    inline bool read_scene_binary(const char *path, scene &world);
+
+    /*  True if the file at path starts with the magic number of a binary     *
+     *  scene.                                                                */
+    inline bool is_binary_scene(const char *path);
+
+    /*  Checks that a header describes a binary scene that fits in a file of  *
+     *  the given size.                                                       */
+    inline bool valid_scene_header(const scene_file_header &header,
+                                   std::uint64_t file_size);
+
+#if PSOW_HAS_MMAP
+
+    /*  A binary scene mapped into memory. The arrays of the scene point into *
+     *  the mapping, so the scene must not be used after the mapping is       *
+     *  closed. The mapping is private: changing a sphere of the scene changes*
+     *  the process's copy of that page, never the file.                      */
+    class mapped_scene {
+        public:
+
+            /*  Empty constructor. Nothing is mapped.                         */
+            inline mapped_scene(void);
+
+            /*  Unmaps the file if needed.                                    */
+            inline ~mapped_scene(void);
+
+            /*  Maps the binary scene at path and makes world use it,         *
+             *  replacing what world held. Pages are only read from disk as   *
+             *  they are touched. The material indices are checked against the*
+             *  table, the one pass over the file this makes. Returns false on*
+             *  failure, leaving world empty.                                 */
+            inline bool open(const char *path, scene &world);
+
+            /*  Unmaps the file. Returns false on failure.                    */
+            inline bool close(void);
+
+        private:
+            unsigned char *map;
+            std::size_t length;
+
+            /*  A mapping cannot be shared between two owners.                */
+            mapped_scene(const mapped_scene &);
+            mapped_scene &operator = (const mapped_scene &);
+    };
+    /*  End of mapped_scene definition.                                       */
+
+#endif
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  Helpers for the scene files, not part of the interface.                   */
+namespace psow {
+    namespace scene_file_detail {
+
+        /*  Rounds up to the next multiple of 64 bytes.                       */
+        inline std::uint64_t align(std::uint64_t offset)
+        {
+            return (offset + 63U) & ~static_cast<std::uint64_t>(63U);
+        }
+
+        /*  Ends the token p points at with a zero and returns it, moving p   *
+         *  past it. Returns NULL at the end of the line.                     */
+        inline char *next_token(char *&p)
+        {
+            char *token;
+
+            while (*p == ' ' || *p == '\t' || *p == '\r')
+                ++p;
+
+            if (*p == '\0')
+                return NULL;
+
+            token = p;
+
+            while (*p != '\0' && *p != ' ' && *p != '\t' && *p != '\r')
+                ++p;
+
+            if (*p != '\0')
+                *p++ = '\0';
+
+            return token;
+        }
+
+        /*  Parses the next token as a number. Returns false if there is none *
+         *  or it is not a number.                                            */
+        inline bool next_number(char *&p, double &value)
+        {
+            char *end;
+            const char *token = next_token(p);
+
+            if (!token)
+                return false;
+
+            value = std::strtod(token, &end);
+            return *end == '\0';
+        }
+
+        /*  Makes a material of the given kind through the constructors of    *
+         *  psow::material, which is how both formats build their materials,  *
+         *  so that they accept the same values and clamp them the same way.  *
+         *  The numbers the kind uses must be finite, the others are ignored. */
+        inline bool make_material(material_kind kind, const double albedo[3],
+                                  double fuzz, double refraction_index,
+                                  material &m)
+        {
+            if (kind == material_dielectric)
+            {
+                if (!std::isfinite(refraction_index))
+                    return false;
+
+                m = material::dielectric(refraction_index);
+                return true;
+            }
+
+            if (!std::isfinite(albedo[0]) || !std::isfinite(albedo[1]) ||
+                !std::isfinite(albedo[2]))
+                return false;
+
+            const rgb color(albedo[0], albedo[1], albedo[2]);
+
+            if (kind == material_lambertian)
+            {
+                m = material::lambertian(color);
+                return true;
+            }
+
+            if (kind != material_metal || !std::isfinite(fuzz))
+                return false;
+
+            m = material::metal(color, fuzz);
+            return true;
+        }
+        /*  End of make_material.                                             */
+
+        /*  Parses one line of the text format into world.                    */
+        inline bool
+        parse_line(char *p, scene &world,
+                   std::map<std::string, unsigned int> &names)
+        {
+            double x, y, z, w;
+            const char *keyword = next_token(p);
+
+            if (!keyword)
+                return true;
+
+            if (std::strcmp(keyword, "sphere") == 0)
+            {
+                const char *name;
+                std::map<std::string, unsigned int>::const_iterator found;
+
+                if (!next_number(p, x) || !next_number(p, y) ||
+                    !next_number(p, z) || !next_number(p, w))
+                    return false;
+
+                name = next_token(p);
+
+                if (!name || next_token(p))
+                    return false;
+
+                found = names.find(name);
+
+                if (found == names.end())
+                    return false;
+
+                world.add(sphere(w, vec3(x, y, z)), found->second);
+                return true;
+            }
+
+            if (std::strcmp(keyword, "material") == 0)
+            {
+                const char *name = next_token(p);
+                const char *kind = next_token(p);
+                double albedo[3] = {0.0, 0.0, 0.0};
+                material m;
+
+                if (!name || !kind || names.count(name) != 0)
+                    return false;
+
+                if (std::strcmp(kind, "dielectric") == 0)
+                {
+                    if (!next_number(p, x) ||
+                        !make_material(material_dielectric, albedo, 0.0, x, m))
+                        return false;
+                }
+                else if (!next_number(p, albedo[0]) ||
+                         !next_number(p, albedo[1]) ||
+                         !next_number(p, albedo[2]))
+                    return false;
+                else if (std::strcmp(kind, "lambertian") == 0)
+                {
+                    if (!make_material(material_lambertian, albedo, 0.0, 1.0,
+                                       m))
+                        return false;
+                }
+                else if (std::strcmp(kind, "metal") == 0)
+                {
+                    if (!next_number(p, w) ||
+                        !make_material(material_metal, albedo, w, 1.0, m))
+                        return false;
+                }
+                else
+                    return false;
+
+                if (next_token(p))
+                    return false;
+
+                names[name] = world.add_material(m);
+                return true;
+            }
+
+            return false;
+        }
+        /*  End of parse_line.                                                */
+
+        /*  Writes count bytes of zeros, used to pad up to the next array.    */
+        inline bool pad(FILE *fp, std::uint64_t count)
+        {
+            static const unsigned char zeros[64] = {0};
+            return std::fwrite(zeros, 1, static_cast<std::size_t>(count), fp)
+                   == count;
+        }
+
+        /*  Writes an array and pads the file to a multiple of 64 bytes.      */
+        inline bool write_array(FILE *fp, const void *data, std::size_t bytes)
+        {
+            const std::uint64_t padding = align(bytes) - bytes;
+
+            if (bytes != 0 && std::fwrite(data, 1, bytes, fp) != bytes)
+                return false;
+
+            return pad(fp, padding);
+        }
+
+        /*  Reads n elements at the given offset into an array.               */
+        template <class T>
+        inline bool read_array(FILE *fp, std::uint64_t offset, std::size_t n,
+                               mappable_array<T> &array)
+        {
+            array.clear();
+            array.resize(n);
+
+            if (n == 0)
+                return true;
+
+            if (std::fseek(fp, static_cast<long>(offset), SEEK_SET) != 0)
+                return false;
+
+            return std::fread(array.data(), sizeof(T), n, fp) == n;
+        }
+
+        /*  Converts the stored materials, checking them as the text format   *
+         *  does.                                                             */
+        inline bool add_materials(const scene_file_material *records,
+                                  std::size_t n, scene &world)
+        {
+            std::size_t k;
+            material m;
+
+            for (k = 0; k < n; ++k)
+            {
+                const scene_file_material &r = records[k];
+
+                if (r.kind > static_cast<std::uint32_t>(material_dielectric) ||
+                    !make_material(static_cast<material_kind>(r.kind),
+                                   r.albedo, r.fuzz, r.refraction_index, m))
+                    return false;
+
+                world.add_material(m);
+            }
+
+            return true;
+        }
+
+        /*  True if every material index refers to an entry of the table.     */
+        inline bool valid_indices(const unsigned int *material_of,
+                                  std::size_t n, std::size_t material_count)
+        {
+            std::size_t k;
+            unsigned int largest = 0U;
+
+            for (k = 0; k < n; ++k)
+                largest = (material_of[k] > largest ? material_of[k] : largest);
+
+            return n == 0 || largest < material_count;
+        }
+
+        /*  Empties a scene, including its BVH.                               */
+        inline void clear(scene &world)
+        {
+            world.spheres.cx.clear();
+            world.spheres.cy.clear();
+            world.spheres.cz.clear();
+            world.spheres.radius.clear();
+            world.material_of.clear();
+            world.materials.clear();
+            world.tree = bvh();
+        }
+    }
+    /*  End of "scene_file_detail" namespace.                                 */
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  The whole file is read at once and split into lines in place.             */
+inline bool psow::read_scene_text(const char *path, scene &world,
+                                  unsigned long *error_line)
+{
+    std::map<std::string, unsigned int> names;
+    std::vector<char> text;
+    char buffer[65536];
+    std::size_t n;
+    unsigned long line = 0UL;
+    char *p;
+    FILE *fp = std::fopen(path, "rb");
+
+    if (error_line)
+        *error_line = 0UL;
+
+    if (!fp)
+        return false;
+
+    while ((n = std::fread(buffer, 1, sizeof(buffer), fp)) != 0)
+        text.insert(text.end(), buffer, buffer + n);
+
+    if (std::ferror(fp))
+    {
+        std::fclose(fp);
+        return false;
+    }
+
+    std::fclose(fp);
+    text.push_back('\0');
+    scene_file_detail::clear(world);
+    p = &text[0];
+
+    while (true)
+    {
+        char *end = std::strchr(p, '\n');
+        char *comment;
+
+        ++line;
+
+        if (end)
+            *end = '\0';
+
+        comment = std::strchr(p, '#');
+
+        if (comment)
+            *comment = '\0';
+
+        if (!scene_file_detail::parse_line(p, world, names))
+        {
+            if (error_line)
+                *error_line = line;
+
+            scene_file_detail::clear(world);
+            return false;
+        }
+
+        if (!end)
+            break;
+
+        p = end + 1;
+    }
+
+    return true;
+}
+/*  End of read_scene_text.                                                   */
+
+/*  %.17g prints every double so that it reads back exactly.                  */
+inline bool psow::write_scene_text(const char *path, const scene &world)
+{
+    std::size_t n;
+    int status = 0;
+    FILE *fp = std::fopen(path, "w");
+
+    if (!fp)
+        return false;
+
+    for (n = 0; n < world.materials.size(); ++n)
+    {
+        const material &m = world.materials[n];
+
+        if (m.kind == material_dielectric)
+            status |= std::fprintf(fp, "material m%zu dielectric %.17g\n", n,
+                                   m.refraction_index) < 0;
+        else if (m.kind == material_metal)
+            status |= std::fprintf(fp, "material m%zu metal %.17g %.17g %.17g "
+                                   "%.17g\n", n, m.albedo.r, m.albedo.g,
+                                   m.albedo.b, m.fuzz) < 0;
+        else
+            status |= std::fprintf(fp, "material m%zu lambertian %.17g %.17g "
+                                   "%.17g\n", n, m.albedo.r, m.albedo.g,
+                                   m.albedo.b) < 0;
+    }
+
+    for (n = 0; n < world.spheres.size(); ++n)
+        status |= std::fprintf(fp, "sphere %.17g %.17g %.17g %.17g m%u\n",
+                               world.spheres.cx[n], world.spheres.cy[n],
+                               world.spheres.cz[n], world.spheres.radius[n],
+                               world.material_of[n]) < 0;
+
+    status |= (std::fclose(fp) != 0);
+    return status == 0;
+}
+/*  End of write_scene_text.                                                  */
+
+/*  The header is padded to 64 bytes and the arrays follow in the order of the*
+ *  offsets in the header.                                                    */
+inline bool psow::write_scene_binary(const char *path, const scene &world)
+{
+    using scene_file_detail::align;
+
+    const std::size_t n = world.spheres.size();
+    const std::size_t m = world.materials.size();
+    const std::uint64_t doubles = align(n * sizeof(double));
+    std::vector<scene_file_material> records(m);
+    scene_file_header header;
+    std::size_t k;
+    bool ok;
+    FILE *fp;
+
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "PSOWSCN", 8);
+    header.version = scene_file_version;
+    header.byte_order = 0x01020304U;
+    header.sphere_count = n;
+    header.material_count = m;
+    header.cx = align(sizeof(header));
+    header.cy = header.cx + doubles;
+    header.cz = header.cy + doubles;
+    header.radius = header.cz + doubles;
+    header.material_of = header.radius + doubles;
+    header.materials = header.material_of + align(n * sizeof(unsigned int));
+
+    for (k = 0; k < m; ++k)
+    {
+        const material &mat = world.materials[k];
+        scene_file_material &r = records[k];
+
+        std::memset(&r, 0, sizeof(r));
+        r.kind = static_cast<std::uint32_t>(mat.kind);
+        r.albedo[0] = mat.albedo.r;
+        r.albedo[1] = mat.albedo.g;
+        r.albedo[2] = mat.albedo.b;
+        r.fuzz = mat.fuzz;
+        r.refraction_index = mat.refraction_index;
+    }
+
+    fp = std::fopen(path, "wb");
+
+    if (!fp)
+        return false;
+
+    ok = scene_file_detail::write_array(fp, &header, sizeof(header)) &&
+         scene_file_detail::write_array(fp, world.spheres.cx.data(),
+                                        n * sizeof(double)) &&
+         scene_file_detail::write_array(fp, world.spheres.cy.data(),
+                                        n * sizeof(double)) &&
+         scene_file_detail::write_array(fp, world.spheres.cz.data(),
+                                        n * sizeof(double)) &&
+         scene_file_detail::write_array(fp, world.spheres.radius.data(),
+                                        n * sizeof(double)) &&
+         scene_file_detail::write_array(fp, world.material_of.data(),
+                                        n * sizeof(unsigned int)) &&
+         scene_file_detail::write_array(fp, m == 0 ? NULL : &records[0],
+                                        m * sizeof(scene_file_material));
+
+    ok = (std::fclose(fp) == 0) && ok;
+    return ok;
+}
+/*  End of write_scene_binary.                                                */
+
+/*  Each array must lie inside the file. The counts are checked against the   *
+ *  file size before they are multiplied, so a corrupt header cannot overflow *
+ *  the arithmetic.                                                           */
+inline bool psow::valid_scene_header(const scene_file_header &header,
+                                     std::uint64_t file_size)
+{
+    const std::uint64_t n = header.sphere_count;
+    const std::uint64_t m = header.material_count;
+    const std::uint64_t offsets[6] = {
+        header.cx, header.cy, header.cz, header.radius, header.material_of,
+        header.materials
+    };
+    const std::uint64_t sizes[6] = {
+        sizeof(double), sizeof(double), sizeof(double), sizeof(double),
+        sizeof(unsigned int), sizeof(scene_file_material)
+    };
+    unsigned int k;
+
+    if (std::memcmp(header.magic, "PSOWSCN", 8) != 0 ||
+        header.version != scene_file_version ||
+        header.byte_order != 0x01020304U)
+        return false;
+
+    if (n > 0xFFFFFFFFU || n > file_size || m > file_size)
+        return false;
+
+    for (k = 0U; k < 6U; ++k)
+    {
+        const std::uint64_t count = (k == 5U ? m : n);
+
+        if ((offsets[k] & 63U) != 0 || offsets[k] > file_size ||
+            count * sizes[k] > file_size - offsets[k])
+            return false;
+    }
+
+    return true;
+}
+/*  End of valid_scene_header.                                                */
+
+/*  Only the magic number is compared, the header is checked when reading.    */
+inline bool psow::is_binary_scene(const char *path)
+{
+    char magic[8];
+    bool binary;
+    FILE *fp = std::fopen(path, "rb");
+
+    if (!fp)
+        return false;
+
+    binary = (std::fread(magic, 1, 8, fp) == 8 &&
+              std::memcmp(magic, "PSOWSCN", 8) == 0);
+
+    std::fclose(fp);
+    return binary;
+}
+
+/*  Reads the header, then each array straight into the scene's storage.      */
+inline bool psow::read_scene_binary(const char *path, scene &world)
+{
+    scene_file_header header;
+    std::vector<scene_file_material> records;
+    std::size_t n, m;
+    long file_size;
+    bool ok;
+    FILE *fp = std::fopen(path, "rb");
+
+    scene_file_detail::clear(world);
+
+    if (!fp)
+        return false;
+
+    ok = std::fseek(fp, 0, SEEK_END) == 0 &&
+         (file_size = std::ftell(fp)) >= 0 &&
+         std::fseek(fp, 0, SEEK_SET) == 0 &&
+         std::fread(&header, sizeof(header), 1, fp) == 1 &&
+         valid_scene_header(header, static_cast<std::uint64_t>(file_size));
+
+    if (ok)
+    {
+        n = static_cast<std::size_t>(header.sphere_count);
+        m = static_cast<std::size_t>(header.material_count);
+        records.resize(m);
+
+        ok = scene_file_detail::read_array(fp, header.cx, n,
+                                           world.spheres.cx) &&
+             scene_file_detail::read_array(fp, header.cy, n,
+                                           world.spheres.cy) &&
+             scene_file_detail::read_array(fp, header.cz, n,
+                                           world.spheres.cz) &&
+             scene_file_detail::read_array(fp, header.radius, n,
+                                           world.spheres.radius) &&
+             scene_file_detail::read_array(fp, header.material_of, n,
+                                           world.material_of) &&
+             (m == 0 ||
+              (std::fseek(fp, static_cast<long>(header.materials),
+                          SEEK_SET) == 0 &&
+               std::fread(&records[0], sizeof(records[0]), m, fp) == m)) &&
+             scene_file_detail::add_materials(m == 0 ? NULL : &records[0], m,
+                                              world) &&
+             scene_file_detail::valid_indices(world.material_of.data(), n, m);
+    }
+
+    std::fclose(fp);
+
+    if (!ok)
+        scene_file_detail::clear(world);
+
+    return ok;
+}
+/*  End of read_scene_binary.                                                 */
+
+#if PSOW_HAS_MMAP
+
+/*  Nothing is mapped yet.                                                    */
+inline psow::mapped_scene::mapped_scene(void) : map(NULL), length(0)
+{
+    return;
+}
+
+/*  Release the mapping if the caller did not.                                */
+inline psow::mapped_scene::~mapped_scene(void)
+{
+    close();
+}
+
+/*  The descriptor is not needed once the file is mapped. PROT_WRITE with     *
+ *  MAP_PRIVATE gives the scene writable copy-on-write pages, as the arrays of*
+ *  a sphere_list are not const.                                              */
+inline bool psow::mapped_scene::open(const char *path, scene &world)
+{
+    struct stat info;
+    void *address;
+    int fd;
+
+    scene_file_detail::clear(world);
+
+    if (!close())
+        return false;
+
+    fd = ::open(path, O_RDONLY);
+
+    if (fd < 0)
+        return false;
+
+    if (::fstat(fd, &info) != 0 ||
+        static_cast<std::uint64_t>(info.st_size) < sizeof(scene_file_header))
+    {
+        ::close(fd);
+        return false;
+    }
+
+    length = static_cast<std::size_t>(info.st_size);
+    address = ::mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (address == MAP_FAILED)
+    {
+        length = 0;
+        return false;
+    }
+
+    map = static_cast<unsigned char *>(address);
+
+    const scene_file_header &header =
+        *reinterpret_cast<const scene_file_header *>(map);
+    const std::size_t n = static_cast<std::size_t>(header.sphere_count);
+    const std::size_t m = static_cast<std::size_t>(header.material_count);
+
+    if (!valid_scene_header(header, length) ||
+        !scene_file_detail::add_materials(
+            reinterpret_cast<const scene_file_material *>(
+                map + header.materials
+            ), m, world) ||
+        !scene_file_detail::valid_indices(
+            reinterpret_cast<const unsigned int *>(map + header.material_of),
+            n, m))
+    {
+        scene_file_detail::clear(world);
+        close();
+        return false;
+    }
+
+    world.spheres.cx.borrow(reinterpret_cast<double *>(map + header.cx), n);
+    world.spheres.cy.borrow(reinterpret_cast<double *>(map + header.cy), n);
+    world.spheres.cz.borrow(reinterpret_cast<double *>(map + header.cz), n);
+    world.spheres.radius.borrow(
+        reinterpret_cast<double *>(map + header.radius), n
+    );
+    world.material_of.borrow(
+        reinterpret_cast<unsigned int *>(map + header.material_of), n
+    );
+
+    return true;
+}
+/*  End of mapped_scene::open.                                                */
+
+inline bool psow::mapped_scene::close(void)
+{
+    bool ok = true;
+
+    if (map)
+        ok = (::munmap(map, length) == 0);
+
+    map = NULL;
+    length = 0;
+    return ok;
+}
+
+#endif
+/*  End of #if PSOW_HAS_MMAP.                                                 */
+
+#endif
+/*  End of include guard.                                                     */
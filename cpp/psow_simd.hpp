@@ -0,0 +1,102 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides runtime detection of the SIMD instruction sets available.   *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_SIMD_HPP
+#define PSOW_SIMD_HPP
+
+/*  The x86 kernels are compiled with GCC / Clang target attributes, so that  *
+ *  a single binary built for the baseline architecture carries SSE2, AVX2    *
+ *  and AVX-512 versions and picks between them at runtime.                   */
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define PSOW_HAS_X86_SIMD 1
+#include <immintrin.h>
+#else
+#define PSOW_HAS_X86_SIMD 0
+#endif
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  Instruction sets the vector kernels are written for, in order of      *
+     *  increasing width.                                                     */
+    enum simd_level {
+        simd_scalar = 0,
+        simd_sse2   = 1,
+        simd_avx2   = 2,
+        simd_avx512 = 3
+    };
+
+    /*  Returns the widest instruction set the CPU supports. The answer is    *
+     *  computed once and cached.                                             */
+    inline simd_level detect_simd_level(void);
+
+    /*  Human readable name for a simd_level.                                 */
+    inline const char *simd_level_name(simd_level level);
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  Asks the CPU, via cpuid, which extensions it has.                         */
+inline psow::simd_level psow::detect_simd_level(void)
+{
+#if PSOW_HAS_X86_SIMD
+    static const simd_level level = []() -> simd_level {
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx512f"))
+            return simd_avx512;
+
+        if (__builtin_cpu_supports("avx2"))
+            return simd_avx2;
+
+        if (__builtin_cpu_supports("sse2"))
+            return simd_sse2;
+
+        return simd_scalar;
+    }();
+
+    return level;
+#else
+    return simd_scalar;
+#endif
+}
+
+/*  Names used when reporting which kernel was chosen.                        */
+inline const char *psow::simd_level_name(simd_level level)
+{
+    switch (level)
+    {
+        case simd_avx512:
+            return "avx512";
+        case simd_avx2:
+            return "avx2";
+        case simd_sse2:
+            return "sse2";
+        default:
+            return "scalar";
+    }
+}
+
+#endif
+/*  End of include guard.                                                     */
@@ -31,52 +31,87 @@
 /*  ray struct given here.                                                    */
 #include "psow_ray.hpp"
 
+/*  hit_record struct, filled in by sphere::hit.                              */
+#include "psow_hit_record.hpp"
+
+/*  Packets of rays, and the SIMD kernels for intersecting them.              */
+#include "psow_ray_packet.hpp"
+#include "psow_sphere_simd.hpp"
+
 /*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
 namespace psow {
 
-    /*  Struct for dealing with spheres.                                      */
-    struct sphere {
+    /*  Struct for dealing with spheres, computing in the type real. See the  *
+     *  sphere and spheref aliases.                                           */
+    template <class real>
+    struct basic_sphere {
 
         /*  A sphere is defined by its radius and its center.                 */
-        double radius;
-        vec3 center;
+        real radius;
+        basic_vec3<real> center;
 
-        /*  Empty constructor. Return NULL.                                   */
-        inline sphere(void)
+        /*  Empty constructor, the members are left uninitialized.            */
+        basic_sphere(void) = default;
+
+        /*  Main constructor. Spheres can be made at compile time.            */
+        constexpr basic_sphere(real r, const psow::basic_vec3<real> &c)
+            : radius(r), center(c)
         {
-            return;
         }
 
-        /*  Main constructor.                                                 */
-        inline sphere(double r, const psow::vec3 &c)
+        /*  Conversion from a sphere of another precision.                    */
+        template <class other>
+        constexpr explicit basic_sphere(const basic_sphere<other> &s)
+            : radius(static_cast<real>(s.radius)), center(s.center)
         {
-            radius = r;
-            center = c;
         }
 
         /*  Function for determining if a ray intersects a sphere.            */
-        inline bool intersects_ray(const psow::ray &r) const;
+        inline bool intersects_ray(const psow::basic_ray<real> &r) const;
+
+        /*  Finds the nearest hit of r with t in (t_min, t_max). On a hit the *
+         *  record is filled in and true is returned. Callers searching many  *
+         *  spheres pass the t of their closest hit so far as t_max, so that  *
+         *  farther spheres are rejected before the square root. The search   *
+         *  is done in the type real, the record is always double.            */
+        inline bool hit(const psow::basic_ray<real> &r, real t_min, real t_max,
+                        psow::hit_record &rec) const;
+
+        /*  Tests a whole packet of rays at once. Bit i of the returned mask  *
+         *  is set if ray i hits the sphere, and t[i] is then the nearest     *
+         *  positive t along that ray. The widest SIMD kernel the CPU supports*
+         *  is used. Packets are double precision, so this is only for        *
+         *  spheres of doubles.                                               */
+        template <unsigned int N>
+        inline unsigned int
+        intersects_packet(const psow::ray_packet<N> &rays, double *t) const;
     };
-    /*  End of definition of sphere.                                          */
+    /*  End of definition of basic_sphere.                                    */
+
+    /*  Double and single precision spheres.                                  */
+    typedef basic_sphere<double> sphere;
+    typedef basic_sphere<float> spheref;
 }
 /*  End of "psow" namespace.                                                  */
 
 /*  Since a sphere satisfies (x-x0)^2 + (y-y0)^2 + (z-z0)^2 = r^2, given a    *
  *  ray L(t) = p + tv, solving for which values of t satisfy the sphere's     *
  *  equation amounts to solving a quadratic equation.                         */
-inline bool psow::sphere::intersects_ray(const psow::ray &r) const
+template <class real>
+inline bool
+psow::basic_sphere<real>::intersects_ray(const psow::basic_ray<real> &r) const
 {
-    const psow::vec3 oc = r.p - center;
-    const double a = r.v.normsq();
-    const double b = 2.0 * r.v.dot(oc);
-    const double c = oc.normsq() - radius*radius;
-    const double D = b*b - 4.0*a*c;
+    const psow::basic_vec3<real> oc = r.p - center;
+    const real a = r.v.normsq();
+    const real b = real(2) * r.v.dot(oc);
+    const real c = oc.normsq() - radius*radius;
+    const real D = b*b - real(4)*a*c;
 
-    if (D > 0.0)
+    if (D > real(0))
     {
-        const double sqrt_D = std::sqrt(D);
+        const real sqrt_D = std::sqrt(D);
 
-        if (sqrt_D - b > 0.0)
+        if (sqrt_D - b > real(0))
             return true;
 
         return false;
@@ -86,5 +121,61 @@ inline bool psow::sphere::intersects_ray(const psow::ray &r) const
 }
 /*  End of intersects_ray.                                                    */
 
+/*  The same quadratic with b = 2h. The roots (-h -+ sqrt(h^2 - ac)) / a save *
+ *  the factors of 2 and 4.                                                   */
+template <class real>
+inline bool
+psow::basic_sphere<real>::hit(const psow::basic_ray<real> &r,
+                              real t_min, real t_max,
+                              psow::hit_record &rec) const
+{
+    const psow::basic_vec3<real> oc = r.p - center;
+    const real a = r.v.normsq();
+    const real h = r.v.dot(oc);
+    const real c = oc.normsq() - radius*radius;
+    const real D = h*h - a*c;
+
+    if (D < real(0))
+        return false;
+
+    /*  The near root, and so both, are at least t_max unless sqrt(D) exceeds *
+     *  -h - a t_max. If that is positive, compare squares and skip the sqrt. */
+    const real lead = -h - a*t_max;
+
+    if (lead > real(0) && lead*lead >= D)
+        return false;
+
+    const real sqrt_D = std::sqrt(D);
+    real root = (-h - sqrt_D) / a;
+
+    if (root <= t_min || root >= t_max)
+    {
+        root = (sqrt_D - h) / a;
+
+        if (root <= t_min || root >= t_max)
+            return false;
+    }
+
+    rec.set_sphere(psow::ray(r), root, psow::vec3(center), radius);
+    rec.index = 0;
+    return true;
+}
+/*  End of hit.                                                               */
+
+/*  Hands the component arrays of the packet to the dispatched kernel.        */
+template <class real>
+template <unsigned int N>
+inline unsigned int
+psow::basic_sphere<real>::intersects_packet(const psow::ray_packet<N> &rays,
+                                            double *t) const
+{
+    const psow::ray_arrays arrays = {
+        rays.px, rays.py, rays.pz, rays.vx, rays.vy, rays.vz
+    };
+
+    return psow::best_sphere_packet_kernel()(center, radius, arrays, N, t);
+}
+/*  End of intersects_packet.                                                 */
+
 #endif
 /*  End of include guard.                                                     */
@@ -0,0 +1,339 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides a structure-of-arrays container for many spheres.            *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_SPHERE_LIST_HPP
+#define PSOW_SPHERE_LIST_HPP
+
+/*  sqrt function found here.                                                 */
+#include <cmath>
+
+/*  std::size_t is found here.                                                */
+#include <cstddef>
+
+/*  std::numeric_limits, used for the "no hit" value of t.                    */
+#include <limits>
+
+/*  The component arrays are 64-byte aligned, and may be mapped from a file.  */
+#include "psow_mappable_array.hpp"
+
+/*  vec3 struct provided here.                                                */
+#include "psow_vec3.hpp"
+
+/*  ray struct given here.                                                    */
+#include "psow_ray.hpp"
+
+/*  sphere struct, and ray_arrays for batches of rays.                        */
+#include "psow_sphere.hpp"
+
+/*  hit_record struct, filled in by sphere_list::hit.                         */
+#include "psow_hit_record.hpp"
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  A scene made of spheres. Rather than an array of psow::sphere, the    *
+     *  centers and radii are kept in four separate, cache-line aligned       *
+     *  arrays. A query that walks every sphere then streams through exactly  *
+     *  the data it needs, and the compiler can vectorize the loops over the  *
+     *  arrays.                                                               */
+    struct sphere_list {
+
+        /*  Array type used for the components. The arrays of a scene loaded  *
+         *  from a binary file point straight into the mapped file.           */
+        typedef mappable_array<double> array;
+
+        /*  Index returned for rays that hit nothing.                         */
+        static const std::size_t no_hit = static_cast<std::size_t>(-1);
+
+        /*  x, y, and z components of the centers, and the radii.             */
+        array cx, cy, cz, radius;
+
+        /*  Number of spheres in the list.                                    */
+        inline std::size_t size(void) const;
+
+        /*  Reserves room for n spheres.                                      */
+        inline void reserve(std::size_t n);
+
+        /*  Changes the number of spheres to n.                               */
+        inline void resize(std::size_t n);
+
+        /*  Adds a sphere to the end of the list.                             */
+        inline void add(const sphere &s);
+
+        /*  Replaces the sphere with the given index.                         */
+        inline void set(std::size_t index, const sphere &s);
+
+        /*  Returns the sphere with the given index.                          */
+        inline sphere get(std::size_t index) const;
+
+        /*  Finds the sphere hit first by r, with t in (t_min, t_max). On a   *
+         *  hit, t and index are set and true is returned.                    */
+        inline bool nearest_hit(const ray &r, double t_min, double t_max,
+                                double &t, std::size_t &index) const;
+
+        /*  Same as above, but only looks at spheres first, ..., last - 1.    */
+        inline bool nearest_hit(const ray &r, std::size_t first,
+                                std::size_t last, double t_min, double t_max,
+                                double &t, std::size_t &index) const;
+
+        /*  Same as above, and adds the number of spheres tested to tests.    */
+        inline bool nearest_hit(const ray &r, std::size_t first,
+                                std::size_t last, double t_min, double t_max,
+                                double &t, std::size_t &index,
+                                unsigned long long &tests) const;
+
+        /*  Finds the nearest hit as above and fills in the record for it,    *
+         *  rec.index being the index of the sphere.                          */
+        inline bool hit(const ray &r, double t_min, double t_max,
+                        hit_record &rec) const;
+
+        /*  Same as above, and adds the number of spheres tested to tests.    */
+        inline bool hit(const ray &r, double t_min, double t_max,
+                        hit_record &rec, unsigned long long &tests) const;
+
+        /*  Nearest hit for each of the first n rays of a batch, with t in    *
+         *  (t_min, infinity). Misses get t[i] = infinity and index[i] =      *
+         *  no_hit.                                                           */
+        inline void nearest_hits(const ray_arrays &rays, std::size_t n,
+                                 double t_min, double *t,
+                                 std::size_t *index) const;
+    };
+    /*  End of sphere_list definition.                                        */
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  All four arrays have the same length.                                     */
+inline std::size_t psow::sphere_list::size(void) const
+{
+    return radius.size();
+}
+
+/*  Reserve each of the arrays.                                               */
+inline void psow::sphere_list::reserve(std::size_t n)
+{
+    cx.reserve(n);
+    cy.reserve(n);
+    cz.reserve(n);
+    radius.reserve(n);
+}
+
+/*  Resize each of the arrays.                                                */
+inline void psow::sphere_list::resize(std::size_t n)
+{
+    cx.resize(n);
+    cy.resize(n);
+    cz.resize(n);
+    radius.resize(n);
+}
+
+/*  Split the sphere into its components.                                     */
+inline void psow::sphere_list::add(const psow::sphere &s)
+{
+    cx.push_back(s.center.x);
+    cy.push_back(s.center.y);
+    cz.push_back(s.center.z);
+    radius.push_back(s.radius);
+}
+
+/*  Overwrite the components at the given index.                              */
+inline void psow::sphere_list::set(std::size_t index, const psow::sphere &s)
+{
+    cx[index] = s.center.x;
+    cy[index] = s.center.y;
+    cz[index] = s.center.z;
+    radius[index] = s.radius;
+}
+
+/*  Put the components back together.                                         */
+inline psow::sphere psow::sphere_list::get(std::size_t index) const
+{
+    return psow::sphere(radius[index],
+                        psow::vec3(cx[index], cy[index], cz[index]));
+}
+
+/*  The spheres are processed in blocks. The roots for a whole block are      *
+ *  computed without branches, which the compiler turns into vector code, and *
+ *  only then is the block scanned for the closest hit. Misses and roots      *
+ *  outside the interval get t = infinity.                                    */
+inline bool
+psow::sphere_list::nearest_hit(const psow::ray &r, std::size_t first,
+                               std::size_t last, double t_min, double t_max,
+                               double &t, std::size_t &index,
+                               unsigned long long &tests) const
+{
+    const std::size_t block = 8;
+    const double infinity = std::numeric_limits<double>::infinity();
+    const double a = r.v.normsq();
+    const double rcpr_a = 1.0 / a;
+    std::size_t start, k;
+    double roots[block];
+    double best = t_max;
+    std::size_t best_index = no_hit;
+
+    /*  Every sphere of the range is tested, there is no early exit.          */
+    tests += last - first;
+
+    for (start = first; start < last; start += block)
+    {
+        const std::size_t remaining = last - start;
+        const std::size_t count = (remaining < block ? remaining : block);
+        bool any = false;
+
+        for (k = 0; k < count; ++k)
+        {
+            const std::size_t i = start + k;
+            const double ox = r.p.x - cx[i];
+            const double oy = r.p.y - cy[i];
+            const double oz = r.p.z - cz[i];
+            const double h = r.v.x*ox + r.v.y*oy + r.v.z*oz;
+            const double c = ox*ox + oy*oy + oz*oz - radius[i]*radius[i];
+            const double D = h*h - a*c;
+            const double sqrt_D = std::sqrt(D > 0.0 ? D : 0.0);
+            const double t_near = (-h - sqrt_D) * rcpr_a;
+            const double t_far = (sqrt_D - h) * rcpr_a;
+            const double root = (t_near > t_min ? t_near : t_far);
+            const bool valid = (D > 0.0) & (root > t_min) & (root < best);
+
+            roots[k] = (valid ? root : infinity);
+            any |= valid;
+        }
+
+        if (!any)
+            continue;
+
+        for (k = 0; k < count; ++k)
+        {
+            if (roots[k] < best)
+            {
+                best = roots[k];
+                best_index = start + k;
+            }
+        }
+    }
+
+    if (best_index == no_hit)
+        return false;
+
+    t = best;
+    index = best_index;
+    return true;
+}
+/*  End of nearest_hit.                                                       */
+
+/*  Without counting the tests.                                               */
+inline bool
+psow::sphere_list::nearest_hit(const psow::ray &r, std::size_t first,
+                               std::size_t last, double t_min, double t_max,
+                               double &t, std::size_t &index) const
+{
+    unsigned long long tests = 0ULL;
+    return nearest_hit(r, first, last, t_min, t_max, t, index, tests);
+}
+
+/*  The whole list is the range [0, size()).                                  */
+inline bool
+psow::sphere_list::nearest_hit(const psow::ray &r, double t_min, double t_max,
+                               double &t, std::size_t &index) const
+{
+    return nearest_hit(r, 0, size(), t_min, t_max, t, index);
+}
+
+/*  The point and normal are computed once, for the winning sphere only.      */
+inline bool
+psow::sphere_list::hit(const psow::ray &r, double t_min, double t_max,
+                       psow::hit_record &rec, unsigned long long &tests) const
+{
+    double t;
+    std::size_t i;
+
+    if (!nearest_hit(r, 0, size(), t_min, t_max, t, i, tests))
+        return false;
+
+    rec.set_sphere(r, t, psow::vec3(cx[i], cy[i], cz[i]), radius[i]);
+    rec.index = i;
+    return true;
+}
+
+/*  Without counting the tests.                                               */
+inline bool
+psow::sphere_list::hit(const psow::ray &r, double t_min, double t_max,
+                       psow::hit_record &rec) const
+{
+    unsigned long long tests = 0ULL;
+    return hit(r, t_min, t_max, rec, tests);
+}
+
+/*  For a batch the loops are swapped: each sphere is loaded once and tested  *
+ *  against every ray, and the inner loop over the rays is branch free. GCC   *
+ *  and Clang only vectorize the sqrt calls when built with -fno-math-errno,  *
+ *  since otherwise sqrt may have to set errno.                               */
+inline void
+psow::sphere_list::nearest_hits(const psow::ray_arrays &rays, std::size_t n,
+                                double t_min, double *t,
+                                std::size_t *index) const
+{
+    std::size_t i, k;
+    const double infinity = std::numeric_limits<double>::infinity();
+
+    for (k = 0; k < n; ++k)
+    {
+        t[k] = infinity;
+        index[k] = no_hit;
+    }
+
+    for (i = 0; i < size(); ++i)
+    {
+        const double x = cx[i];
+        const double y = cy[i];
+        const double z = cz[i];
+        const double r_sq = radius[i]*radius[i];
+
+        for (k = 0; k < n; ++k)
+        {
+            const double ox = rays.px[k] - x;
+            const double oy = rays.py[k] - y;
+            const double oz = rays.pz[k] - z;
+            const double vx = rays.vx[k];
+            const double vy = rays.vy[k];
+            const double vz = rays.vz[k];
+            const double a = vx*vx + vy*vy + vz*vz;
+            const double h = vx*ox + vy*oy + vz*oz;
+            const double c = ox*ox + oy*oy + oz*oz - r_sq;
+            const double D = h*h - a*c;
+            const double sqrt_D = std::sqrt(D > 0.0 ? D : 0.0);
+            const double rcpr_a = 1.0 / a;
+            const double t_near = (-h - sqrt_D) * rcpr_a;
+            const double t_far = (sqrt_D - h) * rcpr_a;
+            const double root = (t_near > t_min ? t_near : t_far);
+            const bool closer = (D > 0.0) & (root > t_min) & (root < t[k]);
+
+            t[k] = (closer ? root : t[k]);
+            index[k] = (closer ? i : index[k]);
+        }
+    }
+}
+/*  End of nearest_hits.                                                      */
+
+#endif
+/*  End of include guard.                                                     */
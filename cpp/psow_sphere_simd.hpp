@@ -0,0 +1,476 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides SIMD kernels for intersecting many rays with one sphere.     *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_SPHERE_SIMD_HPP
+#define PSOW_SPHERE_SIMD_HPP
+
+/*  sqrt function found here.                                                 */
+#include <cmath>
+
+/*  std::numeric_limits, used for the "no hit" value of t.                    */
+#include <limits>
+
+/*  vec3 struct provided here.                                                */
+#include "psow_vec3.hpp"
+
+/*  SIMD detection and the x86 intrinsics.                                    */
+#include "psow_simd.hpp"
+
+/*  Wide vectors, for the kernel written once for every instruction set.      */
+#include "psow_vec3_wide.hpp"
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  Pointers to the component arrays of a batch of rays. See ray_packet.  */
+    struct ray_arrays {
+        const double *px, *py, *pz;
+        const double *vx, *vy, *vz;
+    };
+
+    /*  A kernel tests the first n rays of a batch against the sphere with the*
+     *  given center and radius. Bit i of the returned mask is set if ray i   *
+     *  hits, in which case t[i] is the smallest positive root. Misses get    *
+     *  t[i] = infinity. n may be at most 32.                                 */
+    typedef unsigned int
+    (*sphere_packet_kernel)(const vec3 &center, double radius,
+                            const ray_arrays &rays, unsigned int n, double *t);
+
+    /*  Portable version, one ray at a time.                                  */
+    inline unsigned int
+    sphere_packet_scalar(const vec3 &center, double radius,
+                         const ray_arrays &rays, unsigned int n, double *t);
+
+    /*  Portable version written with the wide types, N rays at a time. It    *
+     *  compiles to the vector instructions the build targets, and is not     *
+     *  one of the dispatched kernels.                                        */
+    template <unsigned int N>
+    inline unsigned int
+    sphere_packet_wide(const vec3 &center, double radius,
+                       const ray_arrays &rays, unsigned int n, double *t);
+
+#if PSOW_HAS_X86_SIMD
+
+    /*  Two rays at a time with SSE2.                                         */
+    inline unsigned int
+    sphere_packet_sse2(const vec3 &center, double radius,
+                       const ray_arrays &rays, unsigned int n, double *t);
+
+    /*  Four rays at a time with AVX2.                                        */
+    inline unsigned int
+    sphere_packet_avx2(const vec3 &center, double radius,
+                       const ray_arrays &rays, unsigned int n, double *t);
+
+    /*  Eight rays at a time with AVX-512.                                    */
+    inline unsigned int
+    sphere_packet_avx512(const vec3 &center, double radius,
+                         const ray_arrays &rays, unsigned int n, double *t);
+
+#endif
+
+    /*  Returns the kernel for the given instruction set. Levels that are not *
+     *  compiled in fall back to the next narrower one.                       */
+    inline sphere_packet_kernel select_sphere_packet_kernel(simd_level level);
+
+    /*  The kernel for the widest instruction set this CPU supports.          */
+    inline sphere_packet_kernel best_sphere_packet_kernel(void);
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  This is the half-b form of the quadratic used by intersects_ray. With     *
+ *  oc = p - center, a = |v|^2, h = v.oc and c = |oc|^2 - r^2, the roots are  *
+ *  (-h +/- sqrt(h^2 - ac)) / a. The ray hits if the discriminant is positive *
+ *  and the far root is positive, the same test as psow::sphere.              */
+inline unsigned int
+psow::sphere_packet_scalar(const vec3 &center, double radius,
+                           const ray_arrays &rays, unsigned int n, double *t)
+{
+    unsigned int i;
+    unsigned int mask = 0U;
+    const double r_sq = radius*radius;
+    const double infinity = std::numeric_limits<double>::infinity();
+
+    for (i = 0U; i < n; ++i)
+    {
+        const double ox = rays.px[i] - center.x;
+        const double oy = rays.py[i] - center.y;
+        const double oz = rays.pz[i] - center.z;
+        const double vx = rays.vx[i];
+        const double vy = rays.vy[i];
+        const double vz = rays.vz[i];
+
+        const double a = vx*vx + vy*vy + vz*vz;
+        const double h = vx*ox + vy*oy + vz*oz;
+        const double c = ox*ox + oy*oy + oz*oz - r_sq;
+        const double D = h*h - a*c;
+
+        t[i] = infinity;
+
+        if (D > 0.0)
+        {
+            const double sqrt_D = std::sqrt(D);
+            const double far = sqrt_D - h;
+
+            if (far > 0.0)
+            {
+                const double rcpr_a = 1.0 / a;
+                const double t_near = (-h - sqrt_D) * rcpr_a;
+                t[i] = (t_near > 0.0 ? t_near : far * rcpr_a);
+                mask |= 1U << i;
+            }
+        }
+    }
+
+    return mask;
+}
+/*  End of sphere_packet_scalar.                                              */
+
+/*  The scalar kernel with every double replaced by N of them and the branches*
+ *  by masks. Both roots are computed in every lane and selected afterwards.  */
+template <unsigned int N>
+inline unsigned int
+psow::sphere_packet_wide(const vec3 &center, double radius,
+                         const ray_arrays &rays, unsigned int n, double *t)
+{
+    typedef psow::basic_vec3x<double, N> vec_type;
+    typedef psow::wide<double, N> wide_type;
+
+    unsigned int i;
+    unsigned int mask = 0U;
+    const vec_type c(center);
+    const wide_type r_sq(radius*radius);
+    const wide_type zero(0.0);
+    const wide_type infinity(std::numeric_limits<double>::infinity());
+
+    for (i = 0U; i + N <= n; i += N)
+    {
+        const vec_type oc =
+            vec_type::load(rays.px + i, rays.py + i, rays.pz + i) - c;
+        const vec_type v = vec_type::load(rays.vx + i, rays.vy + i,
+                                          rays.vz + i);
+
+        const wide_type a = v.normsq();
+        const wide_type h = v.dot(oc);
+        const wide_type cc = oc.normsq() - r_sq;
+        const wide_type D = h*h - a*cc;
+
+        const wide_type sqrt_D = psow::sqrt(psow::max(D, zero));
+        const wide_type far = sqrt_D - h;
+        const psow::wide_mask<double, N> hit = (D > zero) & (far > zero);
+
+        const wide_type rcpr_a = 1.0 / a;
+        const wide_type t_near = (-h - sqrt_D) * rcpr_a;
+        const wide_type t_hit =
+            psow::select(t_near > zero, t_near, far * rcpr_a);
+
+        psow::select(hit, t_hit, infinity).store(t + i);
+        mask |= hit.bits() << i;
+    }
+
+    /*  Fewer than N rays are left over, the scalar kernel handles them.      */
+    if (i < n)
+    {
+        const ray_arrays tail = {
+            rays.px + i, rays.py + i, rays.pz + i,
+            rays.vx + i, rays.vy + i, rays.vz + i
+        };
+
+        mask |= sphere_packet_scalar(center, radius, tail, n - i, t + i) << i;
+    }
+
+    return mask;
+}
+/*  End of sphere_packet_wide.                                                */
+
+#if PSOW_HAS_X86_SIMD
+
+/*  Same math as the scalar kernel, two lanes per instruction.                */
+__attribute__((target("sse2")))
+inline unsigned int
+psow::sphere_packet_sse2(const vec3 &center, double radius,
+                         const ray_arrays &rays, unsigned int n, double *t)
+{
+    unsigned int i;
+    unsigned int mask = 0U;
+    const __m128d cx = _mm_set1_pd(center.x);
+    const __m128d cy = _mm_set1_pd(center.y);
+    const __m128d cz = _mm_set1_pd(center.z);
+    const __m128d r_sq = _mm_set1_pd(radius*radius);
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d one = _mm_set1_pd(1.0);
+    const __m128d infinity =
+        _mm_set1_pd(std::numeric_limits<double>::infinity());
+
+    for (i = 0U; i + 2U <= n; i += 2U)
+    {
+        const __m128d ox = _mm_sub_pd(_mm_loadu_pd(rays.px + i), cx);
+        const __m128d oy = _mm_sub_pd(_mm_loadu_pd(rays.py + i), cy);
+        const __m128d oz = _mm_sub_pd(_mm_loadu_pd(rays.pz + i), cz);
+        const __m128d vx = _mm_loadu_pd(rays.vx + i);
+        const __m128d vy = _mm_loadu_pd(rays.vy + i);
+        const __m128d vz = _mm_loadu_pd(rays.vz + i);
+
+        const __m128d a = _mm_add_pd(_mm_add_pd(_mm_mul_pd(vx, vx),
+                                                _mm_mul_pd(vy, vy)),
+                                     _mm_mul_pd(vz, vz));
+        const __m128d h = _mm_add_pd(_mm_add_pd(_mm_mul_pd(vx, ox),
+                                                _mm_mul_pd(vy, oy)),
+                                     _mm_mul_pd(vz, oz));
+        const __m128d c = _mm_sub_pd(
+            _mm_add_pd(_mm_add_pd(_mm_mul_pd(ox, ox), _mm_mul_pd(oy, oy)),
+                       _mm_mul_pd(oz, oz)),
+            r_sq
+        );
+        const __m128d D = _mm_sub_pd(_mm_mul_pd(h, h), _mm_mul_pd(a, c));
+
+        /*  Clamp D at zero so lanes that miss do not produce NaNs.           */
+        const __m128d sqrt_D = _mm_sqrt_pd(_mm_max_pd(D, zero));
+        const __m128d far = _mm_sub_pd(sqrt_D, h);
+        const __m128d hit = _mm_and_pd(_mm_cmpgt_pd(D, zero),
+                                       _mm_cmpgt_pd(far, zero));
+
+        const __m128d rcpr_a = _mm_div_pd(one, a);
+        const __m128d t_near = _mm_mul_pd(_mm_sub_pd(_mm_sub_pd(zero, h),
+                                                     sqrt_D), rcpr_a);
+        const __m128d t_far = _mm_mul_pd(far, rcpr_a);
+        const __m128d use_near = _mm_cmpgt_pd(t_near, zero);
+
+        /*  SSE2 has no blend, so select with and / andnot / or.              */
+        const __m128d t_hit = _mm_or_pd(_mm_and_pd(use_near, t_near),
+                                        _mm_andnot_pd(use_near, t_far));
+        const __m128d t_out = _mm_or_pd(_mm_and_pd(hit, t_hit),
+                                        _mm_andnot_pd(hit, infinity));
+
+        _mm_storeu_pd(t + i, t_out);
+        mask |= static_cast<unsigned int>(_mm_movemask_pd(hit)) << i;
+    }
+
+    /*  Odd ray out, if any.                                                  */
+    if (i < n)
+    {
+        const ray_arrays tail = {
+            rays.px + i, rays.py + i, rays.pz + i,
+            rays.vx + i, rays.vy + i, rays.vz + i
+        };
+
+        mask |= sphere_packet_scalar(center, radius, tail, n - i, t + i) << i;
+    }
+
+    return mask;
+}
+/*  End of sphere_packet_sse2.                                                */
+
+/*  Same math as the scalar kernel, four lanes per instruction.               */
+__attribute__((target("avx2")))
+inline unsigned int
+psow::sphere_packet_avx2(const vec3 &center, double radius,
+                         const ray_arrays &rays, unsigned int n, double *t)
+{
+    unsigned int i;
+    unsigned int mask = 0U;
+    const __m256d cx = _mm256_set1_pd(center.x);
+    const __m256d cy = _mm256_set1_pd(center.y);
+    const __m256d cz = _mm256_set1_pd(center.z);
+    const __m256d r_sq = _mm256_set1_pd(radius*radius);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d infinity =
+        _mm256_set1_pd(std::numeric_limits<double>::infinity());
+
+    for (i = 0U; i + 4U <= n; i += 4U)
+    {
+        const __m256d ox = _mm256_sub_pd(_mm256_loadu_pd(rays.px + i), cx);
+        const __m256d oy = _mm256_sub_pd(_mm256_loadu_pd(rays.py + i), cy);
+        const __m256d oz = _mm256_sub_pd(_mm256_loadu_pd(rays.pz + i), cz);
+        const __m256d vx = _mm256_loadu_pd(rays.vx + i);
+        const __m256d vy = _mm256_loadu_pd(rays.vy + i);
+        const __m256d vz = _mm256_loadu_pd(rays.vz + i);
+
+        const __m256d a = _mm256_add_pd(
+            _mm256_add_pd(_mm256_mul_pd(vx, vx), _mm256_mul_pd(vy, vy)),
+            _mm256_mul_pd(vz, vz)
+        );
+        const __m256d h = _mm256_add_pd(
+            _mm256_add_pd(_mm256_mul_pd(vx, ox), _mm256_mul_pd(vy, oy)),
+            _mm256_mul_pd(vz, oz)
+        );
+        const __m256d c = _mm256_sub_pd(
+            _mm256_add_pd(
+                _mm256_add_pd(_mm256_mul_pd(ox, ox), _mm256_mul_pd(oy, oy)),
+                _mm256_mul_pd(oz, oz)
+            ),
+            r_sq
+        );
+        const __m256d D = _mm256_sub_pd(_mm256_mul_pd(h, h),
+                                        _mm256_mul_pd(a, c));
+
+        const __m256d sqrt_D = _mm256_sqrt_pd(_mm256_max_pd(D, zero));
+        const __m256d far = _mm256_sub_pd(sqrt_D, h);
+        const __m256d hit = _mm256_and_pd(_mm256_cmp_pd(D, zero, _CMP_GT_OQ),
+                                          _mm256_cmp_pd(far, zero, _CMP_GT_OQ));
+
+        const __m256d rcpr_a = _mm256_div_pd(one, a);
+        const __m256d t_near = _mm256_mul_pd(
+            _mm256_sub_pd(_mm256_sub_pd(zero, h), sqrt_D), rcpr_a
+        );
+        const __m256d t_far = _mm256_mul_pd(far, rcpr_a);
+        const __m256d use_near = _mm256_cmp_pd(t_near, zero, _CMP_GT_OQ);
+        const __m256d t_hit = _mm256_blendv_pd(t_far, t_near, use_near);
+
+        _mm256_storeu_pd(t + i, _mm256_blendv_pd(infinity, t_hit, hit));
+        mask |= static_cast<unsigned int>(_mm256_movemask_pd(hit)) << i;
+    }
+
+    /*  Up to three rays are left over, the SSE2 kernel handles them.         */
+    if (i < n)
+    {
+        const ray_arrays tail = {
+            rays.px + i, rays.py + i, rays.pz + i,
+            rays.vx + i, rays.vy + i, rays.vz + i
+        };
+
+        mask |= sphere_packet_sse2(center, radius, tail, n - i, t + i) << i;
+    }
+
+    return mask;
+}
+/*  End of sphere_packet_avx2.                                                */
+
+/*  Same math as the scalar kernel, eight lanes per instruction. AVX-512      *
+ *  compares produce bit masks directly, and the leftover lanes are handled   *
+ *  with a masked load instead of a scalar loop.                              */
+__attribute__((target("avx512f")))
+inline unsigned int
+psow::sphere_packet_avx512(const vec3 &center, double radius,
+                           const ray_arrays &rays, unsigned int n, double *t)
+{
+    unsigned int i;
+    unsigned int mask = 0U;
+    const __m512d cx = _mm512_set1_pd(center.x);
+    const __m512d cy = _mm512_set1_pd(center.y);
+    const __m512d cz = _mm512_set1_pd(center.z);
+    const __m512d r_sq = _mm512_set1_pd(radius*radius);
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d infinity =
+        _mm512_set1_pd(std::numeric_limits<double>::infinity());
+
+    for (i = 0U; i < n; i += 8U)
+    {
+        const unsigned int lanes = (n - i < 8U ? n - i : 8U);
+        const __mmask8 live = static_cast<__mmask8>((1U << lanes) - 1U);
+
+        const __m512d ox = _mm512_sub_pd(
+            _mm512_maskz_loadu_pd(live, rays.px + i), cx
+        );
+        const __m512d oy = _mm512_sub_pd(
+            _mm512_maskz_loadu_pd(live, rays.py + i), cy
+        );
+        const __m512d oz = _mm512_sub_pd(
+            _mm512_maskz_loadu_pd(live, rays.pz + i), cz
+        );
+        const __m512d vx = _mm512_maskz_loadu_pd(live, rays.vx + i);
+        const __m512d vy = _mm512_maskz_loadu_pd(live, rays.vy + i);
+        const __m512d vz = _mm512_maskz_loadu_pd(live, rays.vz + i);
+
+        const __m512d a = _mm512_add_pd(
+            _mm512_add_pd(_mm512_mul_pd(vx, vx), _mm512_mul_pd(vy, vy)),
+            _mm512_mul_pd(vz, vz)
+        );
+        const __m512d h = _mm512_add_pd(
+            _mm512_add_pd(_mm512_mul_pd(vx, ox), _mm512_mul_pd(vy, oy)),
+            _mm512_mul_pd(vz, oz)
+        );
+        const __m512d c = _mm512_sub_pd(
+            _mm512_add_pd(
+                _mm512_add_pd(_mm512_mul_pd(ox, ox), _mm512_mul_pd(oy, oy)),
+                _mm512_mul_pd(oz, oz)
+            ),
+            r_sq
+        );
+        const __m512d D = _mm512_sub_pd(_mm512_mul_pd(h, h),
+                                        _mm512_mul_pd(a, c));
+
+        const __m512d sqrt_D = _mm512_maskz_sqrt_pd(
+            live, _mm512_maskz_max_pd(live, D, zero)
+        );
+        const __m512d far = _mm512_sub_pd(sqrt_D, h);
+        const __mmask8 hit = static_cast<__mmask8>(
+            live & _mm512_cmp_pd_mask(D, zero, _CMP_GT_OQ) &
+            _mm512_cmp_pd_mask(far, zero, _CMP_GT_OQ)
+        );
+
+        const __m512d rcpr_a = _mm512_div_pd(one, a);
+        const __m512d t_near = _mm512_mul_pd(
+            _mm512_sub_pd(_mm512_sub_pd(zero, h), sqrt_D), rcpr_a
+        );
+        const __m512d t_far = _mm512_mul_pd(far, rcpr_a);
+        const __mmask8 use_near = _mm512_cmp_pd_mask(t_near, zero, _CMP_GT_OQ);
+        const __m512d t_hit = _mm512_mask_blend_pd(use_near, t_far, t_near);
+
+        _mm512_mask_storeu_pd(t + i, live,
+                              _mm512_mask_blend_pd(hit, infinity, t_hit));
+        mask |= static_cast<unsigned int>(hit) << i;
+    }
+
+    return mask;
+}
+/*  End of sphere_packet_avx512.                                              */
+
+#endif
+/*  End of #if PSOW_HAS_X86_SIMD.                                             */
+
+/*  Maps an instruction set to its kernel.                                    */
+inline psow::sphere_packet_kernel
+psow::select_sphere_packet_kernel(simd_level level)
+{
+#if PSOW_HAS_X86_SIMD
+    switch (level)
+    {
+        case simd_avx512:
+            return sphere_packet_avx512;
+        case simd_avx2:
+            return sphere_packet_avx2;
+        case simd_sse2:
+            return sphere_packet_sse2;
+        default:
+            return sphere_packet_scalar;
+    }
+#else
+    (void)level;
+    return sphere_packet_scalar;
+#endif
+}
+
+/*  The choice is made once, the first time a packet is intersected.          */
+inline psow::sphere_packet_kernel psow::best_sphere_packet_kernel(void)
+{
+    static const sphere_packet_kernel kernel =
+        select_sphere_packet_kernel(detect_simd_level());
+
+    return kernel;
+}
+
+#endif
+/*  End of include guard.                                                     */
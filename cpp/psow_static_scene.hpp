@@ -0,0 +1,154 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides types for scenes written out in the source: spheres with     *
+ *      their materials, and the sky, all of which can be constexpr.          *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_STATIC_SCENE_HPP
+#define PSOW_STATIC_SCENE_HPP
+
+/*  std::size_t is found here.                                                */
+#include <cstddef>
+
+/*  vec3 struct provided here.                                                */
+#include "psow_vec3.hpp"
+
+/*  ray struct given here.                                                    */
+#include "psow_ray.hpp"
+
+/*  Colors of the sky.                                                        */
+#include "psow_rgb.hpp"
+
+/*  sphere struct provided here.                                              */
+#include "psow_sphere.hpp"
+
+/*  The spheres of a scene without materials are a sphere_list.               */
+#include "psow_sphere_list.hpp"
+
+/*  material struct, one per sphere.                                          */
+#include "psow_material.hpp"
+
+/*  The scene the static spheres are copied to.                               */
+#include "psow_scene.hpp"
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  A sphere and what it is made of. An array of these declared constexpr *
+     *  is laid out by the compiler in read-only data, so a scene fixed in    *
+     *  the source costs nothing to construct when the program starts.        */
+    struct static_sphere {
+        sphere shape;
+        material surface;
+
+        /*  Constructor from the sphere and its material.                     */
+        constexpr static_sphere(const sphere &s, const material &m)
+            : shape(s), surface(m)
+        {
+        }
+    };
+    /*  End of static_sphere definition.                                      */
+
+    /*  A sky that blends linearly from one color straight down to another    *
+     *  straight up. This is the only light of the path traced scenes.        */
+    struct sky_gradient {
+
+        /*  Colors looking straight down and straight up.                     */
+        rgb bottom, top;
+
+        /*  Constructor from the two colors.                                  */
+        constexpr sky_gradient(const rgb &bottom_color, const rgb &top_color)
+            : bottom(bottom_color), top(top_color)
+        {
+        }
+
+        /*  The color at height t, from 0 straight down to 1 straight up.     *
+         *  For a constant t this folds to a constant at compile time.        */
+        constexpr rgb at(double t) const;
+
+        /*  The color seen along the ray r.                                   */
+        inline rgb operator () (const ray &r) const;
+    };
+    /*  End of sky_gradient definition.                                       */
+
+    /*  White at the horizon fading to sky blue overhead, the sky of the book.*/
+    constexpr sky_gradient book_sky(void);
+
+    /*  Adds every sphere of the array to world, each with its own entry in   *
+     *  the material table. Call world.build afterwards as usual.             */
+    template <std::size_t N>
+    inline void add_static_spheres(scene &world,
+                                   const static_sphere (&spheres)[N]);
+
+    /*  Adds every sphere of the array to the list.                           */
+    template <std::size_t N>
+    inline void add_static_spheres(sphere_list &list,
+                                   const sphere (&spheres)[N]);
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  The same blend, in the same order, as the sky of example_path_tracer.     */
+constexpr psow::rgb psow::sky_gradient::at(double t) const
+{
+    return bottom*(1.0 - t) + top*t;
+}
+
+/*  The height is the y component of the unit direction, mapped to [0, 1].    */
+inline psow::rgb psow::sky_gradient::operator () (const psow::ray &r) const
+{
+    const psow::vec3 v = (r.v).unit();
+    return at(0.5 * (v.y + 1.0));
+}
+
+/*  Both colors are literals, so this is a constant expression.               */
+constexpr psow::sky_gradient psow::book_sky(void)
+{
+    return sky_gradient(rgb(1.0, 1.0, 1.0), rgb(0.5, 0.7, 1.0));
+}
+
+/*  The spheres are appended in the order of the array.                       */
+template <std::size_t N>
+inline void
+psow::add_static_spheres(psow::scene &world,
+                         const psow::static_sphere (&spheres)[N])
+{
+    std::size_t n;
+
+    for (n = 0; n < N; ++n)
+        world.add(spheres[n].shape, world.add_material(spheres[n].surface));
+}
+
+/*  Reserving first, the arrays of the list are allocated once.               */
+template <std::size_t N>
+inline void
+psow::add_static_spheres(psow::sphere_list &list,
+                         const psow::sphere (&spheres)[N])
+{
+    std::size_t n;
+    list.reserve(list.size() + N);
+
+    for (n = 0; n < N; ++n)
+        list.add(spheres[n]);
+}
+
+#endif
+/*  End of include guard.                                                     */
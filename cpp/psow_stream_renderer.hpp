@@ -0,0 +1,242 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides a renderer that streams a PPM to a file band by band, so     *
+ *      images far larger than memory can be produced.                        *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_STREAM_RENDERER_HPP
+#define PSOW_STREAM_RENDERER_HPP
+
+/*  std::size_t is found here.                                                */
+#include <cstddef>
+
+/*  fwrite, the output goes through a FILE pointer.                           */
+#include <cstdio>
+
+/*  std::condition_variable, used to hand bands to the writer and back.       */
+#include <condition_variable>
+
+/*  std::mutex and std::unique_lock.                                          */
+#include <mutex>
+
+/*  The writer runs on its own std::thread.                                   */
+#include <thread>
+
+/*  std::vector, used for the ring of bands.                                  */
+#include <vector>
+
+/*  Bands are buffered as images.                                             */
+#include "psow_image.hpp"
+
+/*  tile, render_tile, and default_tile_size.                                 */
+#include "psow_renderer.hpp"
+
+/*  The tiles are scheduled on a work-stealing thread pool.                   */
+#include "psow_thread_pool.hpp"
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  Default number of rows in a band. One tile high, so every band splits *
+     *  into a single row of tiles.                                           */
+    const unsigned int default_band_height = default_tile_size;
+
+    /*  Renders a width x height image with shader(x, y), as psow::render     *
+     *  does, but writes it to fp as a binary (P6) PPM one band of rows at a  *
+     *  time, top band first. Only a ring of ring_size bands is held in       *
+     *  memory. The pool renders ahead into the free slots of the ring while a*
+     *  writer thread flushes finished bands in order. A ring_size of zero    *
+     *  means two bands per thread. Returns false if a write fails.           */
+    template <class shader_type>
+    inline bool
+    render_stream(FILE *fp, unsigned int width, unsigned int height,
+                  const shader_type &shader, thread_pool &pool,
+                  unsigned int band_height = default_band_height,
+                  unsigned int ring_size = 0U);
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  Band b lives in slot b % ring_size. The main thread hands a slot to a new *
+ *  band only after the writer has flushed the band that used it before, so   *
+ *  memory stays at ring_size bands no matter how tall the image is.          */
+template <class shader_type>
+inline bool
+psow::render_stream(FILE *fp, unsigned int width, unsigned int height,
+                    const shader_type &shader, thread_pool &pool,
+                    unsigned int band_height, unsigned int ring_size)
+{
+    unsigned int band, x;
+
+    if (band_height == 0U)
+        band_height = default_band_height;
+
+    if (ring_size == 0U)
+        ring_size = 2U * pool.size();
+
+    const unsigned int bands = (height + band_height - 1U) / band_height;
+    const unsigned int tile_size = default_tile_size;
+    const unsigned int tiles = (width + tile_size - 1U) / tile_size;
+
+    /*  The header goes out first. write_header needs room for a terminator.  */
+    std::vector<unsigned char> header(image::header_size(width, height) + 1);
+    image::write_header(width, height, &header[0]);
+
+    const std::size_t header_length = header.size() - 1;
+
+    if (std::fwrite(&header[0], 1, header_length, fp) != header_length)
+        return false;
+
+    if (bands == 0U || width == 0U)
+        return true;
+
+    /*  The ring, and for every slot the band in it and its unfinished tiles. */
+    std::vector<image> ring;
+    std::vector<unsigned int> slot_band(ring_size, bands);
+    std::vector<unsigned int> remaining(ring_size, 0U);
+
+    /*  Each slot is built in place, rather than copied from a first one.     */
+    ring.reserve(ring_size);
+
+    for (band = 0U; band < ring_size; ++band)
+        ring.push_back(image(width, band_height));
+
+    /*  Number of bands flushed so far, and whether a write has failed.       */
+    unsigned int written = 0U;
+    bool failed = false;
+
+    std::mutex lock;
+    std::condition_variable changed;
+
+    /*  The writer waits for each band in turn, writes it, and frees its slot.*/
+    std::thread writer([&]() {
+        unsigned int b;
+
+        for (b = 0U; b < bands; ++b)
+        {
+            const unsigned int slot = b % ring_size;
+            const unsigned int y0 = b * band_height;
+            const unsigned int left = height - y0;
+            const unsigned int rows = (left < band_height ? left : band_height);
+            const std::size_t size =
+                3UL * static_cast<std::size_t>(width) * rows;
+
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                changed.wait(guard, [&]() {
+                    return slot_band[slot] == b && remaining[slot] == 0U;
+                });
+            }
+
+            /*  The slot belongs to the writer until written is bumped.       */
+            const bool ok = std::fwrite(ring[slot].pixels, 1, size, fp) == size;
+
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                written = b + 1U;
+                failed = !ok;
+            }
+
+            changed.notify_all();
+
+            if (!ok)
+                return;
+        }
+    });
+
+    for (band = 0U; band < bands; ++band)
+    {
+        const unsigned int slot = band % ring_size;
+        const unsigned int y0 = band * band_height;
+        const unsigned int left = height - y0;
+        const unsigned int rows = (left < band_height ? left : band_height);
+
+        /*  Wait for the band that last used this slot to be written. Only    *
+         *  that band is waited for, the others keep rendering ahead. The main*
+         *  thread is one of the pool's threads, so it runs queued tiles while*
+         *  it waits, and sleeps once there are none left to run.             */
+        if (band >= ring_size)
+        {
+            std::unique_lock<std::mutex> guard(lock);
+
+            while (written <= band - ring_size && !failed)
+            {
+                guard.unlock();
+                const bool ran = pool.run_one();
+                guard.lock();
+
+                if (!ran)
+                    changed.wait(guard, [&]() {
+                        return written > band - ring_size || failed;
+                    });
+            }
+
+            if (failed)
+                break;
+
+            slot_band[slot] = band;
+            remaining[slot] = tiles;
+        }
+        else
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            slot_band[slot] = band;
+            remaining[slot] = tiles;
+        }
+
+        for (x = 0U; x < width; x += tile_size)
+        {
+            tile t;
+            t.x0 = x;
+            t.y0 = 0U;
+            t.x1 = (x + tile_size < width ? x + tile_size : width);
+            t.y1 = rows;
+
+            pool.submit([&, slot, y0, t]() {
+
+                /*  Rows of the band are rows y0, y0 + 1, ... of the image.   */
+                const auto band_shader = [&shader, y0](unsigned int px,
+                                                       unsigned int py) {
+                    return shader(px, py + y0);
+                };
+
+                render_tile(ring[slot], band_shader, t);
+
+                bool done;
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    done = (--remaining[slot] == 0U);
+                }
+
+                if (done)
+                    changed.notify_all();
+            });
+        }
+    }
+
+    pool.wait();
+    writer.join();
+    return !failed;
+}
+/*  End of render_stream.                                                     */
+
+#endif
+/*  End of include guard.                                                     */
@@ -0,0 +1,555 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides lock-free render telemetry: per-thread counters of rays,     *
+ *      intersection tests, hits, samples, and tile timings, a low-priority   *
+ *      thread that reports them periodically, and a JSON dump of the totals. *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_TELEMETRY_HPP
+#define PSOW_TELEMETRY_HPP
+
+/*  std::atomic, the counters themselves.                                     */
+#include <atomic>
+
+/*  std::chrono::steady_clock, used for the tile timings and the report.      */
+#include <chrono>
+
+/*  std::condition_variable, used to put the reporter to sleep.               */
+#include <condition_variable>
+
+/*  fprintf, fopen, and fclose.                                               */
+#include <cstdio>
+
+/*  std::mutex and std::unique_lock.                                          */
+#include <mutex>
+
+/*  std::thread, the reporter.                                                */
+#include <thread>
+
+/*  std::vector, used for the counters of the threads.                        */
+#include <vector>
+
+/*  The counters of each thread get a cache line of their own.                */
+#include "psow_aligned_allocator.hpp"
+
+/*  On Linux the reporter runs under SCHED_IDLE, so it only gets a core that  *
+ *  would otherwise be idle. Elsewhere it relies on sleeping between reports. */
+#if defined(__linux__)
+#define PSOW_HAS_SCHED_IDLE 1
+#include <pthread.h>
+#include <sched.h>
+#else
+#define PSOW_HAS_SCHED_IDLE 0
+#endif
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  Counters of one thread. Only the owning thread writes them, with a    *
+     *  relaxed load and store instead of an atomic read-modify-write, so     *
+     *  counting costs a plain add and takes no lock. Other threads may read  *
+     *  them at any time. Each set of counters fills its own cache line so the*
+     *  threads never share one.                                              */
+    struct alignas(cache_line_size) telemetry_counters {
+
+        /*  Rays traced, the boxes and spheres tested against them, the rays  *
+         *  that hit a sphere, and the samples finished.                      */
+        std::atomic<unsigned long long> rays;
+        std::atomic<unsigned long long> intersection_tests;
+        std::atomic<unsigned long long> hits;
+        std::atomic<unsigned long long> samples;
+
+        /*  Tiles finished, and the total and longest time spent in one.      */
+        std::atomic<unsigned long long> tiles;
+        std::atomic<unsigned long long> tile_ns;
+        std::atomic<unsigned long long> slowest_tile_ns;
+
+        /*  True for the counters shared by the threads beyond the number the *
+         *  telemetry was made for. These are updated with atomic adds        *
+         *  instead.                                                          */
+        bool shared;
+
+        /*  Constructor. All counters start at zero.                          */
+        inline telemetry_counters(void);
+
+        /*  Adds n to the corresponding counter.                              */
+        inline void add_rays(unsigned long long n);
+        inline void add_intersection_tests(unsigned long long n);
+        inline void add_hits(unsigned long long n);
+        inline void add_samples(unsigned long long n);
+
+        /*  Records a finished tile that took the given number of nanoseconds.*/
+        inline void add_tile(unsigned long long ns);
+
+        /*  Adds n to a counter, see shared.                                  */
+        inline void add(std::atomic<unsigned long long> &counter,
+                        unsigned long long n);
+    };
+
+    /*  A snapshot of counters, or of the sum of several of them.             */
+    struct telemetry_totals {
+        unsigned long long rays;
+        unsigned long long intersection_tests;
+        unsigned long long hits;
+        unsigned long long samples;
+        unsigned long long tiles;
+        unsigned long long tile_ns;
+        unsigned long long slowest_tile_ns;
+
+        /*  Constructor. All totals start at zero.                            */
+        inline telemetry_totals(void);
+
+        /*  Adds the current values of the counters to the totals.            */
+        inline void add(const telemetry_counters &c);
+    };
+
+    /*  Counters for every thread taking part in a render, and the thread     *
+     *  reporting on them. Threads find their own counters with local(),      *
+     *  typically once per tile or per path, and count with plain adds.       *
+     *  Nothing on the rendering side ever waits for the reporter.            */
+    class telemetry {
+        public:
+
+            /*  Constructor from the number of threads that will count,       *
+             *  usually the size of the pool. Threads past that many share one*
+             *  extra set of counters. The clock for seconds() starts here.   */
+            inline explicit telemetry(unsigned int number_of_threads);
+
+            /*  Destructor. Stops the reporter if it is running.              */
+            inline ~telemetry(void);
+
+            /*  Counters of the calling thread, assigned on its first call. A *
+             *  thread should count for one telemetry at a time, switching    *
+             *  back and forth makes it take new counters every time.         */
+            inline telemetry_counters &local(void);
+
+            /*  Number of counter sets handed out so far.                     */
+            inline unsigned int size(void) const;
+
+            /*  Snapshot of the counters of the given index, less than size().*/
+            inline telemetry_totals totals_of(unsigned int index) const;
+
+            /*  Snapshot of the sum of all counters.                          */
+            inline telemetry_totals totals(void) const;
+
+            /*  Seconds since construction.                                   */
+            inline double seconds(void) const;
+
+            /*  Starts a thread that prints the progress and throughput to fp *
+             *  every interval_ms milliseconds, on one line rewritten in      *
+             *  place. With expected_samples non-zero the line includes the   *
+             *  percentage done. Does nothing if the reporter is already      *
+             *  running.                                                      */
+            inline void start_reporting(FILE *fp, unsigned int interval_ms,
+                                        unsigned long long expected_samples =
+                                            0ULL);
+
+            /*  Prints a final report, ends the line, and joins the reporter. */
+            inline void stop_reporting(void);
+
+            /*  Writes the totals and the counters of every thread as JSON.   *
+             *  Returns false if writing failed.                              */
+            inline bool write_json(FILE *fp) const;
+
+            /*  As above, to the file at path.                                */
+            inline bool write_json(const char *path) const;
+
+        private:
+
+            /*  Prints one report line covering the time since the last one.  */
+            inline void report(const telemetry_totals &now, double now_seconds,
+                               const telemetry_totals &last,
+                               double last_seconds) const;
+
+            /*  Main loop of the reporter thread.                             */
+            inline void run_reporter(void);
+
+            /*  Writes a snapshot as the members of a JSON object.            */
+            static inline bool write_json_fields(FILE *fp,
+                                                 const telemetry_totals &t);
+
+            /*  Per-thread record of which telemetry the thread counts for.   *
+             *  Telemetry objects are told apart by a serial number rather    *
+             *  than their address, which a later one could reuse.            */
+            struct thread_identity {
+                unsigned long long owner;
+                telemetry_counters *counters;
+            };
+
+            /*  Returns the identity of the calling thread.                   */
+            static inline thread_identity &identity(void);
+
+            /*  Returns a serial number no other telemetry has.               */
+            static inline unsigned long long next_serial(void);
+
+            std::vector<telemetry_counters,
+                        aligned_allocator<telemetry_counters> > counters;
+
+            /*  Counter sets handed out, may run past counters.size().        */
+            std::atomic<unsigned int> registered;
+
+            unsigned long long serial;
+            std::chrono::steady_clock::time_point start;
+
+            /*  The reporter, and what it needs to sleep and report.          */
+            std::thread reporter;
+            std::mutex sleep_lock;
+            std::condition_variable wake;
+            bool stopping;
+            FILE *report_file;
+            unsigned int report_interval_ms;
+            unsigned long long report_expected;
+
+            /*  The telemetry owns a thread, copying it makes no sense.       */
+            telemetry(const telemetry &);
+            telemetry &operator = (const telemetry &);
+    };
+    /*  End of telemetry definition.                                          */
+
+    /*  Nanoseconds elapsed since the given time, for add_tile.               */
+    inline unsigned long long
+    nanoseconds_since(std::chrono::steady_clock::time_point t);
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  Unshared until the telemetry says otherwise.                              */
+inline psow::telemetry_counters::telemetry_counters(void)
+    : rays(0ULL), intersection_tests(0ULL), hits(0ULL), samples(0ULL),
+      tiles(0ULL), tile_ns(0ULL), slowest_tile_ns(0ULL), shared(false)
+{
+    return;
+}
+
+/*  A single writer can load, add, and store without losing updates. The      *
+ *  relaxed atomics compile to ordinary moves, but keep the readers free of   *
+ *  data races and torn values.                                               */
+inline void
+psow::telemetry_counters::add(std::atomic<unsigned long long> &counter,
+                              unsigned long long n)
+{
+    if (shared)
+        counter.fetch_add(n, std::memory_order_relaxed);
+    else
+        counter.store(counter.load(std::memory_order_relaxed) + n,
+                      std::memory_order_relaxed);
+}
+
+inline void psow::telemetry_counters::add_rays(unsigned long long n)
+{
+    add(rays, n);
+}
+
+inline void
+psow::telemetry_counters::add_intersection_tests(unsigned long long n)
+{
+    add(intersection_tests, n);
+}
+
+inline void psow::telemetry_counters::add_hits(unsigned long long n)
+{
+    add(hits, n);
+}
+
+inline void psow::telemetry_counters::add_samples(unsigned long long n)
+{
+    add(samples, n);
+}
+
+/*  The maximum of shared counters may lose a race, which only affects the    *
+ *  reported slowest tile.                                                    */
+inline void psow::telemetry_counters::add_tile(unsigned long long ns)
+{
+    add(tiles, 1ULL);
+    add(tile_ns, ns);
+
+    if (ns > slowest_tile_ns.load(std::memory_order_relaxed))
+        slowest_tile_ns.store(ns, std::memory_order_relaxed);
+}
+
+/*  Everything starts at zero.                                                */
+inline psow::telemetry_totals::telemetry_totals(void)
+    : rays(0ULL), intersection_tests(0ULL), hits(0ULL), samples(0ULL),
+      tiles(0ULL), tile_ns(0ULL), slowest_tile_ns(0ULL)
+{
+    return;
+}
+
+/*  The counters are read one at a time while they may still be changing, so a*
+ *  snapshot of a running render is approximate. Once the render is done it is*
+ *  exact.                                                                    */
+inline void psow::telemetry_totals::add(const telemetry_counters &c)
+{
+    const unsigned long long slowest =
+        c.slowest_tile_ns.load(std::memory_order_relaxed);
+
+    rays += c.rays.load(std::memory_order_relaxed);
+    intersection_tests += c.intersection_tests.load(std::memory_order_relaxed);
+    hits += c.hits.load(std::memory_order_relaxed);
+    samples += c.samples.load(std::memory_order_relaxed);
+    tiles += c.tiles.load(std::memory_order_relaxed);
+    tile_ns += c.tile_ns.load(std::memory_order_relaxed);
+    slowest_tile_ns = (slowest > slowest_tile_ns ? slowest : slowest_tile_ns);
+}
+
+/*  One set of counters per thread, plus the shared set at the end.           */
+inline psow::telemetry::telemetry(unsigned int number_of_threads)
+    : counters(number_of_threads + 1U), registered(0U),
+      serial(next_serial()), start(std::chrono::steady_clock::now()),
+      stopping(false), report_file(NULL), report_interval_ms(0U),
+      report_expected(0ULL)
+{
+    counters.back().shared = true;
+}
+
+/*  The reporter must not outlive the counters it reads.                      */
+inline psow::telemetry::~telemetry(void)
+{
+    stop_reporting();
+}
+
+/*  The first call from a thread takes the next free set of counters, later   *
+ *  calls find them through the thread's identity.                            */
+inline psow::telemetry_counters &psow::telemetry::local(void)
+{
+    thread_identity &self = identity();
+    unsigned int index;
+
+    if (self.owner == serial)
+        return *self.counters;
+
+    index = registered.fetch_add(1U, std::memory_order_relaxed);
+
+    if (index >= counters.size())
+        index = static_cast<unsigned int>(counters.size() - 1);
+
+    self.owner = serial;
+    self.counters = &counters[index];
+    return *self.counters;
+}
+
+/*  registered counts every thread that asked, including those sharing.       */
+inline unsigned int psow::telemetry::size(void) const
+{
+    const unsigned int n = registered.load(std::memory_order_relaxed);
+    const unsigned int available = static_cast<unsigned int>(counters.size());
+    return (n < available ? n : available);
+}
+
+inline psow::telemetry_totals
+psow::telemetry::totals_of(unsigned int index) const
+{
+    telemetry_totals t;
+    t.add(counters[index]);
+    return t;
+}
+
+/*  Unused counters are zero, so they can simply be included.                 */
+inline psow::telemetry_totals psow::telemetry::totals(void) const
+{
+    std::size_t n;
+    telemetry_totals t;
+
+    for (n = 0; n < counters.size(); ++n)
+        t.add(counters[n]);
+
+    return t;
+}
+
+inline double psow::telemetry::seconds(void) const
+{
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    return elapsed.count();
+}
+
+/*  The settings are written before the thread starts and never change while  *
+ *  it runs.                                                                  */
+inline void
+psow::telemetry::start_reporting(FILE *fp, unsigned int interval_ms,
+                                 unsigned long long expected_samples)
+{
+    if (reporter.joinable())
+        return;
+
+    stopping = false;
+    report_file = fp;
+    report_interval_ms = (interval_ms == 0U ? 1U : interval_ms);
+    report_expected = expected_samples;
+    reporter = std::thread(&telemetry::run_reporter, this);
+}
+
+/*  Taking the lock before notifying ensures the reporter is either waiting or*
+ *  yet to check stopping, so the wakeup is not lost.                         */
+inline void psow::telemetry::stop_reporting(void)
+{
+    if (!reporter.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(sleep_lock);
+        stopping = true;
+    }
+
+    wake.notify_all();
+    reporter.join();
+}
+
+/*  Throughput is measured over the last interval, progress over the whole    *
+ *  render. The trailing spaces erase what is left of a longer previous line. */
+inline void psow::telemetry::report(const telemetry_totals &now,
+                                    double now_seconds,
+                                    const telemetry_totals &last,
+                                    double last_seconds) const
+{
+    const double dt = now_seconds - last_seconds;
+    const double scale = (dt > 0.0 ? 1.0E-6 / dt : 0.0);
+    const double mrays = scale * static_cast<double>(now.rays - last.rays);
+    const double msamples =
+        scale * static_cast<double>(now.samples - last.samples);
+
+    std::fprintf(report_file, "\r%8.1f s", now_seconds);
+
+    if (report_expected != 0ULL)
+        std::fprintf(report_file, "  %5.1f%%",
+                     100.0 * static_cast<double>(now.samples) /
+                     static_cast<double>(report_expected));
+
+    std::fprintf(report_file,
+                 "  %9.3f Msamples/s  %9.3f Mrays/s  %llu tiles  ",
+                 msamples, mrays, now.tiles);
+    std::fflush(report_file);
+}
+
+/*  The reporter holds sleep_lock only while asleep. It reads the counters    *
+ *  without any lock, and the render threads never touch the lock at all.     */
+inline void psow::telemetry::run_reporter(void)
+{
+    telemetry_totals last;
+    double last_seconds = seconds();
+    std::unique_lock<std::mutex> guard(sleep_lock);
+    const std::chrono::milliseconds interval(report_interval_ms);
+
+#if PSOW_HAS_SCHED_IDLE
+    sched_param priority;
+    priority.sched_priority = 0;
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &priority);
+#endif
+
+    while (!wake.wait_for(guard, interval, [this]() { return stopping; }))
+    {
+        const telemetry_totals now = totals();
+        const double now_seconds = seconds();
+
+        report(now, now_seconds, last, last_seconds);
+        last = now;
+        last_seconds = now_seconds;
+    }
+
+    report(totals(), seconds(), last, last_seconds);
+    std::fputc('\n', report_file);
+    std::fflush(report_file);
+}
+
+/*  Durations are written in seconds, like the benchmark results.             */
+inline bool psow::telemetry::write_json_fields(FILE *fp,
+                                               const telemetry_totals &t)
+{
+    const double mean_tile =
+        (t.tiles == 0ULL ? 0.0 : 1.0E-9 * static_cast<double>(t.tile_ns) /
+                                 static_cast<double>(t.tiles));
+
+    return std::fprintf(
+        fp,
+        "\"rays\": %llu, \"intersection_tests\": %llu, \"hits\": %llu, "
+        "\"samples\": %llu, \"tiles\": %llu, \"tile_seconds\": %.9g, "
+        "\"mean_tile_seconds\": %.9g, \"slowest_tile_seconds\": %.9g",
+        t.rays, t.intersection_tests, t.hits, t.samples, t.tiles,
+        1.0E-9 * static_cast<double>(t.tile_ns), mean_tile,
+        1.0E-9 * static_cast<double>(t.slowest_tile_ns)
+    ) >= 0;
+}
+
+/*  One object for the totals, and one per thread in the order the threads    *
+ *  first counted. The shared set, if used, comes last.                       */
+inline bool psow::telemetry::write_json(FILE *fp) const
+{
+    unsigned int n;
+    const unsigned int threads = size();
+    int status = 0;
+
+    status |= std::fprintf(fp, "{\n  \"seconds\": %.9g,\n  \"totals\": {",
+                           seconds()) < 0;
+    status |= !write_json_fields(fp, totals());
+    status |= std::fprintf(fp, "},\n  \"threads\": [") < 0;
+
+    for (n = 0U; n < threads; ++n)
+    {
+        status |= std::fprintf(fp, "%s\n    {", n == 0U ? "" : ",") < 0;
+        status |= !write_json_fields(fp, totals_of(n));
+        status |= std::fprintf(fp, "}") < 0;
+    }
+
+    status |= std::fprintf(fp, "\n  ]\n}\n") < 0;
+    return status == 0;
+}
+
+/*  fclose can fail too, for example when flushing to a full disk.            */
+inline bool psow::telemetry::write_json(const char *path) const
+{
+    FILE *fp = std::fopen(path, "w");
+    bool ok;
+
+    if (!fp)
+        return false;
+
+    ok = write_json(fp);
+    return (std::fclose(fp) == 0) && ok;
+}
+
+/*  Each thread has its own copy of this record. Serial numbers start at one, *
+ *  so a fresh record matches no telemetry.                                   */
+inline psow::telemetry::thread_identity &psow::telemetry::identity(void)
+{
+    static thread_local thread_identity self = {0ULL, nullptr};
+    return self;
+}
+
+inline unsigned long long psow::telemetry::next_serial(void)
+{
+    static std::atomic<unsigned long long> count(0ULL);
+    return count.fetch_add(1ULL, std::memory_order_relaxed) + 1ULL;
+}
+
+/*  steady_clock::now is a vDSO call on Linux, cheap enough for once per tile.*/
+inline unsigned long long
+psow::nanoseconds_since(std::chrono::steady_clock::time_point t)
+{
+    return static_cast<unsigned long long>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - t
+        ).count()
+    );
+}
+
+#endif
+/*  End of include guard.                                                     */
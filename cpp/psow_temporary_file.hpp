@@ -0,0 +1,115 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides temporary files that are renamed over their destination once *
+ *      written, with a name unique to the writer, so that processes and      *
+ *      threads writing the same path at once never share a temporary file.   *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_TEMPORARY_FILE_HPP
+#define PSOW_TEMPORARY_FILE_HPP
+
+/*  std::atomic, the counter that tells a process's temporary files apart.    */
+#include <atomic>
+
+/*  fopen, fclose, rename, remove, and snprintf.                              */
+#include <cstdio>
+
+/*  std::string, the name of the temporary file.                              */
+#include <string>
+
+/*  The process id is part of the name, from getpid or _getpid.               */
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#define PSOW_PROCESS_ID() static_cast<unsigned long>(::getpid())
+#elif defined(_WIN32)
+#include <process.h>
+#define PSOW_PROCESS_ID() static_cast<unsigned long>(::_getpid())
+#else
+#define PSOW_PROCESS_ID() 0UL
+#endif
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  Creates a new file for writing in the directory of path, named path   *
+     *  followed by the process id, a counter, and ".tmp". The file is opened *
+     *  with "wbx", so it is never one that already exists, and no other      *
+     *  writer, in this process or another, is handed the same file. name is  *
+     *  set to its name. Returns NULL on failure.                             */
+    inline std::FILE *open_temporary(const char *path, std::string &name);
+
+    /*  Closes a file from open_temporary and, if ok is true and the close    *
+     *  succeeds, renames it to path. Renaming is atomic on POSIX systems, so *
+     *  a reader of path sees the old file or the whole new one. Otherwise the*
+     *  temporary file is removed. Returns true if the file was renamed into  *
+     *  place.                                                                */
+    inline bool commit_temporary(std::FILE *fp, const std::string &name,
+                                 const char *path, bool ok);
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  A name left behind by a writer that died, whose process id has been       *
+ *  reused, is skipped by trying the next count.                              */
+inline std::FILE *psow::open_temporary(const char *path, std::string &name)
+{
+    static std::atomic<unsigned long> counter(0UL);
+    const unsigned long pid = PSOW_PROCESS_ID();
+    const unsigned int attempts = 64U;
+    char suffix[64];
+    unsigned int n;
+
+    for (n = 0U; n < attempts; ++n)
+    {
+        const unsigned long count = counter.fetch_add(1UL);
+        std::FILE *fp;
+
+        std::snprintf(suffix, sizeof(suffix), ".%lu.%lu.tmp", pid, count);
+        name = std::string(path) + suffix;
+        fp = std::fopen(name.c_str(), "wbx");
+
+        if (fp)
+            return fp;
+    }
+
+    name.clear();
+    return NULL;
+}
+/*  End of open_temporary.                                                    */
+
+/*  The file is removed on any failure, so no temporary file is left behind.  */
+inline bool psow::commit_temporary(std::FILE *fp, const std::string &name,
+                                   const char *path, bool ok)
+{
+    ok = (std::fclose(fp) == 0) && ok;
+    ok = ok && std::rename(name.c_str(), path) == 0;
+
+    if (!ok)
+        std::remove(name.c_str());
+
+    return ok;
+}
+/*  End of commit_temporary.                                                  */
+
+#undef PSOW_PROCESS_ID
+
+#endif
+/*  End of include guard.                                                     */
@@ -0,0 +1,499 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides a small work-stealing thread pool.                           *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_THREAD_POOL_HPP
+#define PSOW_THREAD_POOL_HPP
+
+/*  std::atomic, used for the counters shared between threads.                */
+#include <atomic>
+
+/*  std::condition_variable, used to put idle workers to sleep.               */
+#include <condition_variable>
+
+/*  std::sort and std::inplace_merge, used by parallel_sort.                  */
+#include <algorithm>
+
+/*  std::size_t is found here.                                                */
+#include <cstddef>
+
+/*  Each worker owns a double-ended queue of tasks.                           */
+#include <deque>
+
+/*  Tasks are stored as std::function objects.                                */
+#include <functional>
+
+/*  std::unique_ptr, used to store the per-worker queues.                     */
+#include <memory>
+
+/*  std::mutex and std::lock_guard.                                           */
+#include <mutex>
+
+/*  std::thread, the workers themselves.                                      */
+#include <thread>
+
+/*  std::vector, used for the list of workers and queues.                     */
+#include <vector>
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  A pool of threads with one task queue per thread. A thread pops tasks *
+     *  from the back of its own queue and, when that runs dry, steals from   *
+     *  the front of the other queues. The thread that calls wait() takes part*
+     *  in the work as queue zero, so a pool of N threads spawns N - 1 workers*
+     *  and a pool of one thread runs everything serially on the caller.      */
+    class thread_pool {
+        public:
+
+            /*  Type for the tasks handed to the pool.                        */
+            typedef std::function<void(void)> task;
+
+            /*  Constructor from the total number of threads to use. Zero is  *
+             *  treated as one.                                               */
+            inline explicit thread_pool(unsigned int number_of_threads);
+
+            /*  Destructor. Wakes the workers up and joins them.              */
+            inline ~thread_pool(void);
+
+            /*  Number of threads, including the one calling wait().          */
+            inline unsigned int size(void) const;
+
+            /*  Adds a task to the pool. Tasks submitted from inside another  *
+             *  task go to the submitting thread's own queue.                 */
+            inline void submit(const task &t);
+
+            /*  Runs tasks until everything submitted so far has finished.    */
+            inline void wait(void);
+
+            /*  Runs one queued task on the calling thread, as wait() would,  *
+             *  and returns true, or returns false at once if no task is      *
+             *  queued. Lets a thread help out while it waits for something   *
+             *  narrower than the whole pool.                                 */
+            inline bool run_one(void);
+
+            /*  Number of hardware threads, or one if this is unknown.        */
+            static inline unsigned int hardware_threads(void);
+
+        private:
+
+            /*  A queue of tasks and the lock protecting it.                  */
+            struct worker_queue {
+                std::mutex lock;
+                std::deque<task> tasks;
+            };
+
+            /*  Pops a task from the back of the given queue.                 */
+            inline bool pop(unsigned int index, task &t);
+
+            /*  Steals a task from the front of any queue other than index.   */
+            inline bool steal(unsigned int index, task &t);
+
+            /*  Runs a task and updates the counters afterwards.              */
+            inline void execute(task &t);
+
+            /*  Main loop for the worker threads.                             */
+            inline void run(unsigned int index);
+
+            /*  Index of the queue owned by the current thread for this pool. */
+            inline unsigned int current_queue(void) const;
+
+            /*  Per-thread record of which pool and queue the thread works on.*/
+            struct thread_identity {
+                const thread_pool *pool;
+                unsigned int index;
+            };
+
+            /*  Returns the identity of the calling thread.                   */
+            static inline thread_identity &identity(void);
+
+            std::vector<std::unique_ptr<worker_queue> > queues;
+            std::vector<std::thread> workers;
+
+            /*  Lock and condition variable used for sleeping and waking.     */
+            std::mutex sleep_lock;
+            std::condition_variable wake;
+
+            /*  Tasks sitting in a queue, and tasks not yet finished.         */
+            std::atomic<unsigned long> queued;
+            std::atomic<unsigned long> pending;
+
+            /*  Round-robin counter for tasks submitted from outside the pool.*/
+            std::atomic<unsigned int> next_queue;
+
+            /*  Set by the destructor to tell the workers to exit.            */
+            bool stopping;
+
+            /*  The pool owns threads, copying it makes no sense.             */
+            thread_pool(const thread_pool &);
+            thread_pool &operator = (const thread_pool &);
+    };
+    /*  End of thread_pool definition.                                        */
+
+    /*  Calls body(begin, end) on consecutive chunks of [0, n), spread over   *
+     *  the pool, and returns once every chunk is done. Must not be called    *
+     *  from inside a task.                                                   */
+    template <class body_type>
+    inline void parallel_for(thread_pool &pool, std::size_t n,
+                             const body_type &body);
+
+    /*  The most chunks parallel_for and parallel_for_chunks split a range    *
+     *  into.                                                                 */
+    inline std::size_t parallel_chunks(const thread_pool &pool);
+
+    /*  As parallel_for, over [begin, end), calling body(chunk, first, last). *
+     *  chunk numbers the chunks from zero, below parallel_chunks(pool), so   *
+     *  that each chunk can reduce into a slot of its own.                    */
+    template <class body_type>
+    inline void parallel_for_chunks(thread_pool &pool, std::size_t begin,
+                                    std::size_t end, const body_type &body);
+
+    /*  Sorts [first, last) with the pool. Each thread sorts a chunk with     *
+     *  std::sort, and the chunks are then merged pairwise, the merges of each*
+     *  round running in parallel. Must not be called from inside a task.     */
+    template <class iterator, class compare>
+    inline void parallel_sort(thread_pool &pool, iterator first,
+                              iterator last, const compare &less);
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  Creates the queues and spawns the worker threads.                         */
+inline psow::thread_pool::thread_pool(unsigned int number_of_threads)
+    : queued(0UL), pending(0UL), next_queue(0U), stopping(false)
+{
+    unsigned int n;
+
+    if (number_of_threads == 0U)
+        number_of_threads = 1U;
+
+    for (n = 0U; n < number_of_threads; ++n)
+        queues.push_back(std::unique_ptr<worker_queue>(new worker_queue()));
+
+    /*  Queue zero belongs to whichever thread calls wait().                  */
+    for (n = 1U; n < number_of_threads; ++n)
+        workers.push_back(std::thread(&thread_pool::run, this, n));
+}
+
+/*  Tells the workers to stop and joins them.                                 */
+inline psow::thread_pool::~thread_pool(void)
+{
+    std::size_t n;
+
+    {
+        std::lock_guard<std::mutex> guard(sleep_lock);
+        stopping = true;
+    }
+
+    wake.notify_all();
+
+    for (n = 0; n < workers.size(); ++n)
+        workers[n].join();
+}
+
+/*  The number of queues is the number of threads.                            */
+inline unsigned int psow::thread_pool::size(void) const
+{
+    return static_cast<unsigned int>(queues.size());
+}
+
+/*  Adds a task to a queue and wakes a sleeping worker up.                    */
+inline void psow::thread_pool::submit(const task &t)
+{
+    unsigned int index = current_queue();
+
+    /*  Outside of the pool the tasks are dealt out round-robin.              */
+    if (index == size())
+        index = next_queue.fetch_add(1U, std::memory_order_relaxed) % size();
+
+    pending.fetch_add(1UL);
+
+    {
+        std::lock_guard<std::mutex> guard(queues[index]->lock);
+        queues[index]->tasks.push_back(t);
+    }
+
+    queued.fetch_add(1UL);
+
+    /*  Taking the lock here ensures a worker that just saw an empty pool is  *
+     *  already waiting on the condition variable, so the wakeup is not lost. */
+    {
+        std::lock_guard<std::mutex> guard(sleep_lock);
+    }
+
+    wake.notify_one();
+}
+
+/*  The calling thread works on queue zero until every task is done.          */
+inline void psow::thread_pool::wait(void)
+{
+    task t;
+    thread_identity &self = identity();
+    const thread_identity saved = self;
+
+    self.pool = this;
+    self.index = 0U;
+
+    while (pending.load() != 0UL)
+    {
+        if (pop(0U, t) || steal(0U, t))
+        {
+            execute(t);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> guard(sleep_lock);
+        wake.wait(guard, [this]() {
+            return pending.load() == 0UL || queued.load() != 0UL;
+        });
+    }
+
+    self = saved;
+}
+
+/*  The caller works as queue zero for the length of the one task.            */
+inline bool psow::thread_pool::run_one(void)
+{
+    task t;
+    thread_identity &self = identity();
+    const thread_identity saved = self;
+    bool found;
+
+    self.pool = this;
+    self.index = 0U;
+    found = pop(0U, t) || steal(0U, t);
+
+    if (found)
+        execute(t);
+
+    self = saved;
+    return found;
+}
+
+/*  Falls back to one if the implementation cannot tell.                      */
+inline unsigned int psow::thread_pool::hardware_threads(void)
+{
+    const unsigned int n = std::thread::hardware_concurrency();
+
+    if (n == 0U)
+        return 1U;
+
+    return n;
+}
+
+/*  The owner of a queue works from the back, last in first out.              */
+inline bool psow::thread_pool::pop(unsigned int index, task &t)
+{
+    std::lock_guard<std::mutex> guard(queues[index]->lock);
+
+    if (queues[index]->tasks.empty())
+        return false;
+
+    t = queues[index]->tasks.back();
+    queues[index]->tasks.pop_back();
+    queued.fetch_sub(1UL);
+    return true;
+}
+
+/*  Thieves take from the front, which holds the oldest (largest) tasks.      */
+inline bool psow::thread_pool::steal(unsigned int index, task &t)
+{
+    unsigned int n;
+
+    for (n = 1U; n < size(); ++n)
+    {
+        worker_queue &victim = *queues[(index + n) % size()];
+        std::lock_guard<std::mutex> guard(victim.lock);
+
+        if (victim.tasks.empty())
+            continue;
+
+        t = victim.tasks.front();
+        victim.tasks.pop_front();
+        queued.fetch_sub(1UL);
+        return true;
+    }
+
+    return false;
+}
+
+/*  Runs the task. The last task to finish wakes up the waiting thread.       */
+inline void psow::thread_pool::execute(task &t)
+{
+    t();
+    t = task();
+
+    if (pending.fetch_sub(1UL) == 1UL)
+    {
+        {
+            std::lock_guard<std::mutex> guard(sleep_lock);
+        }
+
+        wake.notify_all();
+    }
+}
+
+/*  Workers run tasks while there are any, and sleep otherwise.               */
+inline void psow::thread_pool::run(unsigned int index)
+{
+    task t;
+    thread_identity &self = identity();
+
+    self.pool = this;
+    self.index = index;
+
+    while (true)
+    {
+        if (pop(index, t) || steal(index, t))
+        {
+            execute(t);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> guard(sleep_lock);
+        wake.wait(guard, [this]() {
+            return stopping || queued.load() != 0UL;
+        });
+
+        if (stopping)
+            return;
+    }
+}
+
+/*  Threads that do not belong to this pool get the out-of-range index size().*/
+inline unsigned int psow::thread_pool::current_queue(void) const
+{
+    const thread_identity &self = identity();
+
+    if (self.pool == this)
+        return self.index;
+
+    return size();
+}
+
+/*  Each thread has its own copy of this record.                              */
+inline psow::thread_pool::thread_identity &psow::thread_pool::identity(void)
+{
+    static thread_local thread_identity self = {nullptr, 0U};
+    return self;
+}
+
+/*  Four chunks per thread leaves room for the work stealing to even out      *
+ *  chunks that take longer than others.                                      */
+inline std::size_t psow::parallel_chunks(const thread_pool &pool)
+{
+    return 4 * static_cast<std::size_t>(pool.size());
+}
+
+/*  A pool of one thread runs the whole range as one chunk on the caller.     */
+template <class body_type>
+inline void psow::parallel_for_chunks(thread_pool &pool, std::size_t begin,
+                                      std::size_t end, const body_type &body)
+{
+    std::size_t chunk, first;
+    const std::size_t n = end - begin;
+    const std::size_t chunks = parallel_chunks(pool);
+    const std::size_t chunk_size = (n + chunks - 1) / chunks;
+
+    if (n == 0)
+        return;
+
+    if (pool.size() == 1U)
+    {
+        body(static_cast<std::size_t>(0), begin, end);
+        return;
+    }
+
+    for (chunk = 0, first = begin; first < end; ++chunk, first += chunk_size)
+    {
+        const std::size_t left = end - first;
+        const std::size_t last =
+            first + (left < chunk_size ? left : chunk_size);
+
+        pool.submit([&body, chunk, first, last]() {
+            body(chunk, first, last);
+        });
+    }
+
+    pool.wait();
+}
+/*  End of parallel_for_chunks.                                               */
+
+/*  The chunk numbers are not needed here.                                    */
+template <class body_type>
+inline void psow::parallel_for(thread_pool &pool, std::size_t n,
+                               const body_type &body)
+{
+    parallel_for_chunks(pool, 0, n,
+        [&body](std::size_t, std::size_t first, std::size_t last) {
+            body(first, last);
+        }
+    );
+}
+/*  End of parallel_for.                                                      */
+
+/*  Sort one chunk per thread, then merge neighbouring sorted runs, doubling  *
+ *  the run length every round.                                               */
+template <class iterator, class compare>
+inline void psow::parallel_sort(thread_pool &pool, iterator first,
+                                iterator last, const compare &less)
+{
+    std::size_t begin;
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    const std::size_t chunks = static_cast<std::size_t>(pool.size());
+    std::size_t run = (n + chunks - 1) / chunks;
+
+    if (pool.size() == 1U || n < 2 * chunks)
+    {
+        std::sort(first, last, less);
+        return;
+    }
+
+    for (begin = 0; begin < n; begin += run)
+    {
+        const std::size_t end = (n - begin < run ? n : begin + run);
+        pool.submit([first, begin, end, &less]() {
+            std::sort(first + begin, first + end, less);
+        });
+    }
+
+    pool.wait();
+
+    for (; run < n; run *= 2)
+    {
+        for (begin = 0; begin + run < n; begin += 2 * run)
+        {
+            const std::size_t mid = begin + run;
+            const std::size_t end = (n - mid < run ? n : mid + run);
+            pool.submit([first, begin, mid, end, &less]() {
+                std::inplace_merge(first + begin, first + mid, first + end,
+                                   less);
+            });
+        }
+
+        pool.wait();
+    }
+}
+/*  End of parallel_sort.                                                     */
+
+#endif
+/*  End of include guard.                                                     */
@@ -0,0 +1,325 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides scoped trace zones for the hot paths. With PSOW_TRACE defined*
+ *      to 1, every PSOW_TRACE_SCOPE records its start and duration into a    *
+ *      ring buffer owned by the calling thread, and the buffers can be       *
+ *      written out as Chrome trace_event JSON, viewable in chrome://tracing  *
+ *      or Perfetto. Otherwise PSOW_TRACE_SCOPE expands to nothing and costs  *
+ *      nothing.                                                              *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_TRACE_HPP
+#define PSOW_TRACE_HPP
+
+/*  std::chrono::steady_clock, the time stamps of the zones.                  */
+#include <chrono>
+
+/*  fprintf, fopen, and fclose.                                               */
+#include <cstdio>
+
+/*  std::unique_ptr, used to keep the buffers alive after their threads end.  */
+#include <memory>
+
+/*  std::mutex, protecting the list of buffers.                               */
+#include <mutex>
+
+/*  std::vector, the buffers and the list of them.                            */
+#include <vector>
+
+/*  Tracing is off unless asked for, on the command line or by CMake's        *
+ *  PSOW_TRACE option.                                                        */
+#ifndef PSOW_TRACE
+#define PSOW_TRACE 0
+#endif
+
+/*  Events kept per thread, a power of two. Once a buffer is full the oldest  *
+ *  events are overwritten, so a trace always holds the most recent ones.     */
+#ifndef PSOW_TRACE_CAPACITY
+#define PSOW_TRACE_CAPACITY 262144
+#endif
+
+/*  Times the rest of the enclosing block as a zone named name, which must be *
+ *  a string literal, or at least outlive the trace, and contain nothing that *
+ *  needs escaping in JSON.                                                   */
+#if PSOW_TRACE
+#define PSOW_TRACE_CONCAT_IMPL(a, b) a##b
+#define PSOW_TRACE_CONCAT(a, b) PSOW_TRACE_CONCAT_IMPL(a, b)
+#define PSOW_TRACE_SCOPE(name)                                                 \
+    const psow::trace_zone PSOW_TRACE_CONCAT(psow_trace_zone_, __LINE__)(name)
+#else
+#define PSOW_TRACE_SCOPE(name) static_cast<void>(0)
+#endif
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  True if this build records trace zones.                               */
+    const bool trace_enabled = (PSOW_TRACE != 0);
+
+    /*  One finished zone. Times are nanoseconds on the steady clock.         */
+    struct trace_event {
+        const char *name;
+        unsigned long long start_ns;
+        unsigned long long duration_ns;
+    };
+
+    /*  The ring buffer of one thread. Only that thread writes to it, so      *
+     *  recording an event is a store and an increment, with no lock or       *
+     *  atomic.                                                               */
+    struct trace_buffer {
+        static_assert((PSOW_TRACE_CAPACITY & (PSOW_TRACE_CAPACITY - 1)) == 0,
+                      "PSOW_TRACE_CAPACITY must be a power of two");
+
+        std::vector<trace_event> events;
+
+        /*  Events recorded since the last clear, including overwritten ones. */
+        unsigned long long count;
+
+        /*  Thread number used in the trace, in the order threads first       *
+         *  traced.                                                           */
+        unsigned int thread;
+
+        /*  Constructor from the thread number. Allocates the whole ring.     */
+        inline explicit trace_buffer(unsigned int thread_number);
+
+        /*  Adds an event, overwriting the oldest one if the ring is full.    */
+        inline void record(const char *name, unsigned long long start_ns,
+                           unsigned long long duration_ns);
+    };
+
+    /*  Records the time between its construction and destruction as an event *
+     *  in the buffer of the calling thread. Used through PSOW_TRACE_SCOPE.   */
+    class trace_zone {
+        public:
+
+            /*  Looks up the buffer and reads the clock.                      */
+            inline explicit trace_zone(const char *zone_name);
+
+            /*  Reads the clock again and records the event.                  */
+            inline ~trace_zone(void);
+
+        private:
+            const char *name;
+            trace_buffer *buffer;
+            unsigned long long start_ns;
+
+            /*  A zone is tied to one block, copying it makes no sense.       */
+            trace_zone(const trace_zone &);
+            trace_zone &operator = (const trace_zone &);
+    };
+
+    /*  Nanoseconds on the steady clock, the time base of the events.         */
+    inline unsigned long long trace_now(void);
+
+    /*  Buffer of the calling thread, created on its first call.              */
+    inline trace_buffer &thread_trace_buffer(void);
+
+    /*  Writes the events of every thread as Chrome trace_event JSON, times   *
+     *  relative to the earliest event. Must not run while zones are being    *
+     *  recorded, for example call it after thread_pool::wait. Returns false  *
+     *  if writing failed.                                                    */
+    inline bool write_chrome_trace(FILE *fp);
+
+    /*  As above, to the file at path.                                        */
+    inline bool write_chrome_trace(const char *path);
+
+    /*  Discards the events recorded so far, under the same condition.        */
+    inline void clear_trace(void);
+
+    /*  The buffers of every thread that has traced, and their lock. Buffers  *
+     *  outlive their threads so that pools can be torn down before the trace *
+     *  is written.                                                           */
+    struct trace_registry {
+        std::mutex lock;
+        std::vector<std::unique_ptr<trace_buffer> > buffers;
+    };
+
+    /*  Returns the registry shared by all threads.                           */
+    inline trace_registry &global_trace_registry(void);
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  Touching the whole ring up front keeps page faults out of the zones.      */
+inline psow::trace_buffer::trace_buffer(unsigned int thread_number)
+    : events(PSOW_TRACE_CAPACITY), count(0ULL), thread(thread_number)
+{
+    return;
+}
+
+/*  The capacity is a power of two, so the position is a mask.                */
+inline void psow::trace_buffer::record(const char *name,
+                                       unsigned long long start_ns,
+                                       unsigned long long duration_ns)
+{
+    trace_event &e = events[count & (PSOW_TRACE_CAPACITY - 1ULL)];
+    e.name = name;
+    e.start_ns = start_ns;
+    e.duration_ns = duration_ns;
+    ++count;
+}
+
+/*  The buffer is found once, when the zone opens.                            */
+inline psow::trace_zone::trace_zone(const char *zone_name)
+    : name(zone_name), buffer(&thread_trace_buffer()), start_ns(trace_now())
+{
+    return;
+}
+
+inline psow::trace_zone::~trace_zone(void)
+{
+    buffer->record(name, start_ns, trace_now() - start_ns);
+}
+
+/*  The steady clock's epoch is arbitrary, write_chrome_trace subtracts the   *
+ *  earliest start.                                                           */
+inline unsigned long long psow::trace_now(void)
+{
+    return static_cast<unsigned long long>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count()
+    );
+}
+
+/*  The lock is only taken on a thread's first zone.                          */
+inline psow::trace_buffer &psow::thread_trace_buffer(void)
+{
+    static thread_local trace_buffer *self = nullptr;
+
+    if (!self)
+    {
+        trace_registry &registry = global_trace_registry();
+        std::lock_guard<std::mutex> guard(registry.lock);
+        const unsigned int thread =
+            static_cast<unsigned int>(registry.buffers.size());
+
+        registry.buffers.push_back(
+            std::unique_ptr<trace_buffer>(new trace_buffer(thread))
+        );
+
+        self = registry.buffers.back().get();
+    }
+
+    return *self;
+}
+
+/*  Zones are written as complete ("X") events, in microseconds, and every    *
+ *  thread gets a name through a metadata ("M") event. Events lost to the ring*
+ *  wrapping around are counted in otherData.                                 */
+inline bool psow::write_chrome_trace(FILE *fp)
+{
+    trace_registry &registry = global_trace_registry();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    std::size_t n;
+    unsigned long long k, origin = ~0ULL, dropped = 0ULL;
+    const char *separator = "";
+    int status = 0;
+
+    for (n = 0; n < registry.buffers.size(); ++n)
+    {
+        const trace_buffer &b = *registry.buffers[n];
+        const unsigned long long kept =
+            (b.count < PSOW_TRACE_CAPACITY ? b.count : PSOW_TRACE_CAPACITY);
+
+        for (k = 0ULL; k < kept; ++k)
+            origin = (b.events[k].start_ns < origin ? b.events[k].start_ns
+                                                     : origin);
+
+        dropped += b.count - kept;
+    }
+
+    status |= std::fprintf(fp, "{\n  \"traceEvents\": [") < 0;
+
+    for (n = 0; n < registry.buffers.size(); ++n)
+    {
+        const trace_buffer &b = *registry.buffers[n];
+        const unsigned long long kept =
+            (b.count < PSOW_TRACE_CAPACITY ? b.count : PSOW_TRACE_CAPACITY);
+
+        status |= std::fprintf(
+            fp,
+            "%s\n    {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, "
+            "\"tid\": %u, \"args\": {\"name\": \"thread %u\"}}",
+            separator, b.thread, b.thread
+        ) < 0;
+
+        separator = ",";
+
+        for (k = 0ULL; k < kept; ++k)
+        {
+            const trace_event &e = b.events[k];
+
+            status |= std::fprintf(
+                fp,
+                ",\n    {\"name\": \"%s\", \"cat\": \"psow\", \"ph\": \"X\", "
+                "\"pid\": 1, \"tid\": %u, \"ts\": %.3f, \"dur\": %.3f}",
+                e.name, b.thread,
+                1.0E-3 * static_cast<double>(e.start_ns - origin),
+                1.0E-3 * static_cast<double>(e.duration_ns)
+            ) < 0;
+        }
+    }
+
+    status |= std::fprintf(
+        fp,
+        "\n  ],\n  \"displayTimeUnit\": \"ns\",\n"
+        "  \"otherData\": {\"dropped_events\": %llu}\n}\n",
+        dropped
+    ) < 0;
+
+    return status == 0;
+}
+/*  End of write_chrome_trace.                                                */
+
+/*  fclose can fail too, for example when flushing to a full disk.            */
+inline bool psow::write_chrome_trace(const char *path)
+{
+    FILE *fp = std::fopen(path, "w");
+    bool ok;
+
+    if (!fp)
+        return false;
+
+    ok = write_chrome_trace(fp);
+    return (std::fclose(fp) == 0) && ok;
+}
+
+/*  The buffers are kept, only their counts are reset.                        */
+inline void psow::clear_trace(void)
+{
+    trace_registry &registry = global_trace_registry();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    std::size_t n;
+
+    for (n = 0; n < registry.buffers.size(); ++n)
+        registry.buffers[n]->count = 0ULL;
+}
+
+/*  Initialized on first use, which C++11 makes thread-safe.                  */
+inline psow::trace_registry &psow::global_trace_registry(void)
+{
+    static trace_registry registry;
+    return registry;
+}
+
+#endif
+/*  End of include guard.                                                     */
@@ -34,46 +34,62 @@
 /*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
 namespace psow {
 
-    /*  Struct used to represents vectors in R^3.                             */
-    struct vec3 {
+    /*  Struct used to represents vectors in R^3, with components of type     *
+     *  real, float or double. Use the vec3 and vec3f aliases below.          */
+    template <class real>
+    struct basic_vec3 {
 
-        /*  The data in a vector is it's Euclidean components.                */
-        double x, y, z;
+        /*  The scalar type, for the operators taking scalars.                */
+        typedef real value_type;
 
-        /*  Empty constructor. Do not set any of the variables, simply return.*/
-        inline vec3(void)
+        /*  The data in a vector is it's Euclidean components.                */
+        real x, y, z;
+
+        /*  Empty constructor. The components are left uninitialized, so      *
+         *  large arrays of vectors cost nothing to create. Value-initialized *
+         *  vectors, vec3(), are zero.                                        */
+        basic_vec3(void) = default;
+
+        /*  Constructor from three reals. Set the components to the inputs.   *
+         *  This, and every operator below that is a single expression, is    *
+         *  constexpr, so vectors can be built at compile time.               */
+        constexpr basic_vec3(real a, real b, real c)
+            : x(a), y(b), z(c)
         {
-            return;
         }
 
-        /*  Constructor from three doubles. Set the components to the inputs. */
-        inline vec3(double a, double b, double c)
+        /*  Conversion from a vector of another precision, which must be      *
+         *  asked for explicitly since it may round.                          */
+        template <class other>
+        constexpr explicit basic_vec3(const basic_vec3<other> &P)
+            : x(static_cast<real>(P.x)), y(static_cast<real>(P.y)),
+              z(static_cast<real>(P.z))
         {
-            x = a;
-            y = b;
-            z = c;
         }
 
         /*  Computes the Euclidean norm of the vector using Pythagoras.       */
-        inline double norm(void) const;
+        inline real norm(void) const;
 
         /*  Computes the square of the Euclidean norm. Avoids sqrt call.      */
-        inline double normsq(void) const;
+        constexpr real normsq(void) const;
 
         /*  Computes the azimuthal component of the vector.                   */
-        inline double rho(void) const;
+        inline real rho(void) const;
 
         /*  Computes the square of the cylindrical part of the vector.        */
-        inline double rhosq(void) const;
+        constexpr real rhosq(void) const;
 
         /*  Computes the Euclidean dot product with another vector.           */
-        inline double dot(const vec3 &P) const;
+        constexpr real dot(const basic_vec3 &P) const;
 
         /*  Computes the standard cross-product with another vector.          */
-        inline vec3 cross(const vec3 &P) const;
+        constexpr basic_vec3 cross(const basic_vec3 &P) const;
 
         /*  Returns a vector of unit magnitude in the same direction.         */
-        inline vec3 unit(void) const;
+        inline basic_vec3 unit(void) const;
+
+        /*  Same as unit, but the zero vector gives zero rather than NaN.     */
+        inline basic_vec3 unit_or_zero(void) const;
 
         /*  Normalize "this" vector.                                          */
         inline void normalize(void);
@@ -81,18 +97,31 @@ namespace psow {
         /*  Simple print function for vectors.                                */
         inline void print(void) const;
     };
-    /*  End of vec3 definition.                                               */
+    /*  End of basic_vec3 definition.                                         */
+
+    /*  Double precision vectors, used throughout, and single precision ones  *
+     *  for where half the memory and twice the SIMD width matter more.       */
+    typedef basic_vec3<double> vec3;
+    typedef basic_vec3<float> vec3f;
 }
 /*  End of "psow" namespace.                                                  */
 
+/*  The scalars of the operators below are taken as value_type, which is not  *
+ *  deduced, so vec3f * 0.5 and 2 * vec3 convert the scalar as they did when  *
+ *  vec3 was a plain struct.                                                  */
+
 /*  Vector addition operator.                                                 */
-inline psow::vec3 operator + (const psow::vec3 &P, const psow::vec3 &Q)
+template <class real>
+constexpr psow::basic_vec3<real>
+operator + (const psow::basic_vec3<real> &P, const psow::basic_vec3<real> &Q)
 {
-    return psow::vec3(P.x + Q.x, P.y + Q.y, P.z + Q.z);
+    return psow::basic_vec3<real>(P.x + Q.x, P.y + Q.y, P.z + Q.z);
 }
 
 /*  Vector addition operator.                                                 */
-inline void operator += (psow::vec3 &P, const psow::vec3 &Q)
+template <class real>
+inline void
+operator += (psow::basic_vec3<real> &P, const psow::basic_vec3<real> &Q)
 {
     P.x += Q.x;
     P.y += Q.y;
@@ -100,13 +129,17 @@ inline void operator += (psow::vec3 &P, const psow::vec3 &Q)
 }
 
 /*  Vector subtraction operator.                                              */
-inline psow::vec3 operator - (const psow::vec3 &P, const psow::vec3 &Q)
+template <class real>
+constexpr psow::basic_vec3<real>
+operator - (const psow::basic_vec3<real> &P, const psow::basic_vec3<real> &Q)
 {
-    return psow::vec3(P.x - Q.x, P.y - Q.y, P.z - Q.z);
+    return psow::basic_vec3<real>(P.x - Q.x, P.y - Q.y, P.z - Q.z);
 }
 
 /*  Vector subtraction operator.                                              */
-inline void operator -= (psow::vec3 &P, const psow::vec3 &Q)
+template <class real>
+inline void
+operator -= (psow::basic_vec3<real> &P, const psow::basic_vec3<real> &Q)
 {
     P.x -= Q.x;
     P.y -= Q.y;
@@ -114,99 +147,140 @@ inline void operator -= (psow::vec3 &P, const psow::vec3 &Q)
 }
 
 /*  Vector negation.                                                          */
-inline psow::vec3 operator - (const psow::vec3 &P)
+template <class real>
+constexpr psow::basic_vec3<real> operator - (const psow::basic_vec3<real> &P)
 {
-    return psow::vec3(-P.x, -P.y, -P.z);
+    return psow::basic_vec3<real>(-P.x, -P.y, -P.z);
 }
 
 /*  Scalar multiplication on the right.                                       */
-inline psow::vec3 operator * (const psow::vec3 &P, double a)
+template <class real>
+constexpr psow::basic_vec3<real>
+operator * (const psow::basic_vec3<real> &P,
+            typename psow::basic_vec3<real>::value_type a)
 {
-    return psow::vec3(a*P.x, a*P.y, a*P.z);
+    return psow::basic_vec3<real>(a*P.x, a*P.y, a*P.z);
 }
 
 /*  Scalar multiplication on the left.                                        */
-inline psow::vec3 operator * (double a, const psow::vec3 &P)
+template <class real>
+constexpr psow::basic_vec3<real>
+operator * (typename psow::basic_vec3<real>::value_type a,
+            const psow::basic_vec3<real> &P)
 {
-    return psow::vec3(a*P.x, a*P.y, a*P.z);
+    return psow::basic_vec3<real>(a*P.x, a*P.y, a*P.z);
 }
 
 /*  Scalar multiplication operator.                                           */
-inline void operator *= (psow::vec3 &P, double t)
+template <class real>
+inline void
+operator *= (psow::basic_vec3<real> &P,
+             typename psow::basic_vec3<real>::value_type t)
 {
     P.x *= t;
     P.y *= t;
     P.z *= t;
 }
 
-/*  Scalar division on the right.                                             */
-inline psow::vec3 operator / (const psow::vec3 &P, double a)
+/*  Scalar division on the right, one division and three multiplications.    */
+template <class real>
+constexpr psow::basic_vec3<real>
+operator / (const psow::basic_vec3<real> &P,
+            typename psow::basic_vec3<real>::value_type a)
 {
-    const double rcpr_a = 1.0 / a;
-    return psow::vec3(rcpr_a*P.x, rcpr_a*P.y, rcpr_a*P.z);
+    return P * (real(1) / a);
 }
 
 /*  Scalar division operator.                                                 */
-inline void operator /= (psow::vec3 &P, double t)
+template <class real>
+inline void
+operator /= (psow::basic_vec3<real> &P,
+             typename psow::basic_vec3<real>::value_type t)
 {
-    const double rcpr_t = 1.0 / t;
+    const real rcpr_t = real(1) / t;
     P.x *= rcpr_t;
     P.y *= rcpr_t;
     P.z *= rcpr_t;
 }
 
 /*  Euclidean norm (the length of the vector).                                */
-inline double psow::vec3::norm(void) const
+template <class real>
+inline real psow::basic_vec3<real>::norm(void) const
 {
     return std::sqrt(x*x + y*y + z*z);
 }
 
 /*  Square of the Euclidean norm.                                             */
-inline double psow::vec3::normsq(void) const
+template <class real>
+constexpr real psow::basic_vec3<real>::normsq(void) const
 {
     return x*x + y*y + z*z;
 }
 
 /*  Cylindrical part (the length of the azimuthal component).                 */
-inline double psow::vec3::rho(void) const
+template <class real>
+inline real psow::basic_vec3<real>::rho(void) const
 {
     return std::sqrt(x*x + y*y);
 }
 
 /*  Square of the cylindrical part.                                           */
-inline double psow::vec3::rhosq(void) const
+template <class real>
+constexpr real psow::basic_vec3<real>::rhosq(void) const
 {
     return x*x + y*y;
 }
 
 /*  Euclidean dot product.                                                    */
-inline double psow::vec3::dot(const psow::vec3 &P) const
+template <class real>
+constexpr real
+psow::basic_vec3<real>::dot(const psow::basic_vec3<real> &P) const
 {
     return P.x*x + P.y*y + P.z*z;
 }
 
 /*  Euclidean cross product in three dimensions.                              */
-inline psow::vec3 psow::vec3::cross(const psow::vec3 &P) const
+template <class real>
+constexpr psow::basic_vec3<real>
+psow::basic_vec3<real>::cross(const psow::basic_vec3<real> &P) const
 {
-    return psow::vec3(y*P.z - z*P.y, z*P.x - x*P.z, x*P.y - y*P.x);
+    return psow::basic_vec3<real>(y*P.z - z*P.y, z*P.x - x*P.z,
+                                  x*P.y - y*P.x);
 }
 
 /*  Unit vector for the given vector.                                         */
-inline psow::vec3 psow::vec3::unit(void) const
+template <class real>
+inline psow::basic_vec3<real> psow::basic_vec3<real>::unit(void) const
 {
     return *this / (*this).norm();
 }
 
+/*  Zero is the only vector with a zero norm, which unit would divide by.     */
+template <class real>
+inline psow::basic_vec3<real>
+psow::basic_vec3<real>::unit_or_zero(void) const
+{
+    const real n = normsq();
+
+    if (n > real(0))
+        return *this * (real(1) / std::sqrt(n));
+
+    return psow::basic_vec3<real>(real(0), real(0), real(0));
+}
+
 /*  Unit vector for the given vector.                                         */
-inline void psow::vec3::normalize(void)
+template <class real>
+inline void psow::basic_vec3<real>::normalize(void)
 {
     *this = this->unit();
 }
 
 /*  Simple function for printing out the values of the vector.                */
-inline void psow::vec3::print(void) const
+template <class real>
+inline void psow::basic_vec3<real>::print(void) const
 {
-    std::printf("<%f, %f, %f>", x, y, z);
+    std::printf("<%f, %f, %f>", static_cast<double>(x),
+                static_cast<double>(y), static_cast<double>(z));
 }
 
 #endif
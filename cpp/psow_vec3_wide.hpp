@@ -0,0 +1,1031 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is free software: you can redistribute it and/or modify         *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  This file is distributed in the hope that it will be useful,              *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with thie file.  If not, see <https://www.gnu.org/licenses/>.       *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides wide vectors: 4 or 8 vectors in R^3 stored component by      *
+ *      component, with the operators of vec3 acting on every lane at once.   *
+ ******************************************************************************
+ *  Author:     Ryan Maguire                                                  *
+ *  Date:       October 16, 2026                                              *
+ ******************************************************************************/
+
+/*  Include guard to prevent including this file twice.                       */
+#ifndef PSOW_VEC3_WIDE_HPP
+#define PSOW_VEC3_WIDE_HPP
+
+/*  sqrt function found here.                                                 */
+#include <cmath>
+
+/*  std::memcpy, for loads, stores, and viewing lanes as integers.            */
+#include <cstring>
+
+/*  vec3 struct provided here.                                                */
+#include "psow_vec3.hpp"
+
+/*  GCC and Clang have vector types, arrays of numbers that the arithmetic    *
+ *  operators act on element by element, compiled to vector instructions.     *
+ *  Other compilers get one lane at a time.                                   */
+#if defined(__GNUC__) || defined(__clang__)
+#define PSOW_WIDE_VECTORS 1
+#else
+#define PSOW_WIDE_VECTORS 0
+#endif
+
+/*  Size of the vector registers of the instruction set the code is compiled  *
+ *  for, SSE2 (or NEON) by default, AVX or AVX-512 with PSOW_NATIVE.          */
+#if defined(__AVX512F__)
+#define PSOW_WIDE_REGISTER_BYTES 64U
+#elif defined(__AVX__)
+#define PSOW_WIDE_REGISTER_BYTES 32U
+#else
+#define PSOW_WIDE_REGISTER_BYTES 16U
+#endif
+
+/*  The movemask and blend instructions, for wide_chunk_ops on x86.           */
+#if PSOW_WIDE_VECTORS && defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/*  Namespace for the project. "Peter-Shirley-One-Weekend."                   */
+namespace psow {
+
+    /*  The wide types hold N lanes as an array of chunks, each chunk a       *
+     *  vector type that fills one register, and every operation is a loop    *
+     *  over the chunks. Each step of the loop is then a single vector        *
+     *  instruction, so code written with the wide types is written once for  *
+     *  every width and instruction set, and runs on packets. A plain array   *
+     *  of lanes looks simpler, but it relies on the compiler finding the     *
+     *  vectors again after unrolling, which GCC only partly manages once a   *
+     *  few dozen operations are chained together.                            */
+
+    /*  Integer as wide as a lane of real, for the lanes of masks.            */
+    template <class real>
+    struct wide_mask_lane;
+
+    template <>
+    struct wide_mask_lane<float> {
+        typedef int type;
+    };
+
+    template <>
+    struct wide_mask_lane<double> {
+        typedef long long type;
+    };
+
+    /*  How N lanes of real are split into chunks.                            */
+    template <class real, unsigned int N>
+    struct wide_layout {
+        static_assert(N > 0U && N <= 32U && (N & (N - 1U)) == 0U,
+                      "wide types have a power of two lanes, at most 32");
+
+        typedef typename wide_mask_lane<real>::type mask_lane;
+
+#if PSOW_WIDE_VECTORS
+
+        /*  A register, or all N lanes if they take less than one.            */
+        static const unsigned int bytes =
+            (N * sizeof(real) < PSOW_WIDE_REGISTER_BYTES ?
+             N * sizeof(real) : PSOW_WIDE_REGISTER_BYTES);
+
+        typedef real chunk __attribute__((vector_size(bytes)));
+        typedef mask_lane mask_chunk __attribute__((vector_size(bytes)));
+#else
+        static const unsigned int bytes = sizeof(real);
+        typedef real chunk;
+        typedef mask_lane mask_chunk;
+#endif
+
+        /*  Lanes per chunk, and chunks per wide value.                       */
+        static const unsigned int width = bytes / sizeof(real);
+        static const unsigned int chunks = N / width;
+    };
+
+    /*  Per chunk operations on masks: the bits of the lanes, and picking     *
+     *  lanes of a where the mask is set and of b elsewhere. The general      *
+     *  version works on the bits of the lanes, x86 has instructions for      *
+     *  both. They also stop GCC from turning the bitwise select back into a  *
+     *  conditional, which it does one lane at a time on SSE2.                *
+     *                                                                        *
+     *  rsqrt_estimate is a starting guess for 1 / sqrt of each lane, for     *
+     *  fast_rsqrt to refine. x86 has estimates good to 12 bits, 14 with      *
+     *  AVX-512, which double lanes get by way of float. The general version  *
+     *  is exact.                                                             */
+    template <class real, unsigned int bytes>
+    struct wide_chunk_ops {
+        template <class mask_type>
+        static inline unsigned int bits(const mask_type &m);
+
+        template <class mask_type, class chunk_type>
+        static inline chunk_type select(const mask_type &m,
+                                        const chunk_type &a,
+                                        const chunk_type &b);
+
+        template <class chunk_type>
+        static inline chunk_type rsqrt_estimate(const chunk_type &a);
+    };
+
+#if PSOW_WIDE_VECTORS && defined(__SSE2__)
+    template <>
+    struct wide_chunk_ops<double, 16U> {
+        template <class mask_type>
+        static inline unsigned int bits(const mask_type &m)
+        {
+            const __m128d x = reinterpret_cast<__m128d>(m);
+            return static_cast<unsigned int>(_mm_movemask_pd(x));
+        }
+
+        template <class mask_type, class chunk_type>
+        static inline chunk_type select(const mask_type &m,
+                                        const chunk_type &a,
+                                        const chunk_type &b)
+        {
+            const __m128d x = reinterpret_cast<__m128d>(m);
+            return _mm_or_pd(_mm_and_pd(x, a), _mm_andnot_pd(x, b));
+        }
+
+        template <class chunk_type>
+        static inline chunk_type rsqrt_estimate(const chunk_type &a)
+        {
+            return _mm_cvtps_pd(_mm_rsqrt_ps(_mm_cvtpd_ps(a)));
+        }
+    };
+
+    template <>
+    struct wide_chunk_ops<float, 16U> {
+        template <class mask_type>
+        static inline unsigned int bits(const mask_type &m)
+        {
+            const __m128 x = reinterpret_cast<__m128>(m);
+            return static_cast<unsigned int>(_mm_movemask_ps(x));
+        }
+
+        template <class mask_type, class chunk_type>
+        static inline chunk_type select(const mask_type &m,
+                                        const chunk_type &a,
+                                        const chunk_type &b)
+        {
+            const __m128 x = reinterpret_cast<__m128>(m);
+            return _mm_or_ps(_mm_and_ps(x, a), _mm_andnot_ps(x, b));
+        }
+
+        template <class chunk_type>
+        static inline chunk_type rsqrt_estimate(const chunk_type &a)
+        {
+            return _mm_rsqrt_ps(a);
+        }
+    };
+#endif
+
+#if PSOW_WIDE_VECTORS && defined(__AVX__)
+    template <>
+    struct wide_chunk_ops<double, 32U> {
+        template <class mask_type>
+        static inline unsigned int bits(const mask_type &m)
+        {
+            const __m256d x = reinterpret_cast<__m256d>(m);
+            return static_cast<unsigned int>(_mm256_movemask_pd(x));
+        }
+
+        template <class mask_type, class chunk_type>
+        static inline chunk_type select(const mask_type &m,
+                                        const chunk_type &a,
+                                        const chunk_type &b)
+        {
+            const __m256d x = reinterpret_cast<__m256d>(m);
+            return _mm256_blendv_pd(b, a, x);
+        }
+
+        template <class chunk_type>
+        static inline chunk_type rsqrt_estimate(const chunk_type &a)
+        {
+            return _mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(a)));
+        }
+    };
+
+    template <>
+    struct wide_chunk_ops<float, 32U> {
+        template <class mask_type>
+        static inline unsigned int bits(const mask_type &m)
+        {
+            const __m256 x = reinterpret_cast<__m256>(m);
+            return static_cast<unsigned int>(_mm256_movemask_ps(x));
+        }
+
+        template <class mask_type, class chunk_type>
+        static inline chunk_type select(const mask_type &m,
+                                        const chunk_type &a,
+                                        const chunk_type &b)
+        {
+            const __m256 x = reinterpret_cast<__m256>(m);
+            return _mm256_blendv_ps(b, a, x);
+        }
+
+        template <class chunk_type>
+        static inline chunk_type rsqrt_estimate(const chunk_type &a)
+        {
+            return _mm256_rsqrt_ps(a);
+        }
+    };
+#endif
+
+#if PSOW_WIDE_VECTORS && defined(__AVX512F__)
+    template <>
+    struct wide_chunk_ops<double, 64U> {
+        template <class mask_type>
+        static inline unsigned int bits(const mask_type &m)
+        {
+            const __m512i x = reinterpret_cast<__m512i>(m);
+            return static_cast<unsigned int>(_mm512_test_epi64_mask(x, x));
+        }
+
+        template <class mask_type, class chunk_type>
+        static inline chunk_type select(const mask_type &m,
+                                        const chunk_type &a,
+                                        const chunk_type &b)
+        {
+            const __m512i x = reinterpret_cast<__m512i>(m);
+            return _mm512_mask_blend_pd(_mm512_test_epi64_mask(x, x), b, a);
+        }
+
+        /*  The zero masked form, since GCC warns that the plain one reads    *
+         *  an uninitialized register, which it only merges into.             */
+        template <class chunk_type>
+        static inline chunk_type rsqrt_estimate(const chunk_type &a)
+        {
+            return _mm512_maskz_rsqrt14_pd(static_cast<__mmask8>(0xFF), a);
+        }
+    };
+
+    template <>
+    struct wide_chunk_ops<float, 64U> {
+        template <class mask_type>
+        static inline unsigned int bits(const mask_type &m)
+        {
+            const __m512i x = reinterpret_cast<__m512i>(m);
+            return static_cast<unsigned int>(_mm512_test_epi32_mask(x, x));
+        }
+
+        template <class mask_type, class chunk_type>
+        static inline chunk_type select(const mask_type &m,
+                                        const chunk_type &a,
+                                        const chunk_type &b)
+        {
+            const __m512i x = reinterpret_cast<__m512i>(m);
+            return _mm512_mask_blend_ps(_mm512_test_epi32_mask(x, x), b, a);
+        }
+
+        template <class chunk_type>
+        static inline chunk_type rsqrt_estimate(const chunk_type &a)
+        {
+            const __mmask16 all = static_cast<__mmask16>(0xFFFF);
+            return _mm512_maskz_rsqrt14_ps(all, a);
+        }
+    };
+#endif
+
+    /*  A true or false per lane, the result of comparing wide values. A lane *
+     *  is an integer the width of real with every bit set for true, which is *
+     *  what the vector compare instructions produce, so select is a few      *
+     *  bitwise operations.                                                   */
+    template <class real, unsigned int N>
+    struct wide_mask {
+        typedef wide_layout<real, N> layout;
+        typedef typename layout::mask_chunk chunk_type;
+
+        chunk_type chunk[layout::chunks];
+
+        /*  Empty constructor. Do not set any of the lanes, simply return.    */
+        inline wide_mask(void)
+        {
+            return;
+        }
+
+        /*  Every lane set to b.                                              */
+        inline explicit wide_mask(bool b);
+
+        /*  Lane i.                                                           */
+        inline bool operator [] (unsigned int i) const;
+
+        /*  True if any, or every, lane is set.                               */
+        inline bool any(void) const;
+        inline bool all(void) const;
+
+        /*  Bit i is set if lane i is, as in the packet kernels' hit masks.   */
+        inline unsigned int bits(void) const;
+    };
+    /*  End of wide_mask definition.                                          */
+
+    /*  N lanes of the scalar type real. With PSOW_NATIVE on an AVX-512       *
+     *  machine a chunk is 64 bytes and so is the alignment of the type, and  *
+     *  std::vector needs psow::aligned_allocator to hold them before C++17.  */
+    template <class real, unsigned int N>
+    struct wide {
+        typedef wide_layout<real, N> layout;
+        typedef typename layout::chunk chunk_type;
+
+        /*  Number of lanes, and the type of one.                             */
+        static const unsigned int size = N;
+        typedef real value_type;
+
+        chunk_type chunk[layout::chunks];
+
+        /*  Empty constructor. Do not set any of the lanes, simply return.    */
+        inline wide(void)
+        {
+            return;
+        }
+
+        /*  Every lane set to a. Implicit, so scalars mix with wide values.   */
+        inline wide(real a);
+
+        /*  Lanes from N consecutive values.                                  */
+        static inline wide load(const real *p);
+
+        /*  Writes the lanes to N consecutive values.                         */
+        inline void store(real *p) const;
+
+        /*  Lane i, and setting it. These are slow next to the operators,     *
+         *  for the odd lane, not for loops over all of them.                 */
+        inline real operator [] (unsigned int i) const;
+        inline void set(unsigned int i, real a);
+    };
+    /*  End of wide definition.                                               */
+
+    /*  N vectors in R^3, the x components of all lanes together, then the y, *
+     *  then the z, the same layout as ray_packet.                            */
+    template <class real, unsigned int N>
+    struct basic_vec3x {
+        typedef wide<real, N> wide_type;
+
+        wide_type x, y, z;
+
+        /*  Empty constructor. Do not set any of the lanes, simply return.    */
+        inline basic_vec3x(void)
+        {
+            return;
+        }
+
+        /*  Constructor from the three wide components.                       */
+        inline basic_vec3x(const wide_type &a, const wide_type &b,
+                           const wide_type &c)
+            : x(a), y(b), z(c)
+        {
+            return;
+        }
+
+        /*  Every lane set to the vector P.                                   */
+        inline explicit basic_vec3x(const basic_vec3<real> &P)
+            : x(P.x), y(P.y), z(P.z)
+        {
+            return;
+        }
+
+        /*  Lanes from N consecutive values of each component array.          */
+        static inline basic_vec3x load(const real *px, const real *py,
+                                       const real *pz);
+
+        /*  Writes the lanes to N consecutive values of each array.           */
+        inline void store(real *px, real *py, real *pz) const;
+
+        /*  The vector in lane i, and setting it.                             */
+        inline basic_vec3<real> get(unsigned int i) const;
+        inline void set(unsigned int i, const basic_vec3<real> &P);
+
+        /*  Lane by lane versions of the vec3 functions.                      */
+        inline wide_type norm(void) const;
+        inline wide_type normsq(void) const;
+        inline wide_type dot(const basic_vec3x &P) const;
+        inline basic_vec3x cross(const basic_vec3x &P) const;
+        inline basic_vec3x unit(void) const;
+        inline basic_vec3x unit_or_zero(void) const;
+
+        /*  Sum of the vectors of all lanes.                                  */
+        inline basic_vec3<real> reduce_add(void) const;
+    };
+    /*  End of basic_vec3x definition.                                        */
+
+    /*  The widths that fill an SSE / AVX2 / AVX-512 register with doubles,   *
+     *  and AVX2 / two AVX2 registers with floats.                            */
+    typedef wide<double, 4> doublex4;
+    typedef wide<double, 8> doublex8;
+    typedef wide<float, 4> floatx4;
+    typedef wide<float, 8> floatx8;
+    typedef basic_vec3x<double, 4> vec3x4;
+    typedef basic_vec3x<double, 8> vec3x8;
+    typedef basic_vec3x<float, 4> vec3fx4;
+    typedef basic_vec3x<float, 8> vec3fx8;
+
+    /*  Lane by lane square root, minimum, and maximum.                       */
+    template <class real, unsigned int N>
+    inline wide<real, N> sqrt(const wide<real, N> &a);
+
+    template <class real, unsigned int N>
+    inline wide<real, N> min(const wide<real, N> &a, const wide<real, N> &b);
+
+    template <class real, unsigned int N>
+    inline wide<real, N> max(const wide<real, N> &a, const wide<real, N> &b);
+
+    /*  Lane i is a[i] where mask is set and b[i] where it is not.            */
+    template <class real, unsigned int N>
+    inline wide<real, N> select(const wide_mask<real, N> &mask,
+                                const wide<real, N> &a,
+                                const wide<real, N> &b);
+
+    template <class real, unsigned int N>
+    inline basic_vec3x<real, N> select(const wide_mask<real, N> &mask,
+                                       const basic_vec3x<real, N> &a,
+                                       const basic_vec3x<real, N> &b);
+
+    /*  Horizontal reductions, combining the lanes into one value.            */
+    template <class real, unsigned int N>
+    inline real reduce_add(const wide<real, N> &a);
+
+    template <class real, unsigned int N>
+    inline real reduce_min(const wide<real, N> &a);
+
+    template <class real, unsigned int N>
+    inline real reduce_max(const wide<real, N> &a);
+}
+/*  End of "psow" namespace.                                                  */
+
+/*  The operators follow psow_vec3.hpp: global, with scalar arguments taken   *
+ *  as the non-deduced value_type so that 2.0 * v and v * 0.5 work for every  *
+ *  precision. A scalar next to a wide value is broadcast to every lane.      */
+
+/*  Chunk by chunk arithmetic of wide values, with the scalar forms.          */
+#define PSOW_WIDE_OPERATOR(op)                                                 \
+template <class real, unsigned int N>                                          \
+inline psow::wide<real, N>                                                     \
+operator op (const psow::wide<real, N> &a, const psow::wide<real, N> &b)       \
+{                                                                              \
+    psow::wide<real, N> out;                                                   \
+    unsigned int k;                                                            \
+    for (k = 0U; k < psow::wide_layout<real, N>::chunks; ++k)                  \
+        out.chunk[k] = a.chunk[k] op b.chunk[k];                               \
+    return out;                                                                \
+}                                                                              \
+                                                                               \
+template <class real, unsigned int N>                                          \
+inline psow::wide<real, N>                                                     \
+operator op (const psow::wide<real, N> &a,                                     \
+             typename psow::wide<real, N>::value_type b)                       \
+{                                                                              \
+    return a op psow::wide<real, N>(b);                                        \
+}                                                                              \
+                                                                               \
+template <class real, unsigned int N>                                          \
+inline psow::wide<real, N>                                                     \
+operator op (typename psow::wide<real, N>::value_type a,                       \
+             const psow::wide<real, N> &b)                                     \
+{                                                                              \
+    return psow::wide<real, N>(a) op b;                                        \
+}
+
+PSOW_WIDE_OPERATOR(+)
+PSOW_WIDE_OPERATOR(-)
+PSOW_WIDE_OPERATOR(*)
+PSOW_WIDE_OPERATOR(/)
+
+#undef PSOW_WIDE_OPERATOR
+
+/*  A vector comparison already gives every bit set for true. One lane at a   *
+ *  time a bool does not, and is turned into all ones or zero.                */
+#if PSOW_WIDE_VECTORS
+#define PSOW_WIDE_COMPARE(a, op, b) ((a) op (b))
+#else
+#define PSOW_WIDE_COMPARE(a, op, b) ((a) op (b) ? -1 : 0)
+#endif
+
+/*  Lane by lane comparisons, giving a mask.                                  */
+#define PSOW_WIDE_COMPARISON(op)                                               \
+template <class real, unsigned int N>                                          \
+inline psow::wide_mask<real, N>                                                \
+operator op (const psow::wide<real, N> &a, const psow::wide<real, N> &b)       \
+{                                                                              \
+    psow::wide_mask<real, N> out;                                              \
+    unsigned int k;                                                            \
+    for (k = 0U; k < psow::wide_layout<real, N>::chunks; ++k)                  \
+        out.chunk[k] = PSOW_WIDE_COMPARE(a.chunk[k], op, b.chunk[k]);          \
+    return out;                                                                \
+}                                                                              \
+                                                                               \
+template <class real, unsigned int N>                                          \
+inline psow::wide_mask<real, N>                                                \
+operator op (const psow::wide<real, N> &a,                                     \
+             typename psow::wide<real, N>::value_type b)                       \
+{                                                                              \
+    return a op psow::wide<real, N>(b);                                        \
+}
+
+PSOW_WIDE_COMPARISON(<)
+PSOW_WIDE_COMPARISON(<=)
+PSOW_WIDE_COMPARISON(>)
+PSOW_WIDE_COMPARISON(>=)
+
+#undef PSOW_WIDE_COMPARISON
+#undef PSOW_WIDE_COMPARE
+
+/*  Chunk by chunk logic on masks, bitwise since a set lane is all ones.      */
+#define PSOW_WIDE_MASK_OPERATOR(op)                                            \
+template <class real, unsigned int N>                                          \
+inline psow::wide_mask<real, N>                                                \
+operator op (const psow::wide_mask<real, N> &a,                                \
+             const psow::wide_mask<real, N> &b)                                \
+{                                                                              \
+    psow::wide_mask<real, N> out;                                              \
+    unsigned int k;                                                            \
+    for (k = 0U; k < psow::wide_layout<real, N>::chunks; ++k)                  \
+        out.chunk[k] = a.chunk[k] op b.chunk[k];                               \
+    return out;                                                                \
+}
+
+PSOW_WIDE_MASK_OPERATOR(&)
+PSOW_WIDE_MASK_OPERATOR(|)
+
+#undef PSOW_WIDE_MASK_OPERATOR
+
+/*  Lane by lane not.                                                         */
+template <class real, unsigned int N>
+inline psow::wide_mask<real, N> operator ! (const psow::wide_mask<real, N> &a)
+{
+    psow::wide_mask<real, N> out;
+    unsigned int k;
+
+    for (k = 0U; k < psow::wide_layout<real, N>::chunks; ++k)
+        out.chunk[k] = ~a.chunk[k];
+
+    return out;
+}
+
+/*  Lane by lane negation.                                                    */
+template <class real, unsigned int N>
+inline psow::wide<real, N> operator - (const psow::wide<real, N> &a)
+{
+    psow::wide<real, N> out;
+    unsigned int k;
+
+    for (k = 0U; k < psow::wide_layout<real, N>::chunks; ++k)
+        out.chunk[k] = -a.chunk[k];
+
+    return out;
+}
+
+/*  Vector addition operator.                                                 */
+template <class real, unsigned int N>
+inline psow::basic_vec3x<real, N>
+operator + (const psow::basic_vec3x<real, N> &P,
+            const psow::basic_vec3x<real, N> &Q)
+{
+    return psow::basic_vec3x<real, N>(P.x + Q.x, P.y + Q.y, P.z + Q.z);
+}
+
+/*  Vector subtraction operator.                                              */
+template <class real, unsigned int N>
+inline psow::basic_vec3x<real, N>
+operator - (const psow::basic_vec3x<real, N> &P,
+            const psow::basic_vec3x<real, N> &Q)
+{
+    return psow::basic_vec3x<real, N>(P.x - Q.x, P.y - Q.y, P.z - Q.z);
+}
+
+/*  Vector negation.                                                          */
+template <class real, unsigned int N>
+inline psow::basic_vec3x<real, N>
+operator - (const psow::basic_vec3x<real, N> &P)
+{
+    return psow::basic_vec3x<real, N>(-P.x, -P.y, -P.z);
+}
+
+/*  Multiplication by a wide value or a scalar, on the right.                 */
+template <class real, unsigned int N>
+inline psow::basic_vec3x<real, N>
+operator * (const psow::basic_vec3x<real, N> &P,
+            const psow::wide<real, N> &a)
+{
+    return psow::basic_vec3x<real, N>(P.x * a, P.y * a, P.z * a);
+}
+
+template <class real, unsigned int N>
+inline psow::basic_vec3x<real, N>
+operator * (const psow::basic_vec3x<real, N> &P,
+            typename psow::wide<real, N>::value_type a)
+{
+    return P * psow::wide<real, N>(a);
+}
+
+/*  Multiplication by a wide value or a scalar, on the left.                  */
+template <class real, unsigned int N>
+inline psow::basic_vec3x<real, N>
+operator * (const psow::wide<real, N> &a,
+            const psow::basic_vec3x<real, N> &P)
+{
+    return P * a;
+}
+
+template <class real, unsigned int N>
+inline psow::basic_vec3x<real, N>
+operator * (typename psow::wide<real, N>::value_type a,
+            const psow::basic_vec3x<real, N> &P)
+{
+    return P * psow::wide<real, N>(a);
+}
+
+/*  Division by a wide value or a scalar, as one reciprocal and a multiply.   */
+template <class real, unsigned int N>
+inline psow::basic_vec3x<real, N>
+operator / (const psow::basic_vec3x<real, N> &P,
+            const psow::wide<real, N> &a)
+{
+    return P * (real(1) / a);
+}
+
+template <class real, unsigned int N>
+inline psow::basic_vec3x<real, N>
+operator / (const psow::basic_vec3x<real, N> &P,
+            typename psow::wide<real, N>::value_type a)
+{
+    return P * (real(1) / a);
+}
+
+/*  Every lane gets the same value.                                           */
+template <class real, unsigned int N>
+inline psow::wide_mask<real, N>::wide_mask(bool b)
+{
+    const typename layout::mask_lane value = (b ? -1 : 0);
+    unsigned int k;
+
+    for (k = 0U; k < layout::chunks; ++k)
+        chunk[k] = chunk_type() + value;
+}
+
+/*  The chunk holding lane i, then the lane within it.                        */
+template <class real, unsigned int N>
+inline bool psow::wide_mask<real, N>::operator [] (unsigned int i) const
+{
+#if PSOW_WIDE_VECTORS
+    return chunk[i / layout::width][i % layout::width] != 0;
+#else
+    return chunk[i] != 0;
+#endif
+}
+
+/*  Or of the lanes.                                                          */
+template <class real, unsigned int N>
+inline bool psow::wide_mask<real, N>::any(void) const
+{
+    return bits() != 0U;
+}
+
+/*  And of the lanes.                                                         */
+template <class real, unsigned int N>
+inline bool psow::wide_mask<real, N>::all(void) const
+{
+    return bits() == (N == 32U ? 0xFFFFFFFFU : (1U << N) - 1U);
+}
+
+/*  Lanes in order, so chunk k gives bits k * width and up.                   */
+template <class real, unsigned int N>
+inline unsigned int psow::wide_mask<real, N>::bits(void) const
+{
+    typedef wide_chunk_ops<real, layout::bytes> ops;
+    unsigned int out = 0U;
+    unsigned int k;
+
+    for (k = 0U; k < layout::chunks; ++k)
+        out |= ops::bits(chunk[k]) << (k * layout::width);
+
+    return out;
+}
+
+/*  Lanes of a mask are 0 or all ones, so the low bit of each will do.        */
+template <class real, unsigned int bytes>
+template <class mask_type>
+inline unsigned int psow::wide_chunk_ops<real, bytes>::bits(const mask_type &m)
+{
+#if PSOW_WIDE_VECTORS
+    const unsigned int width = bytes / sizeof(real);
+    unsigned int out = 0U;
+    unsigned int j;
+
+    for (j = 0U; j < width; ++j)
+        out |= static_cast<unsigned int>(m[j] & 1) << j;
+
+    return out;
+#else
+    return static_cast<unsigned int>(m & 1);
+#endif
+}
+
+/*  b with the bits where it differs from a flipped, where the mask is set.   */
+template <class real, unsigned int bytes>
+template <class mask_type, class chunk_type>
+inline chunk_type
+psow::wide_chunk_ops<real, bytes>::select(const mask_type &m,
+                                          const chunk_type &a,
+                                          const chunk_type &b)
+{
+    mask_type x, y, z;
+    chunk_type out;
+
+    std::memcpy(&x, &a, sizeof(x));
+    std::memcpy(&y, &b, sizeof(y));
+    z = y ^ ((x ^ y) & m);
+    std::memcpy(&out, &z, sizeof(out));
+    return out;
+}
+
+/*  The exact reciprocal square root of each lane. Only a guess is required,  *
+ *  this is for instruction sets without an estimate.                         */
+template <class real, unsigned int bytes>
+template <class chunk_type>
+inline chunk_type
+psow::wide_chunk_ops<real, bytes>::rsqrt_estimate(const chunk_type &a)
+{
+#if PSOW_WIDE_VECTORS
+    const unsigned int width = bytes / sizeof(real);
+    chunk_type out;
+    unsigned int j;
+
+    for (j = 0U; j < width; ++j)
+        out[j] = real(1) / std::sqrt(a[j]);
+
+    return out;
+#else
+    return real(1) / std::sqrt(a);
+#endif
+}
+
+/*  Broadcast. Adding to a zero chunk turns -0 into +0, so the lanes are set  *
+ *  one at a time, which compilers turn into a single broadcast.              */
+template <class real, unsigned int N>
+inline psow::wide<real, N>::wide(real a)
+{
+    unsigned int i;
+
+    for (i = 0U; i < N; ++i)
+        set(i, a);
+}
+
+/*  Plain copies, the pointer need not be aligned.                            */
+template <class real, unsigned int N>
+inline psow::wide<real, N> psow::wide<real, N>::load(const real *p)
+{
+    wide out;
+    std::memcpy(out.chunk, p, sizeof(out.chunk));
+    return out;
+}
+
+template <class real, unsigned int N>
+inline void psow::wide<real, N>::store(real *p) const
+{
+    std::memcpy(p, chunk, sizeof(chunk));
+}
+
+/*  The chunk holding lane i, then the lane within it.                        */
+template <class real, unsigned int N>
+inline real psow::wide<real, N>::operator [] (unsigned int i) const
+{
+#if PSOW_WIDE_VECTORS
+    return chunk[i / layout::width][i % layout::width];
+#else
+    return chunk[i];
+#endif
+}
+
+template <class real, unsigned int N>
+inline void psow::wide<real, N>::set(unsigned int i, real a)
+{
+#if PSOW_WIDE_VECTORS
+    chunk[i / layout::width][i % layout::width] = a;
+#else
+    chunk[i] = a;
+#endif
+}
+
+/*  One load per component array.                                             */
+template <class real, unsigned int N>
+inline psow::basic_vec3x<real, N>
+psow::basic_vec3x<real, N>::load(const real *px, const real *py,
+                                 const real *pz)
+{
+    return basic_vec3x(wide_type::load(px), wide_type::load(py),
+                       wide_type::load(pz));
+}
+
+/*  One store per component array.                                            */
+template <class real, unsigned int N>
+inline void
+psow::basic_vec3x<real, N>::store(real *px, real *py, real *pz) const
+{
+    x.store(px);
+    y.store(py);
+    z.store(pz);
+}
+
+/*  Gather lane i of each component.                                          */
+template <class real, unsigned int N>
+inline psow::basic_vec3<real>
+psow::basic_vec3x<real, N>::get(unsigned int i) const
+{
+    return psow::basic_vec3<real>(x[i], y[i], z[i]);
+}
+
+/*  Scatter P to lane i of each component.                                    */
+template <class real, unsigned int N>
+inline void
+psow::basic_vec3x<real, N>::set(unsigned int i, const basic_vec3<real> &P)
+{
+    x.set(i, P.x);
+    y.set(i, P.y);
+    z.set(i, P.z);
+}
+
+/*  Euclidean norm of every lane.                                             */
+template <class real, unsigned int N>
+inline psow::wide<real, N> psow::basic_vec3x<real, N>::norm(void) const
+{
+    return psow::sqrt(x*x + y*y + z*z);
+}
+
+/*  Square of the Euclidean norm of every lane.                               */
+template <class real, unsigned int N>
+inline psow::wide<real, N> psow::basic_vec3x<real, N>::normsq(void) const
+{
+    return x*x + y*y + z*z;
+}
+
+/*  Euclidean dot product, lane by lane.                                      */
+template <class real, unsigned int N>
+inline psow::wide<real, N>
+psow::basic_vec3x<real, N>::dot(const basic_vec3x &P) const
+{
+    return P.x*x + P.y*y + P.z*z;
+}
+
+/*  Cross product, lane by lane.                                              */
+template <class real, unsigned int N>
+inline psow::basic_vec3x<real, N>
+psow::basic_vec3x<real, N>::cross(const basic_vec3x &P) const
+{
+    return basic_vec3x(y*P.z - z*P.y, z*P.x - x*P.z, x*P.y - y*P.x);
+}
+
+/*  Unit vectors, lane by lane.                                               */
+template <class real, unsigned int N>
+inline psow::basic_vec3x<real, N>
+psow::basic_vec3x<real, N>::unit(void) const
+{
+    return *this / norm();
+}
+
+/*  Lanes of zero norm are set to zero, the rest are divided by it.           */
+template <class real, unsigned int N>
+inline psow::basic_vec3x<real, N>
+psow::basic_vec3x<real, N>::unit_or_zero(void) const
+{
+    const wide_type n = normsq();
+    const wide_type zero(real(0));
+    return psow::select(n > zero, *this * (real(1) / psow::sqrt(n)),
+                        basic_vec3x(zero, zero, zero));
+}
+
+/*  Component by component sums of the lanes.                                 */
+template <class real, unsigned int N>
+inline psow::basic_vec3<real>
+psow::basic_vec3x<real, N>::reduce_add(void) const
+{
+    return psow::basic_vec3<real>(psow::reduce_add(x), psow::reduce_add(y),
+                                  psow::reduce_add(z));
+}
+
+/*  std::sqrt of each lane, a single vector instruction once vectorized.      */
+template <class real, unsigned int N>
+inline psow::wide<real, N> psow::sqrt(const wide<real, N> &a)
+{
+    typedef wide_layout<real, N> layout;
+    wide<real, N> out;
+    unsigned int k;
+
+    for (k = 0U; k < layout::chunks; ++k)
+    {
+#if PSOW_WIDE_VECTORS
+        unsigned int j;
+
+        for (j = 0U; j < layout::width; ++j)
+            out.chunk[k][j] = std::sqrt(a.chunk[k][j]);
+#else
+        out.chunk[k] = std::sqrt(a.chunk[k]);
+#endif
+    }
+
+    return out;
+}
+
+/*  A compare and a select. Where either lane is NaN the result is b's lane.  */
+template <class real, unsigned int N>
+inline psow::wide<real, N>
+psow::min(const wide<real, N> &a, const wide<real, N> &b)
+{
+    return select(a < b, a, b);
+}
+
+template <class real, unsigned int N>
+inline psow::wide<real, N>
+psow::max(const wide<real, N> &a, const wide<real, N> &b)
+{
+    return select(a > b, a, b);
+}
+
+/*  Both sides are computed, this picks a lane from each. A ?: one lane at a  *
+ *  time would be a branch.                                                   */
+template <class real, unsigned int N>
+inline psow::wide<real, N>
+psow::select(const wide_mask<real, N> &mask, const wide<real, N> &a,
+             const wide<real, N> &b)
+{
+    typedef wide_chunk_ops<real, wide_layout<real, N>::bytes> ops;
+    wide<real, N> out;
+    unsigned int k;
+
+    for (k = 0U; k < wide_layout<real, N>::chunks; ++k)
+        out.chunk[k] = ops::select(mask.chunk[k], a.chunk[k], b.chunk[k]);
+
+    return out;
+}
+
+template <class real, unsigned int N>
+inline psow::basic_vec3x<real, N>
+psow::select(const wide_mask<real, N> &mask, const basic_vec3x<real, N> &a,
+             const basic_vec3x<real, N> &b)
+{
+    return basic_vec3x<real, N>(select(mask, a.x, b.x),
+                                select(mask, a.y, b.y),
+                                select(mask, a.z, b.z));
+}
+
+/*  The lanes are added in pairs, halving the count each step, which is the   *
+ *  order the shuffle-and-add sequence of a vectorized reduction uses.        */
+template <class real, unsigned int N>
+inline real psow::reduce_add(const wide<real, N> &a)
+{
+    real partial[N];
+    unsigned int i, half;
+
+    a.store(partial);
+
+    for (half = N / 2U; half > 0U; half /= 2U)
+        for (i = 0U; i < half; ++i)
+            partial[i] += partial[i + half];
+
+    return partial[0];
+}
+
+/*  Smallest lane.                                                            */
+template <class real, unsigned int N>
+inline real psow::reduce_min(const wide<real, N> &a)
+{
+    real lanes[N];
+    real out;
+    unsigned int i;
+
+    a.store(lanes);
+    out = lanes[0];
+
+    for (i = 1U; i < N; ++i)
+        out = (lanes[i] < out ? lanes[i] : out);
+
+    return out;
+}
+
+/*  Largest lane.                                                             */
+template <class real, unsigned int N>
+inline real psow::reduce_max(const wide<real, N> &a)
+{
+    real lanes[N];
+    real out;
+    unsigned int i;
+
+    a.store(lanes);
+    out = lanes[0];
+
+    for (i = 1U; i < N; ++i)
+        out = (lanes[i] > out ? lanes[i] : out);
+
+    return out;
+}
+
+#endif
+/*  End of include guard.                                                     */